@@ -18,30 +18,214 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
 #include "assert.h"
 #include "compress40.h"
+#include "Batch.h"
+
+/* the most worker threads -j accepts */
+#define MAX_THREADS 1024
 
 static void (*compress_or_decompress)(FILE *input) = compress40;
 
+/* round trip in memory for --measure; the report goes to stdout */
+static void measure(FILE *input)
+{
+        compress40_measure(input, stdout);
+}
+
+/* decodes records until the end of the input for -d --stream, flushing
+   each frame so the next program in the pipe sees it at once */
+static void decompress_stream(FILE *input)
+{
+        int c;
+        while ((c = getc(input)) != EOF) {
+                ungetc(c, input);
+                decompress40(input);
+                fflush(stdout);
+        }
+}
+
+/* returns the value that follows the option argv[*i] and steps *i past
+   it; exits with a message saying what the option needs if it is last */
+static const char *option_value(int argc, char *argv[], int *i,
+                                const char *needs)
+{
+        if (*i + 1 >= argc) {
+                fprintf(stderr, "%s: %s needs %s\n", argv[0], argv[*i],
+                        needs);
+                exit(1);
+        }
+        return argv[++*i];
+}
+
+/* parses a decimal number into *n; false unless the whole of arg is a
+   number that fits in a long */
+static bool parse_number(const char *arg, long *n)
+{
+        char *end;
+        errno = 0;
+        *n = strtol(arg, &end, 10);
+        return end != arg && *end == '\0' && errno == 0;
+}
+
 /* main that handles command line arguments. Calls either compression or
    decompression upon client's request */
 int main(int argc, char *argv[])
 {
         int i;
+        bool cropping = false;
+        bool thumbnail = false;
+        bool entropy = false;
+        bool fixed = false;
+        bool pipeline = false;
+        bool timing = false;
+        bool sequence = false;
+        bool streaming = false;
+        int levels = 1;
+        bool leveling = false;
+        int block = 2;
+        unsigned nthreads = 1;
+        const char *manifest = NULL;
 
         for (i = 1; i < argc; i++) {
                 if (strcmp(argv[i], "-c") == 0) {
                         compress_or_decompress = compress40;
                 } else if (strcmp(argv[i], "-d") == 0) {
                         compress_or_decompress = decompress40;
+                } else if (strcmp(argv[i], "--measure") == 0) {
+                        /* report RMSE, PSNR and ratio, writing no image */
+                        compress_or_decompress = measure;
+                } else if (strcmp(argv[i], "-j") == 0) {
+                        /* number of worker threads */
+                        long n;
+                        if (!parse_number(option_value(argc, argv, &i,
+                                                       "a number of threads"),
+                                          &n) ||
+                            n < 1 || n > MAX_THREADS) {
+                                fprintf(stderr, "%s: -j needs 1 to %d "
+                                        "threads\n", argv[0], MAX_THREADS);
+                                exit(1);
+                        }
+                        nthreads = n;
+                } else if (strcmp(argv[i], "--batch") == 0) {
+                        /* compress every image listed in a manifest */
+                        manifest = option_value(argc, argv, &i, "a manifest");
+                } else if (strcmp(argv[i], "--crop") == 0) {
+                        /* decode only a region: x,y,w,h in pixels */
+                        const char *region = option_value(argc, argv, &i,
+                                                          "x,y,w,h");
+                        int x, y, w, h;
+                        char extra;
+                        if (sscanf(region, "%d,%d,%d,%d%c", &x, &y, &w, &h,
+                                   &extra) != 4 || 
+                            x < 0 || y < 0 || w < 1 || h < 1) {
+                                fprintf(stderr, "%s: --crop needs x,y,w,h "
+                                        "with w and h positive\n", argv[0]);
+                                exit(1);
+                        }
+                        compress40_set_crop(x, y, w, h);
+                        cropping = true;
+                } else if (strcmp(argv[i], "--thumbnail") == 0) {
+                        /* half size preview from the block averages */
+                        compress40_set_thumbnail(true);
+                        thumbnail = true;
+                } else if (strcmp(argv[i], "--fixed") == 0) {
+                        /* all integer decoder */
+                        compress40_set_fixed(true);
+                        fixed = true;
+                } else if (strcmp(argv[i], "--pipeline") == 0) {
+                        /* overlap reading and writing with compressing */
+                        compress40_set_pipeline(true);
+                        pipeline = true;
+                } else if (strcmp(argv[i], "--entropy") == 0) {
+                        /* entropy code the codewords */
+                        compress40_set_entropy(true);
+                        entropy = true;
+                } else if (strcmp(argv[i], "--block") == 0) {
+                        /* larger transform blocks: 4 or 8 */
+                        long size;
+                        if (!parse_number(option_value(argc, argv, &i,
+                                                       "2, 4 or 8"), &size) ||
+                            (size != 2 && size != 4 && size != 8)) {
+                                fprintf(stderr, "%s: --block needs 2, 4 or "
+                                        "8\n", argv[0]);
+                                exit(1);
+                        }
+                        block = size;
+                        compress40_set_block(block);
+                } else if (strcmp(argv[i], "--sequence") == 0) {
+                        /* PPM frames one after another */
+                        compress40_set_sequence(true);
+                        sequence = true;
+                } else if (strcmp(argv[i], "--stream") == 0) {
+                        /* one record per frame until the end of input */
+                        streaming = true;
+                } else if (strcmp(argv[i], "--pyramid") == 0) {
+                        /* this many zoom levels in one file */
+                        long count;
+                        if (!parse_number(option_value(argc, argv, &i,
+                                                       "1 to 16 levels"),
+                                          &count) ||
+                            count < 1 || count > 16) {
+                                fprintf(stderr, "%s: --pyramid needs 1 to 16 "
+                                        "levels\n", argv[0]);
+                                exit(1);
+                        }
+                        levels = count;
+                        compress40_set_pyramid(levels);
+                } else if (strcmp(argv[i], "--level") == 0) {
+                        /* the zoom level of a pyramid to decode */
+                        long level;
+                        if (!parse_number(option_value(argc, argv, &i,
+                                                       "0 to 15"), &level) ||
+                            level < 0 || level > 15) {
+                                fprintf(stderr, "%s: --level needs 0 to 15"
+                                        "\n", argv[0]);
+                                exit(1);
+                        }
+                        compress40_set_level(level);
+                        leveling = true;
+                } else if (strcmp(argv[i], "--map") == 0) {
+                        /* map arrays of at least this many MB from a file */
+                        long mb;
+                        if (!parse_number(option_value(argc, argv, &i,
+                                                       "a number of MB"),
+                                          &mb) ||
+                            mb < 1 || (unsigned long)mb > SIZE_MAX >> 20) {
+                                fprintf(stderr, "%s: --map needs a positive "
+                                        "number of MB\n", argv[0]);
+                                exit(1);
+                        }
+                        compress40_set_map_threshold((size_t)mb << 20);
+                } else if (strcmp(argv[i], "-T") == 0) {
+                        /* per-stage timing, kept off stdout */
+                        timing = true;
                 } else if (*argv[i] == '-') {
                         fprintf(stderr, "%s: unknown option '%s'\n",
                                 argv[0], argv[i]);
                         exit(1);
-                } else if (argc - i > 2) {
-                        fprintf(stderr, "Usage: %s -d [filename]\n"
-                                "       %s -c [filename]\n",
-                                argv[0], argv[0]);
+                } else if (argc - i > 1) {
+                        fprintf(stderr, "Usage: %s -d [-j N] [-T] [--map MB] "
+                                "[--level K] [--fixed] "
+                                "[--crop x,y,w,h | --thumbnail] [filename]\n"
+                                "       %s -c [-j N] [-T] [--map MB] "
+                                "[--entropy] [--pipeline] [filename]\n"
+                                "       %s -c [-T] --block 4|8 "
+                                "[filename]\n"
+                                "       %s -c [-j N] [-T] --sequence "
+                                "[filename]\n"
+                                "       %s -c|-d [-j N] [-T] --stream "
+                                "[filename]\n"
+                                "       %s -c [-T] --pyramid N [filename]\n"
+                                "       %s --measure [-j N] [-T] "
+                                "[--entropy | --block 4|8] [filename]\n"
+                                "       %s -c [-j N] [--entropy] "
+                                "--batch manifest\n",
+                                argv[0], argv[0], argv[0], argv[0], argv[0],
+                                argv[0], argv[0], argv[0]);
                         exit(1);
                 } else {
                         break;
@@ -51,6 +235,102 @@ int main(int argc, char *argv[])
         /* ensure that there is at most one file on the command line */
         assert(argc - i <= 1);
 
+        if ((cropping || thumbnail || fixed) && 
+            compress_or_decompress != decompress40) {
+                fprintf(stderr, "%s: --crop, --thumbnail and --fixed only "
+                        "apply to -d\n", argv[0]);
+                exit(1);
+        }
+        if (fixed && thumbnail) {
+                fprintf(stderr, "%s: --fixed and --thumbnail cannot be "
+                        "combined\n", argv[0]);
+                exit(1);
+        }
+        if (fixed && nthreads > 1) {
+                fprintf(stderr, "%s: --fixed runs on one thread and cannot "
+                        "be combined with -j\n", argv[0]);
+                exit(1);
+        }
+        if ((entropy && compress_or_decompress == decompress40) ||
+            (pipeline && compress_or_decompress != compress40)) {
+                fprintf(stderr, "%s: --entropy only applies to -c and "
+                        "--measure, and --pipeline to -c\n", argv[0]);
+                exit(1);
+        }
+        if (block != 2 && (compress_or_decompress == decompress40 || 
+                           entropy || pipeline)) {
+                fprintf(stderr, "%s: --block only applies to -c and "
+                        "--measure, without --entropy or --pipeline\n",
+                        argv[0]);
+                exit(1);
+        }
+        if (sequence && (compress_or_decompress != compress40 || entropy ||
+                         pipeline || block != 2 || manifest != NULL)) {
+                fprintf(stderr, "%s: --sequence only applies to -c, without "
+                        "--entropy, --pipeline, --block or --batch\n",
+                        argv[0]);
+                exit(1);
+        }
+        if (levels != 1 && (compress_or_decompress != compress40 || 
+                            entropy || pipeline || block != 2 || sequence ||
+                            manifest != NULL)) {
+                fprintf(stderr, "%s: --pyramid only applies to -c, without "
+                        "--entropy, --pipeline, --block, --sequence or "
+                        "--batch\n", argv[0]);
+                exit(1);
+        }
+        if (streaming && (compress_or_decompress == measure || entropy ||
+                          pipeline || block != 2 || sequence ||
+                          levels != 1 || leveling || manifest != NULL)) {
+                fprintf(stderr, "%s: --stream only applies to -c and -d, "
+                        "without --entropy, --pipeline, --block, --sequence, "
+                        "--pyramid, --level or --batch\n", argv[0]);
+                exit(1);
+        }
+        if (leveling && compress_or_decompress != decompress40) {
+                fprintf(stderr, "%s: --level only applies to -d\n", 
+                        argv[0]);
+                exit(1);
+        }
+        if (manifest != NULL && 
+            (compress_or_decompress != compress40 || timing || i < argc)) {
+                fprintf(stderr, "%s: --batch only applies to -c, without -T "
+                        "or a filename\n", argv[0]);
+                exit(1);
+        }
+        if (cropping && thumbnail) {
+                fprintf(stderr, "%s: --crop and --thumbnail cannot be "
+                        "combined\n", argv[0]);
+                exit(1);
+        }
+        if (cropping && streaming) {
+                fprintf(stderr, "%s: --crop and --stream cannot be "
+                        "combined\n", argv[0]);
+                exit(1);
+        }
+
+        /* in batch mode the threads work on separate images, each on one
+           thread; otherwise they share the stages of the one image */
+        if (manifest != NULL) {
+                FILE *fp = fopen(manifest, "r");
+                assert(fp != NULL);
+                Batch_compress(fp, nthreads, stderr);
+                fclose(fp);
+                return EXIT_SUCCESS;
+        }
+        compress40_set_threads(nthreads);
+        if (timing) {
+                compress40_set_timing(stderr);
+        }
+
+        /* the statistics of a stream share stderr with the timings */
+        if (streaming && compress_or_decompress == compress40) {
+                compress40_set_stream(true, stderr);
+        } else if (streaming) {
+                compress40_set_stream(true, NULL);
+                compress_or_decompress = decompress_stream;
+        }
+
         /* open the file and call compress or decompress depending on
            what the user requested */
         if (i < argc) {
@@ -0,0 +1,183 @@
+/*****************************************************************************
+ *
+ *                                Band_queue.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Band_queue module. The
+ *     items live in a circular array guarded by one lock, with one
+ *     condition for "not full" and one for "not empty or closed".
+ *
+ *****************************************************************************/
+#include <assert.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "Band_queue.h"
+
+#define T Band_queue_T
+
+/*
+ * items:     circular array of capacity items
+ * first:     index of the item at the front
+ * count:     number of items in the queue
+ * closed:    whether the producer has closed the queue
+ * lock:      guards every other field
+ * not_full:  signalled when an item is removed
+ * not_empty: signalled when an item is added or the queue is closed
+ */
+struct T {
+        void **items;
+        int capacity;
+        int first;
+        int count;
+        bool closed;
+        pthread_mutex_t lock;
+        pthread_cond_t not_full;
+        pthread_cond_t not_empty;
+};
+
+/* FUNCTION:  Band_queue_new
+ * Purpose:   Allocates an empty queue
+ * Arg:       capacity: the most items the queue holds at once
+ * Returns:   A pointer to the new queue
+ * Effect:    Allocates memory for the queue
+ * Error:     Runtime error if capacity is not positive or if memory or a
+ *            lock cannot be allocated
+ */
+T Band_queue_new(int capacity)
+{
+        assert(capacity > 0);
+
+        T queue = malloc(sizeof(*queue));
+        assert(queue != NULL);
+        queue->items = malloc(capacity * sizeof(*queue->items));
+        assert(queue->items != NULL);
+        queue->capacity = capacity;
+        queue->first = 0;
+        queue->count = 0;
+        queue->closed = false;
+
+        int err = pthread_mutex_init(&queue->lock, NULL);
+        assert(err == 0);
+        err = pthread_cond_init(&queue->not_full, NULL);
+        assert(err == 0);
+        err = pthread_cond_init(&queue->not_empty, NULL);
+        assert(err == 0);
+
+        return queue;
+}
+
+/* FUNCTION:  Band_queue_push
+ * Purpose:   Adds an item to the back of a queue
+ * Arg:       queue: an initialized queue that has not been closed
+ *            item: a non-NULL pointer
+ * Returns:   N/A
+ * Effect:    Waits while the queue is full
+ * Error:     Runtime error if queue or item is NULL or the queue is closed
+ */
+void Band_queue_push(T queue, void *item)
+{
+        assert(queue != NULL && item != NULL);
+
+        pthread_mutex_lock(&queue->lock);
+        assert(!queue->closed);
+        while (queue->count == queue->capacity) {
+                pthread_cond_wait(&queue->not_full, &queue->lock);
+        }
+
+        int back = (queue->first + queue->count) % queue->capacity;
+        queue->items[back] = item;
+        queue->count++;
+
+        pthread_cond_signal(&queue->not_empty);
+        pthread_mutex_unlock(&queue->lock);
+}
+
+/* FUNCTION:  Band_queue_pop
+ * Purpose:   Removes the item at the front of a queue
+ * Arg:       queue: an initialized queue
+ * Returns:   The item, or NULL once the queue is closed and empty
+ * Effect:    Waits while the queue is empty and not closed
+ * Error:     Runtime error if queue is NULL
+ */
+void *Band_queue_pop(T queue)
+{
+        assert(queue != NULL);
+
+        pthread_mutex_lock(&queue->lock);
+        while (queue->count == 0 && !queue->closed) {
+                pthread_cond_wait(&queue->not_empty, &queue->lock);
+        }
+
+        void *item = NULL;
+        if (queue->count > 0) {
+                item = queue->items[queue->first];
+                queue->first = (queue->first + 1) % queue->capacity;
+                queue->count--;
+                pthread_cond_signal(&queue->not_full);
+        }
+
+        pthread_mutex_unlock(&queue->lock);
+
+        return item;
+}
+
+/* FUNCTION:  Band_queue_length
+ * Purpose:   Returns the number of items waiting in a queue
+ * Arg:       queue: an initialized queue
+ * Returns:   The number of items at the time of the call
+ * Effect:    N/A
+ * Error:     Runtime error if queue is NULL
+ */
+int Band_queue_length(T queue)
+{
+        assert(queue != NULL);
+
+        pthread_mutex_lock(&queue->lock);
+        int count = queue->count;
+        pthread_mutex_unlock(&queue->lock);
+
+        return count;
+}
+
+/* FUNCTION:  Band_queue_close
+ * Purpose:   Marks the end of the items of a queue
+ * Arg:       queue: an initialized queue
+ * Returns:   N/A
+ * Effect:    Wakes a consumer waiting on the empty queue
+ * Error:     Runtime error if queue is NULL
+ */
+void Band_queue_close(T queue)
+{
+        assert(queue != NULL);
+
+        pthread_mutex_lock(&queue->lock);
+        queue->closed = true;
+        pthread_cond_broadcast(&queue->not_empty);
+        pthread_mutex_unlock(&queue->lock);
+}
+
+/* FUNCTION:  Band_queue_free
+ * Purpose:   Deallocates a queue and clears *queue
+ * Arg:       queue: the address of an initialized queue that no thread is
+ *                   using
+ * Returns:   N/A
+ * Effect:    Items still in the queue are not freed
+ * Error:     Runtime error if queue or *queue is NULL
+ */
+void Band_queue_free(T *queue)
+{
+        assert(queue != NULL && *queue != NULL);
+
+        pthread_cond_destroy(&(*queue)->not_empty);
+        pthread_cond_destroy(&(*queue)->not_full);
+        pthread_mutex_destroy(&(*queue)->lock);
+        free((*queue)->items);
+        free(*queue);
+
+        *queue = NULL;
+}
@@ -0,0 +1,83 @@
+/*****************************************************************************
+ *
+ *                                Band_queue.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Band_queue module. A Band_queue_T
+ *     is a bounded first in, first out queue of pointers that connects two
+ *     threads: the producer blocks while the queue is full and the consumer
+ *     blocks while it is empty, so neither can run more than a few items
+ *     ahead of the other. The producer closes the queue after its last
+ *     item.
+ *
+ *****************************************************************************/
+#ifndef BANDQUEUE_INCLUDED
+#define BANDQUEUE_INCLUDED
+
+#define T Band_queue_T
+typedef struct T *T;
+
+/* FUNCTION:  Band_queue_new
+ * Purpose:   Allocates an empty queue
+ * Arg:       capacity: the most items the queue holds at once
+ * Returns:   A pointer to the new queue
+ * Effect:    Allocates memory for the queue
+ * Error:     Runtime error if capacity is not positive or if memory or a
+ *            lock cannot be allocated
+ */
+extern T Band_queue_new(int capacity);
+
+/* FUNCTION:  Band_queue_push
+ * Purpose:   Adds an item to the back of a queue
+ * Arg:       queue: an initialized queue that has not been closed
+ *            item: a non-NULL pointer
+ * Returns:   N/A
+ * Effect:    Waits while the queue is full
+ * Error:     Runtime error if queue or item is NULL or the queue is closed
+ */
+extern void Band_queue_push(T queue, void *item);
+
+/* FUNCTION:  Band_queue_pop
+ * Purpose:   Removes the item at the front of a queue
+ * Arg:       queue: an initialized queue
+ * Returns:   The item, or NULL once the queue is closed and empty
+ * Effect:    Waits while the queue is empty and not closed
+ * Error:     Runtime error if queue is NULL
+ */
+extern void *Band_queue_pop(T queue);
+
+/* FUNCTION:  Band_queue_length
+ * Purpose:   Returns the number of items waiting in a queue
+ * Arg:       queue: an initialized queue
+ * Returns:   The number of items; other threads may change it at once, so
+ *            it only suits statistics
+ * Effect:    N/A
+ * Error:     Runtime error if queue is NULL
+ */
+extern int Band_queue_length(T queue);
+
+/* FUNCTION:  Band_queue_close
+ * Purpose:   Marks the end of the items of a queue
+ * Arg:       queue: an initialized queue
+ * Returns:   N/A
+ * Effect:    Wakes a consumer waiting on the empty queue
+ * Error:     Runtime error if queue is NULL
+ */
+extern void Band_queue_close(T queue);
+
+/* FUNCTION:  Band_queue_free
+ * Purpose:   Deallocates a queue and clears *queue
+ * Arg:       queue: the address of an initialized queue that no thread is
+ *                   using
+ * Returns:   N/A
+ * Effect:    Items still in the queue are not freed
+ * Error:     Runtime error if queue or *queue is NULL
+ */
+extern void Band_queue_free(T *queue);
+
+#undef T
+#endif
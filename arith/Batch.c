@@ -0,0 +1,258 @@
+/*****************************************************************************
+ *
+ *                                  Batch.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Batch module. The whole
+ *     manifest is read up front into an array of jobs. The worker threads
+ *     take jobs off a shared counter, in the same way as Row_bands hands
+ *     out bands, and each worker installs its own Planar arena for as long
+ *     as it runs. Each image is compressed on a single thread, since there
+ *     are already as many images in flight as workers.
+ *
+ *****************************************************************************/
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "Batch.h"
+#include "Planar.h"
+#include "compress40.h"
+
+/*
+ * one image of the manifest
+ * input:  path of the PPM
+ * output: path of the compressed image
+ */
+struct Job {
+        char *input;
+        char *output;
+};
+
+/*
+ * The work shared by every worker
+ * jobs, njobs: the images of the manifest
+ * next_job:    the next image that has not been handed out
+ * bytes:       total size of the input files compressed so far
+ * lock:        guards next_job and bytes
+ */
+struct Batch_work {
+        struct Job *jobs;
+        size_t njobs;
+        size_t next_job;
+        size_t bytes;
+        pthread_mutex_t lock;
+};
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static void   read_manifest(FILE *manifest, struct Batch_work *work);
+static void  *batch_worker(void *cl);
+static long   take_job(struct Batch_work *work, size_t done_bytes);
+static size_t compress_job(const struct Job *job);
+
+/* FUNCTION:  Batch_compress
+ * Purpose:   Compresses every image listed in a manifest
+ * Arg:       manifest: pointer to the manifest
+ *            nworkers: the number of worker threads
+ *            report: the stream the totals are written to, or NULL
+ * Returns:   N/A
+ * Effect:    Writes each output file, then the header line and the totals
+ *            to report. With one worker, or one image, everything runs on
+ *            the calling thread
+ * Error:     Runtime error if a NULL pointer is passed in, if nworkers is
+ *            0, if a line of the manifest does not have exactly two paths,
+ *            if a file cannot be opened or a thread cannot be created
+ */
+void Batch_compress(FILE *manifest, unsigned nworkers, FILE *report)
+{
+        assert(manifest != NULL);
+        assert(nworkers > 0);
+
+        struct Batch_work work;
+        read_manifest(manifest, &work);
+        work.next_job = 0;
+        work.bytes = 0;
+        if (nworkers > work.njobs) {
+                nworkers = work.njobs > 0 ? work.njobs : 1;
+        }
+
+        int err = pthread_mutex_init(&work.lock, NULL);
+        assert(err == 0);
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        if (nworkers == 1) {
+                batch_worker(&work);
+        } else {
+                pthread_t *threads = malloc(nworkers * sizeof(*threads));
+                assert(threads != NULL);
+
+                unsigned i;
+                for (i = 0; i < nworkers; i++) {
+                        err = pthread_create(&threads[i], NULL, batch_worker,
+                                             &work);
+                        assert(err == 0);
+                }
+                for (i = 0; i < nworkers; i++) {
+                        err = pthread_join(threads[i], NULL);
+                        assert(err == 0);
+                }
+                free(threads);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double seconds = (end.tv_sec - start.tv_sec) +
+                         (end.tv_nsec - start.tv_nsec) / 1e9;
+        if (report != NULL) {
+                double rate = seconds > 0 ? work.njobs / seconds : 0;
+                double mb = seconds > 0 ? work.bytes / seconds / 1e6 : 0;
+                fprintf(report, "images\tseconds\timages/s\tMB/s\n");
+                fprintf(report, "%zu\t%.6f\t%.2f\t%.2f\n", work.njobs,
+                        seconds, rate, mb);
+        }
+
+        pthread_mutex_destroy(&work.lock);
+        size_t i;
+        for (i = 0; i < work.njobs; i++) {
+                free(work.jobs[i].input);
+                free(work.jobs[i].output);
+        }
+        free(work.jobs);
+}
+
+/* FUNCTION:  read_manifest
+ * Purpose:   Reads every job of a manifest
+ * Arg:       manifest: pointer to the manifest
+ *            work: receives the jobs in work->jobs and work->njobs
+ * Returns:   N/A
+ * Effect:    Allocates the jobs and copies of their paths
+ * Error:     Runtime error if a line that is neither blank nor a comment
+ *            does not have exactly two paths, or if memory cannot be
+ *            allocated
+ */
+static void read_manifest(FILE *manifest, struct Batch_work *work)
+{
+        size_t capacity = 16;
+        work->jobs = malloc(capacity * sizeof(*work->jobs));
+        assert(work->jobs != NULL);
+        work->njobs = 0;
+
+        char *line = NULL;
+        size_t line_size = 0;
+        while (getline(&line, &line_size, manifest) != -1) {
+                const char *space = " \t\r\n";
+                char *rest;
+                char *input = strtok_r(line, space, &rest);
+                if (input == NULL || *input == '#') {
+                        continue;
+                }
+                char *output = strtok_r(NULL, space, &rest);
+                char *extra = strtok_r(NULL, space, &rest);
+                assert(output != NULL && extra == NULL);
+
+                if (work->njobs == capacity) {
+                        capacity *= 2;
+                        work->jobs = realloc(work->jobs,
+                                             capacity * sizeof(*work->jobs));
+                        assert(work->jobs != NULL);
+                }
+                struct Job *job = &work->jobs[work->njobs++];
+                job->input = strdup(input);
+                job->output = strdup(output);
+                assert(job->input != NULL && job->output != NULL);
+        }
+
+        free(line);
+}
+
+/* FUNCTION:  batch_worker
+ * Purpose:   Body of each worker thread; compresses images until none are
+ *            left
+ * Arg:       cl: pointer to the shared Batch_work
+ * Returns:   NULL
+ * Effect:    Writes the output file of every image it takes; the planes of
+ *            the stages come from an arena that lives as long as the worker
+ * Error:     N/A
+ */
+static void *batch_worker(void *cl)
+{
+        struct Batch_work *work = cl;
+
+        Planar_arena_T arena = Planar_arena_new();
+        Planar_arena_use(arena);
+
+        size_t done_bytes = 0;
+        long job;
+        while ((job = take_job(work, done_bytes)) >= 0) {
+                done_bytes = compress_job(&work->jobs[job]);
+        }
+
+        Planar_arena_use(NULL);
+        Planar_arena_free(&arena);
+
+        return NULL;
+}
+
+/* FUNCTION:  take_job
+ * Purpose:   Hands out the next image that has not been started
+ * Arg:       work: pointer to the shared Batch_work
+ *            done_bytes: size of the input of the image the caller has just
+ *                        finished, or 0
+ * Returns:   The index of the job, or -1 if every job has been handed out
+ * Effect:    Advances work->next_job and adds done_bytes to work->bytes
+ * Error:     N/A
+ */
+static long take_job(struct Batch_work *work, size_t done_bytes)
+{
+        pthread_mutex_lock(&work->lock);
+
+        work->bytes += done_bytes;
+        long job = -1;
+        if (work->next_job < work->njobs) {
+                job = work->next_job++;
+        }
+
+        pthread_mutex_unlock(&work->lock);
+
+        return job;
+}
+
+/* FUNCTION:  compress_job
+ * Purpose:   Compresses one image of the manifest
+ * Arg:       job: the paths of the image
+ * Returns:   The size of the input file in bytes
+ * Effect:    Writes the output file
+ * Error:     Runtime error if either file cannot be opened, or if the
+ *            output cannot be written
+ */
+static size_t compress_job(const struct Job *job)
+{
+        FILE *input = fopen(job->input, "rb");
+        assert(input != NULL);
+        FILE *output = fopen(job->output, "wb");
+        assert(output != NULL);
+
+        struct stat st;
+        size_t bytes = 0;
+        if (fstat(fileno(input), &st) == 0) {
+                bytes = st.st_size;
+        }
+
+        compress40_file(input, output);
+
+        fclose(input);
+        int err = fclose(output);
+        assert(err == 0);
+
+        return bytes;
+}
@@ -0,0 +1,41 @@
+/*****************************************************************************
+ *
+ *                                  Batch.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Batch module. The purpose of this
+ *     module is to compress many images in one process (40image -c --batch
+ *     manifest). The manifest lists one image per line as an input PPM and
+ *     an output file separated by white space; blank lines and lines
+ *     starting with # are skipped. A pool of worker threads takes the
+ *     images in turn and compresses each one with compress40_file on its
+ *     own thread. Every worker has a Planar arena, so the planes of the
+ *     stages are allocated once, at the size of the largest image the
+ *     worker has seen, and then reused.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+
+#ifndef BATCH_INCLUDED
+#define BATCH_INCLUDED
+
+/* FUNCTION:  Batch_compress
+ * Purpose:   Compresses every image listed in a manifest
+ * Arg:       manifest: pointer to the manifest
+ *            nworkers: the number of worker threads
+ *            report: the stream the totals are written to, or NULL
+ * Returns:   N/A
+ * Effect:    Writes each output file, then two tab separated lines to
+ *            report: the header "images seconds images/s MB/s" and the
+ *            totals, where MB/s counts the bytes of the input files
+ * Error:     Runtime error if a NULL pointer is passed in, if nworkers is
+ *            0, if a line of the manifest does not have exactly two paths,
+ *            if a file cannot be opened or a thread cannot be created
+ */
+extern void Batch_compress(FILE *manifest, unsigned nworkers, FILE *report);
+
+#endif
@@ -0,0 +1,342 @@
+/*****************************************************************************
+ *
+ *                                Bit_stream.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Bit_stream module. Fields
+ *     are gathered in a 64 bit word, from its most significant bit down,
+ *     with Bitpack_inline_newu and Bitpack_inline_getu. A writer moves 32
+ *     bits at a time from the word to the buffer; a reader tops the word
+ *     up a byte at a time, so that any field of up to 32 bits can be taken
+ *     from it without touching the buffer.
+ *
+ *****************************************************************************/
+#include <assert.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "Bit_stream.h"
+#include "Bitpack_inline.h"
+
+#define T Bit_stream_T
+
+/* bits in the word that fields are gathered in */
+#define WORD_BITS 64
+
+/* widest field of Bit_stream_put and Bit_stream_get */
+#define MAX_FIELD 32
+
+/* initial size of the buffer of a writer */
+#define INITIAL_BYTES 4096
+
+/*
+ * bytes:    the buffer
+ * length:   bytes of the buffer in use (writer) or in all (reader)
+ * capacity: bytes allocated for the buffer of a writer
+ * word:     fields not yet moved to (writer) or taken from (reader) bytes,
+ *           starting at the most significant bit
+ * nbits:    number of bits held in word
+ * next:     index of the next byte a reader moves into word
+ * reading:  whether the stream came from Bit_stream_open
+ * finished: whether Bit_stream_bytes has been called on a writer
+ */
+struct T {
+        unsigned char *bytes;
+        size_t length;
+        size_t capacity;
+        uint64_t word;
+        unsigned nbits;
+        size_t next;
+        bool reading;
+        bool finished;
+};
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static void flush_word(T stream, unsigned nbits);
+static void fill_word(T stream);
+
+/* FUNCTION:  Bit_stream_new
+ * Purpose:   Allocates an empty stream to write to
+ * Arg:       N/A
+ * Returns:   A new Bit_stream_T
+ * Effect:    The buffer grows as fields are written
+ * Error:     Runtime error if memory cannot be allocated
+ */
+T Bit_stream_new(void)
+{
+        T stream = malloc(sizeof(*stream));
+        assert(stream != NULL);
+
+        stream->bytes = malloc(INITIAL_BYTES);
+        assert(stream->bytes != NULL);
+        stream->length = 0;
+        stream->capacity = INITIAL_BYTES;
+        stream->word = 0;
+        stream->nbits = 0;
+        stream->next = 0;
+        stream->reading = false;
+        stream->finished = false;
+
+        return stream;
+}
+
+/* FUNCTION:  Bit_stream_open
+ * Purpose:   Allocates a stream that reads the fields in a buffer
+ * Arg:       bytes: the buffer, which must outlive the stream
+ *            length: the number of bytes of the buffer
+ * Returns:   A new Bit_stream_T, positioned at the first bit
+ * Effect:    N/A
+ * Error:     Runtime error if bytes is NULL or memory cannot be allocated
+ */
+T Bit_stream_open(const unsigned char *bytes, size_t length)
+{
+        assert(bytes != NULL);
+
+        T stream = malloc(sizeof(*stream));
+        assert(stream != NULL);
+
+        /* a reader never writes through bytes */
+        stream->bytes = (unsigned char *)bytes;
+        stream->length = length;
+        stream->capacity = length;
+        stream->word = 0;
+        stream->nbits = 0;
+        stream->next = 0;
+        stream->reading = true;
+        stream->finished = false;
+
+        return stream;
+}
+
+/* FUNCTION:  Bit_stream_free
+ * Purpose:   Deallocates a stream
+ * Arg:       stream: the address of an initialized Bit_stream_T
+ * Returns:   N/A
+ * Effect:    Frees the buffer of a writer but not that of a reader; sets
+ *            *stream to NULL
+ * Error:     Runtime error if stream or *stream is NULL
+ */
+void Bit_stream_free(T *stream)
+{
+        assert(stream != NULL && *stream != NULL);
+
+        if (!(*stream)->reading) {
+                free((*stream)->bytes);
+        }
+        free(*stream);
+
+        *stream = NULL;
+}
+
+/* FUNCTION:  Bit_stream_put
+ * Purpose:   Writes a field of a fixed width
+ * Arg:       stream: a stream from Bit_stream_new
+ *            width: the width of the field, from 1 to 32
+ *            value: the field; bits above width are dropped
+ * Returns:   N/A
+ * Effect:    The word holds fewer than 32 bits between calls, so the field
+ *            always fits in it
+ * Error:     Runtime error if stream is NULL or was opened for reading, or
+ *            if width is out of range
+ */
+void Bit_stream_put(T stream, unsigned width, uint32_t value)
+{
+        assert(stream != NULL && !stream->reading && !stream->finished);
+        assert(width >= 1 && width <= MAX_FIELD);
+
+        stream->nbits += width;
+        stream->word = Bitpack_inline_newu(stream->word, width,
+                                           WORD_BITS - stream->nbits, value);
+        if (stream->nbits >= MAX_FIELD) {
+                flush_word(stream, MAX_FIELD);
+        }
+}
+
+/* FUNCTION:  Bit_stream_put_ue
+ * Purpose:   Writes an unsigned value as an Exp-Golomb code
+ * Arg:       stream: a stream from Bit_stream_new
+ *            value: the value
+ * Returns:   N/A
+ * Effect:    Writes k 0 bits, then value + 1 in k + 1 bits
+ * Error:     Runtime error if stream is NULL or was opened for reading, or
+ *            if the value does not fit in 31 bits
+ */
+void Bit_stream_put_ue(T stream, uint32_t value)
+{
+        assert(value < (UINT32_C(1) << 31));
+
+        uint32_t code = value + 1;
+        unsigned k = MAX_FIELD - 1 - __builtin_clz(code);
+        if (k > 0) {
+                Bit_stream_put(stream, k, 0);
+        }
+        Bit_stream_put(stream, k + 1, code);
+}
+
+/* FUNCTION:  Bit_stream_put_se
+ * Purpose:   Writes a signed value as an Exp-Golomb code
+ * Arg:       stream: a stream from Bit_stream_new
+ *            value: the value
+ * Returns:   N/A
+ * Effect:    0, 1, -1, 2, -2, ... are coded as 0, 1, 2, 3, 4, ...
+ * Error:     Runtime error if stream is NULL or was opened for reading, or
+ *            if the value does not fit in 30 bits
+ */
+void Bit_stream_put_se(T stream, int32_t value)
+{
+        assert(value < (INT32_C(1) << 30) && value > -(INT32_C(1) << 30));
+
+        if (value > 0) {
+                Bit_stream_put_ue(stream, 2 * (uint32_t)value - 1);
+        } else {
+                Bit_stream_put_ue(stream, 2 * (uint32_t)-value);
+        }
+}
+
+/* FUNCTION:  Bit_stream_bytes
+ * Purpose:   Gives the bytes written to a stream
+ * Arg:       stream: a stream from Bit_stream_new
+ *            length: receives the number of bytes
+ * Returns:   The buffer, which stays owned by the stream
+ * Effect:    Moves the last bits of the word to the buffer, padded with 0
+ *            bits to a whole byte
+ * Error:     Runtime error if a NULL pointer is passed in or if stream was
+ *            opened for reading
+ */
+const unsigned char *Bit_stream_bytes(T stream, size_t *length)
+{
+        assert(stream != NULL && length != NULL);
+        assert(!stream->reading);
+
+        if (!stream->finished) {
+                flush_word(stream, (stream->nbits + 7) / 8 * 8);
+                stream->finished = true;
+        }
+
+        *length = stream->length;
+        return stream->bytes;
+}
+
+/* FUNCTION:  Bit_stream_get
+ * Purpose:   Reads a field of a fixed width
+ * Arg:       stream: a stream from Bit_stream_open
+ *            width: the width of the field, from 1 to 32
+ * Returns:   The field
+ * Effect:    Moves past the field
+ * Error:     Runtime error if stream is NULL or was not opened for
+ *            reading, if width is out of range or if the field runs past
+ *            the end of the buffer
+ */
+uint32_t Bit_stream_get(T stream, unsigned width)
+{
+        assert(stream != NULL && stream->reading);
+        assert(width >= 1 && width <= MAX_FIELD);
+
+        if (stream->nbits < width) {
+                fill_word(stream);
+                assert(stream->nbits >= width);
+        }
+
+        uint32_t value = Bitpack_inline_getu(stream->word, width,
+                                             WORD_BITS - width);
+        stream->word <<= width;
+        stream->nbits -= width;
+
+        return value;
+}
+
+/* FUNCTION:  Bit_stream_get_ue
+ * Purpose:   Reads a value written by Bit_stream_put_ue
+ * Arg:       stream: a stream from Bit_stream_open
+ * Returns:   The value
+ * Effect:    Counts the leading 0 bits of the word in one step
+ * Error:     Runtime error if stream is NULL or was not opened for
+ *            reading, or if the code is not valid or runs past the end of
+ *            the buffer
+ */
+uint32_t Bit_stream_get_ue(T stream)
+{
+        assert(stream != NULL && stream->reading);
+
+        if (stream->nbits < MAX_FIELD) {
+                fill_word(stream);
+        }
+
+        /* the bits below nbits are 0, so a code that runs past the end of
+           the buffer shows up as more than 31 leading 0 bits */
+        unsigned k = stream->word == 0 ? WORD_BITS :
+                     (unsigned)__builtin_clzll(stream->word);
+        assert(k < MAX_FIELD && k < stream->nbits);
+        stream->word <<= k;
+        stream->nbits -= k;
+
+        return Bit_stream_get(stream, k + 1) - 1;
+}
+
+/* FUNCTION:  Bit_stream_get_se
+ * Purpose:   Reads a value written by Bit_stream_put_se
+ * Arg:       stream: a stream from Bit_stream_open
+ * Returns:   The value
+ * Effect:    Moves past the code
+ * Error:     Same as Bit_stream_get_ue
+ */
+int32_t Bit_stream_get_se(T stream)
+{
+        uint32_t code = Bit_stream_get_ue(stream);
+
+        if (code % 2 == 1) {
+                return (int32_t)((code + 1) / 2);
+        }
+        return -(int32_t)(code / 2);
+}
+
+/* FUNCTION:  flush_word
+ * Purpose:   Moves the top bits of the word of a writer to its buffer
+ * Arg:       stream: a stream from Bit_stream_new
+ *            nbits: a multiple of 8 no larger than 32
+ * Returns:   N/A
+ * Effect:    Doubles the buffer when it is full
+ * Error:     Runtime error if memory cannot be allocated
+ */
+static void flush_word(T stream, unsigned nbits)
+{
+        if (stream->length + MAX_FIELD / 8 > stream->capacity) {
+                stream->capacity *= 2;
+                stream->bytes = realloc(stream->bytes, stream->capacity);
+                assert(stream->bytes != NULL);
+        }
+
+        unsigned i;
+        for (i = 0; i < nbits / 8; i++) {
+                stream->bytes[stream->length++] =
+                        Bitpack_inline_getu(stream->word, 8,
+                                            WORD_BITS - 8 * (i + 1));
+        }
+        stream->word <<= nbits;
+        stream->nbits = nbits > stream->nbits ? 0 : stream->nbits - nbits;
+}
+
+/* FUNCTION:  fill_word
+ * Purpose:   Tops up the word of a reader from its buffer
+ * Arg:       stream: a stream from Bit_stream_open
+ * Returns:   N/A
+ * Effect:    Moves whole bytes into the word while they fit; at the end of
+ *            the buffer the word is left short
+ * Error:     N/A
+ */
+static void fill_word(T stream)
+{
+        while (stream->nbits <= WORD_BITS - 8 &&
+               stream->next < stream->length) {
+                stream->word = Bitpack_inline_newu(
+                        stream->word, 8, WORD_BITS - 8 - stream->nbits,
+                        stream->bytes[stream->next++]);
+                stream->nbits += 8;
+        }
+}
@@ -0,0 +1,118 @@
+/*****************************************************************************
+ *
+ *                                Bit_stream.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Bit_stream module. The purpose of
+ *     this module is to pack fields of any width, one after another, into
+ *     a buffer of bytes and to read them back, for formats whose fields do
+ *     not all have the same size. Fields are stored most significant bit
+ *     first. Besides fixed width fields it writes and reads Exp-Golomb
+ *     codes, whose length grows with the magnitude of the value, so that
+ *     small values take few bits.
+ *
+ *****************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef BITSTREAM_INCLUDED
+#define BITSTREAM_INCLUDED
+
+#define T Bit_stream_T
+typedef struct T *T;
+
+/* FUNCTION:  Bit_stream_new
+ * Purpose:   Allocates an empty stream to write to
+ * Arg:       N/A
+ * Returns:   A new Bit_stream_T
+ * Effect:    The buffer grows as fields are written
+ * Error:     Runtime error if memory cannot be allocated
+ */
+extern T Bit_stream_new(void);
+
+/* FUNCTION:  Bit_stream_open
+ * Purpose:   Allocates a stream that reads the fields in a buffer
+ * Arg:       bytes: the buffer, which must outlive the stream
+ *            length: the number of bytes of the buffer
+ * Returns:   A new Bit_stream_T, positioned at the first bit
+ * Effect:    N/A
+ * Error:     Runtime error if bytes is NULL or memory cannot be allocated
+ */
+extern T Bit_stream_open(const unsigned char *bytes, size_t length);
+
+/* FUNCTION:  Bit_stream_free
+ * Purpose:   Deallocates a stream
+ * Arg:       stream: the address of an initialized Bit_stream_T
+ * Returns:   N/A
+ * Effect:    Frees the buffer of a stream from Bit_stream_new, but not the
+ *            buffer given to Bit_stream_open; sets *stream to NULL
+ * Error:     Runtime error if stream or *stream is NULL
+ */
+extern void Bit_stream_free(T *stream);
+
+/* FUNCTION:  Bit_stream_put
+ * Purpose:   Writes a field of a fixed width
+ * Arg:       stream: a stream from Bit_stream_new
+ *            width: the width of the field, from 1 to 32
+ *            value: the field; bits above width are dropped
+ * Returns:   N/A
+ * Effect:    Grows the buffer when needed
+ * Error:     Runtime error if stream is NULL or was opened for reading, or
+ *            if width is out of range
+ */
+extern void Bit_stream_put(T stream, unsigned width, uint32_t value);
+
+/* FUNCTION:  Bit_stream_put_ue, Bit_stream_put_se
+ * Purpose:   Write an unsigned or signed value as an Exp-Golomb code
+ * Arg:       stream: a stream from Bit_stream_new
+ *            value: the value; a signed value v is coded as the unsigned
+ *                   value 2v - 1 when it is positive and -2v otherwise
+ * Returns:   N/A
+ * Effect:    Takes 2k + 1 bits, where 2^k <= value + 1 < 2^(k + 1)
+ * Error:     Runtime error if stream is NULL or was opened for reading, or
+ *            if the value does not fit in 31 bits
+ */
+extern void Bit_stream_put_ue(T stream, uint32_t value);
+extern void Bit_stream_put_se(T stream, int32_t value);
+
+/* FUNCTION:  Bit_stream_bytes
+ * Purpose:   Gives the bytes written to a stream
+ * Arg:       stream: a stream from Bit_stream_new
+ *            length: receives the number of bytes
+ * Returns:   The buffer, which stays owned by the stream
+ * Effect:    Pads the last byte with 0 bits; nothing can be written after
+ * Error:     Runtime error if a NULL pointer is passed in or if stream was
+ *            opened for reading
+ */
+extern const unsigned char *Bit_stream_bytes(T stream, size_t *length);
+
+/* FUNCTION:  Bit_stream_get
+ * Purpose:   Reads a field of a fixed width
+ * Arg:       stream: a stream from Bit_stream_open
+ *            width: the width of the field, from 1 to 32
+ * Returns:   The field
+ * Effect:    Moves past the field
+ * Error:     Runtime error if stream is NULL or was not opened for
+ *            reading, if width is out of range or if the field runs past
+ *            the end of the buffer
+ */
+extern uint32_t Bit_stream_get(T stream, unsigned width);
+
+/* FUNCTION:  Bit_stream_get_ue, Bit_stream_get_se
+ * Purpose:   Read a value written by Bit_stream_put_ue or Bit_stream_put_se
+ * Arg:       stream: a stream from Bit_stream_open
+ * Returns:   The value
+ * Effect:    Moves past the code
+ * Error:     Runtime error if stream is NULL or was not opened for
+ *            reading, or if the code is not valid or runs past the end of
+ *            the buffer
+ */
+extern uint32_t Bit_stream_get_ue(T stream);
+extern int32_t  Bit_stream_get_se(T stream);
+
+#undef T
+#endif
@@ -0,0 +1,187 @@
+/*****************************************************************************
+ *
+ *                              Bitpack_inline.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the header only fast path of our bitpack module. The layout of
+ *     a codeword is generated from the widths in DCT_ints.h, so every field
+ *     has a constant width and lsb and each get or new folds down to a shift
+ *     and a mask. Unlike Bitpack_getu, Bitpack_newu and Bitpack_news there
+ *     are no range checks and Bitpack_Overflow is never raised: values are
+ *     masked to the width of their field. The caller is responsible for
+ *     only passing values that fit, which DCTfloats_DCTints guarantees by
+ *     clamping. The batch functions pack or unpack a whole row of DCT_ints
+ *     with no calls in the loop, which lets the compiler vectorize it.
+ *
+ *     Layout of a codeword, from the least significant bit:
+ *         avgPr, avgPb (AVG_PBPR_WIDTH bits each), d, c, b (BCD_WIDTH bits
+ *         each), a (A_WIDTH bits)
+ *
+ *****************************************************************************/
+#ifndef BITPACKINLINE_INCLUDED
+#define BITPACKINLINE_INCLUDED
+
+#include <stdint.h>
+#include "DCT_ints.h"
+
+/* lsb of each field of a codeword */
+#define AVGPR_LSB 0
+#define AVGPB_LSB (AVGPR_LSB + AVG_PBPR_WIDTH)
+#define D_LSB     (AVGPB_LSB + AVG_PBPR_WIDTH)
+#define C_LSB     (D_LSB + BCD_WIDTH)
+#define B_LSB     (C_LSB + BCD_WIDTH)
+#define A_LSB     (B_LSB + BCD_WIDTH)
+
+/* number of bits in a codeword */
+#define CODEWORD_WIDTH (A_LSB + A_WIDTH)
+
+/* a word with the low width bits set */
+#define BITPACK_INLINE_MASK(width) ((((uint64_t)1) << (width)) - 1)
+
+/* FUNCTION:  Bitpack_inline_getu
+ * Purpose:   Extracts an unsigned field from a word
+ * Arg:       word: the codeword
+ *            width: the width of the field; 0 < width < 64
+ *            lsb: the lsb of the field; width + lsb <= 64
+ * Returns:   The field
+ * Effect:    N/A
+ * Error:     Not checked; the arguments are expected to be constants
+ */
+static inline uint64_t Bitpack_inline_getu(uint64_t word, unsigned width,
+                                           unsigned lsb)
+{
+        return (word >> lsb) & BITPACK_INLINE_MASK(width);
+}
+
+/* FUNCTION:  Bitpack_inline_gets
+ * Purpose:   Extracts a signed (two's complement) field from a word
+ * Arg:       word: the codeword
+ *            width: the width of the field; 0 < width < 64
+ *            lsb: the lsb of the field; width + lsb <= 64
+ * Returns:   The field, sign extended
+ * Effect:    N/A
+ * Error:     Not checked; the arguments are expected to be constants
+ */
+static inline int64_t Bitpack_inline_gets(uint64_t word, unsigned width,
+                                          unsigned lsb)
+{
+        /* flip the sign bit and subtract it back to sign extend */
+        uint64_t field = Bitpack_inline_getu(word, width, lsb);
+        uint64_t sign = ((uint64_t)1) << (width - 1);
+
+        return (int64_t)(field ^ sign) - (int64_t)sign;
+}
+
+/* FUNCTION:  Bitpack_inline_newu
+ * Purpose:   Returns a new word with a field replaced by a value
+ * Arg:       word: the codeword
+ *            width: the width of the field; 0 < width < 64
+ *            lsb: the lsb of the field; width + lsb <= 64
+ *            value: the value to store; signed values are stored in two's
+ *                   complement
+ * Returns:   The codeword with the new value
+ * Effect:    Bits of value above width are dropped
+ * Error:     Not checked; the arguments are expected to be constants
+ */
+static inline uint64_t Bitpack_inline_newu(uint64_t word, unsigned width,
+                                           unsigned lsb, uint64_t value)
+{
+        uint64_t mask = BITPACK_INLINE_MASK(width);
+
+        return (word & ~(mask << lsb)) | ((value & mask) << lsb);
+}
+
+/* FUNCTION:  Bitpack_inline_pack
+ * Purpose:   Converts a DCT_ints struct into a codeword
+ * Arg:       dct_ints: the DCT scaled int values of a block; every value
+ *                      must fit its field
+ * Returns:   The codeword
+ * Effect:    N/A
+ * Error:     Not checked
+ */
+static inline uint64_t Bitpack_inline_pack(struct DCT_ints dct_ints)
+{
+        uint64_t codeword = 0;
+
+        codeword = Bitpack_inline_newu(codeword, AVG_PBPR_WIDTH, AVGPR_LSB,
+                                       dct_ints.avgPr);
+        codeword = Bitpack_inline_newu(codeword, AVG_PBPR_WIDTH, AVGPB_LSB,
+                                       dct_ints.avgPb);
+        codeword = Bitpack_inline_newu(codeword, BCD_WIDTH, D_LSB,
+                                       (uint64_t)(int64_t)dct_ints.d);
+        codeword = Bitpack_inline_newu(codeword, BCD_WIDTH, C_LSB,
+                                       (uint64_t)(int64_t)dct_ints.c);
+        codeword = Bitpack_inline_newu(codeword, BCD_WIDTH, B_LSB,
+                                       (uint64_t)(int64_t)dct_ints.b);
+        codeword = Bitpack_inline_newu(codeword, A_WIDTH, A_LSB, dct_ints.a);
+
+        return codeword;
+}
+
+/* FUNCTION:  Bitpack_inline_unpack
+ * Purpose:   Converts a codeword into a DCT_ints struct
+ * Arg:       codeword: the codeword of a block
+ * Returns:   The DCT scaled int values of the block
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static inline struct DCT_ints Bitpack_inline_unpack(uint64_t codeword)
+{
+        struct DCT_ints dct_ints;
+
+        dct_ints.avgPr = Bitpack_inline_getu(codeword, AVG_PBPR_WIDTH,
+                                             AVGPR_LSB);
+        dct_ints.avgPb = Bitpack_inline_getu(codeword, AVG_PBPR_WIDTH,
+                                             AVGPB_LSB);
+        dct_ints.d = Bitpack_inline_gets(codeword, BCD_WIDTH, D_LSB);
+        dct_ints.c = Bitpack_inline_gets(codeword, BCD_WIDTH, C_LSB);
+        dct_ints.b = Bitpack_inline_gets(codeword, BCD_WIDTH, B_LSB);
+        dct_ints.a = Bitpack_inline_getu(codeword, A_WIDTH, A_LSB);
+
+        return dct_ints;
+}
+
+/* FUNCTION:  Bitpack_inline_pack_row
+ * Purpose:   Converts a row of DCT_ints structs into codewords
+ * Arg:       dct_ints: n structs; every value must fit its field
+ *            codewords: receives n codewords; must not overlap dct_ints
+ *            n: the number of blocks in the row
+ * Returns:   N/A
+ * Effect:    Writes codewords[0] to codewords[n - 1]
+ * Error:     Not checked
+ */
+static inline void Bitpack_inline_pack_row(
+        const struct DCT_ints *restrict dct_ints,
+        uint64_t *restrict codewords, int n)
+{
+        int i;
+        for (i = 0; i < n; i++) {
+                codewords[i] = Bitpack_inline_pack(dct_ints[i]);
+        }
+}
+
+/* FUNCTION:  Bitpack_inline_unpack_row
+ * Purpose:   Converts a row of codewords into DCT_ints structs
+ * Arg:       codewords: n codewords
+ *            dct_ints: receives n structs; must not overlap codewords
+ *            n: the number of blocks in the row
+ * Returns:   N/A
+ * Effect:    Writes dct_ints[0] to dct_ints[n - 1]
+ * Error:     N/A
+ */
+static inline void Bitpack_inline_unpack_row(
+        const uint64_t *restrict codewords,
+        struct DCT_ints *restrict dct_ints, int n)
+{
+        int i;
+        for (i = 0; i < n; i++) {
+                dct_ints[i] = Bitpack_inline_unpack(codewords[i]);
+        }
+}
+
+#undef BITPACK_INLINE_MASK
+#endif
@@ -0,0 +1,578 @@
+/*****************************************************************************
+ *
+ *                                Block_DCT.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Block_DCT module. Samples
+ *     are scaled to 8 bit integers (luma centered on 0) and each N by N
+ *     block is transformed with the integer basis of HEVC, whose rows are
+ *     within 0.1% of an orthonormal DCT scaled by 64 * sqrt(N). Rows and
+ *     then columns go through a partial butterfly, which splits each 1-D
+ *     transform into an even half and an odd half and so needs about half
+ *     the multiplies of a matrix product. The coefficients are divided by
+ *     64 * 64 * N and by the step of their quantization table in a single
+ *     multiply; the tables are those of JPEG at quality 75, sampled every
+ *     other entry for 4 by 4 blocks. The inverse transform is all integer,
+ *     with a rounding shift after each pass.
+ *
+ *     After the header, the format holds one byte with the block width,
+ *     the length of the coded blocks as 4 bytes, most significant first,
+ *     and the coded blocks of the y plane, then of the pb plane and then
+ *     of the pr plane, each in raster order. A block is coded as its DC
+ *     coefficient minus that of the block before it in the plane, the
+ *     number of its nonzero AC coefficients, and, for each of them in
+ *     zigzag order, the zeros skipped before it and its value, all as
+ *     Exp-Golomb codes. Blocks that cross the right or bottom edge of a
+ *     plane repeat its last column or row.
+ *
+ *****************************************************************************/
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "Block_DCT.h"
+#include "Bit_stream.h"
+#include "SIMD_kernels.h"
+
+/* largest block width, and coefficients in the largest block */
+#define MAX_BLOCK 8
+#define MAX_COEFFS (MAX_BLOCK * MAX_BLOCK)
+
+/* samples are scaled to this many levels; luma is centered on 0 */
+#define SAMPLE_SCALE 255.0f
+#define LUMA_OFFSET 128
+
+/* JPEG quality the quantization tables are scaled to, as a percentage of
+   the quality 50 tables */
+#define TABLE_PERCENT 50
+
+/* shift of the inverse transform after the first pass; the second pass
+   shifts by the rest of 12 + log2(N) */
+#define INVERSE_SHIFT 6
+
+/* quality 50 tables of the JPEG standard (Annex K), in raster order */
+static const int luma_table[MAX_COEFFS] = {
+        16, 11, 10, 16,  24,  40,  51,  61,
+        12, 12, 14, 19,  26,  58,  60,  55,
+        14, 13, 16, 24,  40,  57,  69,  56,
+        14, 17, 22, 29,  51,  87,  80,  62,
+        18, 22, 37, 56,  68, 109, 103,  77,
+        24, 35, 55, 64,  81, 104, 113,  92,
+        49, 64, 78, 87, 103, 121, 120, 101,
+        72, 92, 95, 98, 112, 100, 103,  99
+};
+static const int chroma_table[MAX_COEFFS] = {
+        17, 18, 24, 47, 99, 99, 99, 99,
+        18, 21, 26, 66, 99, 99, 99, 99,
+        24, 26, 56, 99, 99, 99, 99, 99,
+        47, 66, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99,
+        99, 99, 99, 99, 99, 99, 99, 99
+};
+
+/*
+ * the tables of one plane at one block width
+ * n, log2n:  the block width and its log
+ * subsample: 1 for the y plane, 2 for the chroma planes
+ * offset:    subtracted from the scaled samples before the transform
+ * step:      the quantization step of each coefficient, in raster order
+ * scale:     1 / (step * 64 * 64 * n), for the encoder
+ * zigzag:    the raster index of each coefficient, in zigzag order
+ */
+struct Plane_code {
+        int n, log2n;
+        int subsample;
+        int offset;
+        int step[MAX_COEFFS];
+        float scale[MAX_COEFFS];
+        int zigzag[MAX_COEFFS];
+};
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static void    plane_code(struct Plane_code *code, int n, int plane);
+static void    encode_plane(Bit_stream_T stream, Planar_T cv_colors,
+                            int plane, const struct Plane_code *code);
+static void    decode_plane(Bit_stream_T stream, Planar_T cv_colors,
+                            int plane, const struct Plane_code *code);
+static void    load_block(Planar_T cv_colors, int plane,
+                          const struct Plane_code *code, int bx, int by,
+                          int32_t *block);
+static void    store_block(Planar_T cv_colors, int plane,
+                           const struct Plane_code *code, int bx, int by,
+                           const int32_t *block);
+static void    forward_1d(const int32_t *x, int32_t *y, int ystride, int n);
+static void    inverse_1d(const int32_t *y, int ystride, int32_t *x, int n,
+                          int shift);
+static void    put_u32(uint32_t value, unsigned char *bytes);
+static uint32_t get_u32(const unsigned char *bytes);
+
+/* FUNCTION:  Block_DCT_write
+ * Purpose:   Compresses an image of CV colors to the block format
+ * Arg:       cv_colors: a planar image with y, pb and pr planes and even
+ *                       dimensions
+ *            block: the width of the luma blocks, 4 or 8
+ *            file: pointer to a file open for writing
+ * Returns:   N/A
+ * Effect:    Codes the three planes into one Bit_stream, then writes the
+ *            header, the block width, the length and the stream; recycles
+ *            cv_colors
+ * Error:     Runtime error if a NULL pointer is passed in, if block is not
+ *            4 or 8 or if the write fails
+ */
+void Block_DCT_write(Planar_T cv_colors, int block, FILE *file)
+{
+        assert(cv_colors != NULL && file != NULL);
+        assert(block == 4 || block == 8);
+
+        int width = Planar_width(cv_colors);
+        int height = Planar_height(cv_colors);
+        assert(width % 2 == 0 && height % 2 == 0);
+
+        Bit_stream_T stream = Bit_stream_new();
+        int plane;
+        for (plane = SIMD_Y; plane <= SIMD_PR; plane++) {
+                struct Plane_code code;
+                plane_code(&code, block, plane);
+                encode_plane(stream, cv_colors, plane, &code);
+        }
+        size_t length;
+        const unsigned char *bytes = Bit_stream_bytes(stream, &length);
+        assert(length <= UINT32_MAX);
+
+        fprintf(file, "COMP40 Compressed image format %d\n%u %u\n",
+                BLOCK_DCT_FORMAT, width, height);
+        unsigned char fields[5];
+        fields[0] = block;
+        put_u32(length, fields + 1);
+        size_t written = fwrite(fields, 1, 5, file);
+        written += fwrite(bytes, 1, length, file);
+        assert(written == length + 5);
+
+        Bit_stream_free(&stream);
+        Planar_free(&cv_colors);
+}
+
+/* FUNCTION:  Block_DCT_read
+ * Purpose:   Decompresses an image in the block format
+ * Arg:       file: pointer to a file, just after the header read by
+ *                  Codewords_File_read_header
+ *            width, height: the dimensions of the image from the header
+ * Returns:   A planar image with y, pb and pr planes
+ * Effect:    Reads the block width and the whole stream before decoding
+ * Error:     Runtime error if a NULL pointer is passed in or if the file is
+ *            not a complete image in the block format
+ */
+Planar_T Block_DCT_read(FILE *file, unsigned width, unsigned height)
+{
+        assert(file != NULL);
+        assert(width % 2 == 0 && height % 2 == 0);
+
+        unsigned char fields[5];
+        size_t got = fread(fields, 1, 5, file);
+        assert(got == 5);
+        int block = fields[0];
+        assert(block == 4 || block == 8);
+        uint32_t length = get_u32(fields + 1);
+
+        unsigned char *bytes = malloc((size_t)length + 1);
+        assert(bytes != NULL);
+        got = fread(bytes, 1, length, file);
+        assert(got == length);
+
+        Planar_T cv_colors = Planar_new(width, height, 3);
+        Bit_stream_T stream = Bit_stream_open(bytes, length);
+        int plane;
+        for (plane = SIMD_Y; plane <= SIMD_PR; plane++) {
+                struct Plane_code code;
+                plane_code(&code, block, plane);
+                decode_plane(stream, cv_colors, plane, &code);
+        }
+
+        Bit_stream_free(&stream);
+        free(bytes);
+
+        return cv_colors;
+}
+
+/* FUNCTION:  plane_code
+ * Purpose:   Builds the tables of a plane for a block width
+ * Arg:       code: receives the tables
+ *            n: the block width, 4 or 8
+ *            plane: SIMD_Y, SIMD_PB or SIMD_PR
+ * Returns:   N/A
+ * Effect:    A 4 by 4 block takes every other step of the 8 by 8 table,
+ *            halved, since its coefficients are half as large
+ * Error:     N/A
+ */
+static void plane_code(struct Plane_code *code, int n, int plane)
+{
+        const int *table = plane == SIMD_Y ? luma_table : chroma_table;
+        int stride = MAX_BLOCK / n;
+
+        code->n = n;
+        code->log2n = n == 8 ? 3 : 2;
+        code->subsample = plane == SIMD_Y ? 1 : 2;
+        code->offset = plane == SIMD_Y ? LUMA_OFFSET : 0;
+
+        int row, col;
+        for (row = 0; row < n; row++) {
+                for (col = 0; col < n; col++) {
+                        int base = table[row * stride * MAX_BLOCK +
+                                         col * stride];
+                        int step = (base * TABLE_PERCENT + 50) / 100 /
+                                   stride;
+                        if (step < 1) {
+                                step = 1;
+                        }
+                        code->step[row * n + col] = step;
+                        code->scale[row * n + col] =
+                                1.0f / ((float)step * (64 * 64 * n));
+                }
+        }
+
+        /* walk the anti-diagonals, alternating direction */
+        int i = 0, d;
+        for (d = 0; d < 2 * n - 1; d++) {
+                int k;
+                for (k = 0; k <= d; k++) {
+                        int r = d % 2 == 0 ? d - k : k;
+                        int c = d - r;
+                        if (r < n && c < n) {
+                                code->zigzag[i++] = r * n + c;
+                        }
+                }
+        }
+}
+
+/* FUNCTION:  encode_plane
+ * Purpose:   Codes every block of a plane
+ * Arg:       stream: the stream to write to
+ *            cv_colors: the image
+ *            plane: the plane to code
+ *            code: the tables of the plane
+ * Returns:   N/A
+ * Effect:    Transforms and quantizes each block, then writes it
+ * Error:     N/A
+ */
+static void encode_plane(Bit_stream_T stream, Planar_T cv_colors,
+                         int plane, const struct Plane_code *code)
+{
+        int n = code->n;
+        int width = Planar_width(cv_colors) / code->subsample;
+        int height = Planar_height(cv_colors) / code->subsample;
+
+        int32_t samples[MAX_COEFFS], rows[MAX_COEFFS], coeffs[MAX_COEFFS];
+        int32_t previous_dc = 0;
+        int bx, by, i;
+        for (by = 0; by < height; by += n) {
+                for (bx = 0; bx < width; bx += n) {
+                        load_block(cv_colors, plane, code, bx, by, samples);
+
+                        /* rows into the columns of rows, then columns */
+                        for (i = 0; i < n; i++) {
+                                forward_1d(samples + i * n, rows + i, n, n);
+                        }
+                        for (i = 0; i < n; i++) {
+                                forward_1d(rows + i * n, coeffs + i, n, n);
+                        }
+
+                        /* the DC level is its own, so that only the AC
+                           levels are counted */
+                        int32_t levels[MAX_COEFFS];
+                        levels[0] = lrintf((float)coeffs[0] * code->scale[0]);
+                        int nonzero = 0;
+                        for (i = 1; i < n * n; i++) {
+                                int k = code->zigzag[i];
+                                levels[i] = lrintf((float)coeffs[k] *
+                                                   code->scale[k]);
+                                nonzero += levels[i] != 0;
+                        }
+
+                        Bit_stream_put_se(stream, levels[0] - previous_dc);
+                        previous_dc = levels[0];
+                        Bit_stream_put_ue(stream, nonzero);
+                        int run = 0;
+                        for (i = 1; nonzero > 0; i++) {
+                                if (levels[i] == 0) {
+                                        run++;
+                                        continue;
+                                }
+                                Bit_stream_put_ue(stream, run);
+                                Bit_stream_put_se(stream, levels[i]);
+                                run = 0;
+                                nonzero--;
+                        }
+                }
+        }
+}
+
+/* FUNCTION:  decode_plane
+ * Purpose:   Decodes every block of a plane
+ * Arg:       stream: the stream to read from
+ *            cv_colors: the image, whose plane is filled
+ *            plane: the plane to decode
+ *            code: the tables of the plane
+ * Returns:   N/A
+ * Effect:    Reads, dequantizes and inverse transforms each block
+ * Error:     Runtime error if a block is not valid
+ */
+static void decode_plane(Bit_stream_T stream, Planar_T cv_colors,
+                         int plane, const struct Plane_code *code)
+{
+        int n = code->n;
+        int width = Planar_width(cv_colors) / code->subsample;
+        int height = Planar_height(cv_colors) / code->subsample;
+        int second_shift = 12 + code->log2n - INVERSE_SHIFT;
+
+        int32_t coeffs[MAX_COEFFS], cols[MAX_COEFFS], samples[MAX_COEFFS];
+        int32_t previous_dc = 0;
+        int bx, by, i;
+        for (by = 0; by < height; by += n) {
+                for (bx = 0; bx < width; bx += n) {
+                        for (i = 0; i < n * n; i++) {
+                                coeffs[i] = 0;
+                        }
+
+                        previous_dc += Bit_stream_get_se(stream);
+                        coeffs[0] = previous_dc * code->step[0];
+                        uint32_t nonzero = Bit_stream_get_ue(stream);
+                        assert(nonzero < (uint32_t)(n * n));
+                        i = 0;
+                        while (nonzero-- > 0) {
+                                /* i stays below n * n, whatever the run */
+                                uint32_t run = Bit_stream_get_ue(stream);
+                                assert(run < (uint32_t)(n * n - 1 - i));
+                                i += run + 1;
+                                int k = code->zigzag[i];
+                                coeffs[k] = Bit_stream_get_se(stream) *
+                                            code->step[k];
+                        }
+
+                        /* columns into the rows of cols, then rows */
+                        for (i = 0; i < n; i++) {
+                                inverse_1d(coeffs + i, n, cols + i * n, n,
+                                           INVERSE_SHIFT);
+                        }
+                        for (i = 0; i < n; i++) {
+                                inverse_1d(cols + i, n, samples + i * n, n,
+                                           second_shift);
+                        }
+
+                        store_block(cv_colors, plane, code, bx, by,
+                                    samples);
+                }
+        }
+}
+
+/* FUNCTION:  load_block
+ * Purpose:   Scales the samples of a block of a plane to integers
+ * Arg:       cv_colors: the image
+ *            plane: the plane
+ *            code: the tables of the plane
+ *            bx, by: the top left sample of the block, in the plane
+ *            block: receives n * n samples in raster order
+ * Returns:   N/A
+ * Effect:    A chroma sample is the average of 2 by 2 pixels; samples past
+ *            the edge of the plane repeat the last column or row
+ * Error:     N/A
+ */
+static void load_block(Planar_T cv_colors, int plane,
+                       const struct Plane_code *code, int bx, int by,
+                       int32_t *block)
+{
+        int n = code->n;
+        int sub = code->subsample;
+        int width = Planar_width(cv_colors) / sub;
+        int height = Planar_height(cv_colors) / sub;
+
+        int r, c;
+        for (r = 0; r < n; r++) {
+                int y = by + r < height ? by + r : height - 1;
+                const float *top = Planar_row(cv_colors, plane, y * sub);
+                const float *bottom = Planar_row(cv_colors, plane,
+                                                 y * sub + sub - 1);
+                for (c = 0; c < n; c++) {
+                        int x = bx + c < width ? bx + c : width - 1;
+                        float value;
+                        if (sub == 1) {
+                                value = top[x];
+                        } else {
+                                value = (top[2 * x] + top[2 * x + 1] +
+                                         bottom[2 * x] +
+                                         bottom[2 * x + 1]) / 4.0f;
+                        }
+                        block[r * n + c] = lrintf(value * SAMPLE_SCALE) -
+                                           code->offset;
+                }
+        }
+}
+
+/* FUNCTION:  store_block
+ * Purpose:   Stores the decoded samples of a block in a plane
+ * Arg:       cv_colors: the image
+ *            plane: the plane
+ *            code: the tables of the plane
+ *            bx, by: the top left sample of the block, in the plane
+ *            block: n * n samples in raster order
+ * Returns:   N/A
+ * Effect:    A chroma sample fills 2 by 2 pixels; samples past the edge of
+ *            the plane are dropped
+ * Error:     N/A
+ */
+static void store_block(Planar_T cv_colors, int plane,
+                        const struct Plane_code *code, int bx, int by,
+                        const int32_t *block)
+{
+        int n = code->n;
+        int sub = code->subsample;
+        int width = Planar_width(cv_colors) / sub;
+        int height = Planar_height(cv_colors) / sub;
+
+        int r, c, i;
+        for (r = 0; r < n && by + r < height; r++) {
+                for (i = 0; i < sub; i++) {
+                        float *pixels = Planar_row(cv_colors, plane,
+                                                   (by + r) * sub + i);
+                        for (c = 0; c < n && bx + c < width; c++) {
+                                float value = (block[r * n + c] +
+                                               code->offset) / SAMPLE_SCALE;
+                                int x = (bx + c) * sub;
+                                pixels[x] = value;
+                                pixels[x + sub - 1] = value;
+                        }
+                }
+        }
+}
+
+/* FUNCTION:  forward_1d
+ * Purpose:   Transforms n samples with the integer DCT basis
+ * Arg:       x: n samples, consecutive
+ *            y: receives n coefficients, ystride apart
+ *            ystride: the distance between coefficients
+ *            n: 4 or 8
+ * Returns:   N/A
+ * Effect:    The sums and differences of mirrored samples feed the even
+ *            and odd coefficients; no rounding
+ * Error:     N/A
+ */
+static void forward_1d(const int32_t *x, int32_t *y, int ystride, int n)
+{
+        if (n == 4) {
+                int32_t e0 = x[0] + x[3], o0 = x[0] - x[3];
+                int32_t e1 = x[1] + x[2], o1 = x[1] - x[2];
+
+                y[0] = 64 * (e0 + e1);
+                y[2 * ystride] = 64 * (e0 - e1);
+                y[ystride] = 83 * o0 + 36 * o1;
+                y[3 * ystride] = 36 * o0 - 83 * o1;
+                return;
+        }
+
+        int32_t e[4], o[4];
+        int k;
+        for (k = 0; k < 4; k++) {
+                e[k] = x[k] + x[7 - k];
+                o[k] = x[k] - x[7 - k];
+        }
+        int32_t ee0 = e[0] + e[3], eo0 = e[0] - e[3];
+        int32_t ee1 = e[1] + e[2], eo1 = e[1] - e[2];
+
+        y[0] = 64 * (ee0 + ee1);
+        y[4 * ystride] = 64 * (ee0 - ee1);
+        y[2 * ystride] = 83 * eo0 + 36 * eo1;
+        y[6 * ystride] = 36 * eo0 - 83 * eo1;
+        y[ystride] = 89 * o[0] + 75 * o[1] + 50 * o[2] + 18 * o[3];
+        y[3 * ystride] = 75 * o[0] - 18 * o[1] - 89 * o[2] - 50 * o[3];
+        y[5 * ystride] = 50 * o[0] - 89 * o[1] + 18 * o[2] + 75 * o[3];
+        y[7 * ystride] = 18 * o[0] - 50 * o[1] + 75 * o[2] - 89 * o[3];
+}
+
+/* FUNCTION:  inverse_1d
+ * Purpose:   Inverts forward_1d, up to a scale
+ * Arg:       y: n coefficients, ystride apart
+ *            ystride: the distance between coefficients
+ *            x: receives n samples, consecutive
+ *            n: 4 or 8
+ *            shift: the samples are divided by 2^shift, rounding
+ * Returns:   N/A
+ * Effect:    The even and odd halves are rebuilt separately and combined
+ * Error:     N/A
+ */
+static void inverse_1d(const int32_t *y, int ystride, int32_t *x, int n,
+                       int shift)
+{
+        int32_t round = 1 << (shift - 1);
+        int32_t e[4], o[4];
+        int k;
+
+        if (n == 4) {
+                e[0] = 64 * (y[0] + y[2 * ystride]);
+                e[1] = 64 * (y[0] - y[2 * ystride]);
+                o[0] = 83 * y[ystride] + 36 * y[3 * ystride];
+                o[1] = 36 * y[ystride] - 83 * y[3 * ystride];
+                for (k = 0; k < 2; k++) {
+                        x[k] = (e[k] + o[k] + round) >> shift;
+                        x[3 - k] = (e[k] - o[k] + round) >> shift;
+                }
+                return;
+        }
+
+        const int32_t y1 = y[ystride], y3 = y[3 * ystride];
+        const int32_t y5 = y[5 * ystride], y7 = y[7 * ystride];
+        o[0] = 89 * y1 + 75 * y3 + 50 * y5 + 18 * y7;
+        o[1] = 75 * y1 - 18 * y3 - 89 * y5 - 50 * y7;
+        o[2] = 50 * y1 - 89 * y3 + 18 * y5 + 75 * y7;
+        o[3] = 18 * y1 - 50 * y3 + 75 * y5 - 89 * y7;
+
+        int32_t eo0 = 83 * y[2 * ystride] + 36 * y[6 * ystride];
+        int32_t eo1 = 36 * y[2 * ystride] - 83 * y[6 * ystride];
+        int32_t ee0 = 64 * (y[0] + y[4 * ystride]);
+        int32_t ee1 = 64 * (y[0] - y[4 * ystride]);
+        e[0] = ee0 + eo0;
+        e[3] = ee0 - eo0;
+        e[1] = ee1 + eo1;
+        e[2] = ee1 - eo1;
+
+        for (k = 0; k < 4; k++) {
+                x[k] = (e[k] + o[k] + round) >> shift;
+                x[7 - k] = (e[k] - o[k] + round) >> shift;
+        }
+}
+
+/* FUNCTION:  put_u32
+ * Purpose:   Stores a 32 bit value, most significant byte first
+ * Arg:       value: the value
+ *            bytes: receives 4 bytes
+ * Returns:   N/A
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static void put_u32(uint32_t value, unsigned char *bytes)
+{
+        bytes[0] = value >> 24;
+        bytes[1] = value >> 16;
+        bytes[2] = value >> 8;
+        bytes[3] = value;
+}
+
+/* FUNCTION:  get_u32
+ * Purpose:   Loads a 32 bit value stored most significant byte first
+ * Arg:       bytes: 4 bytes
+ * Returns:   The value
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static uint32_t get_u32(const unsigned char *bytes)
+{
+        return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) |
+               ((uint32_t)bytes[2] << 8) | bytes[3];
+}
@@ -0,0 +1,56 @@
+/*****************************************************************************
+ *
+ *                                Block_DCT.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Block_DCT module. The purpose of
+ *     this module is a compressed format with larger blocks (40image -c
+ *     --block 4 or --block 8, header "COMP40 Compressed image format 4").
+ *     The luma plane is cut into 4 by 4 or 8 by 8 blocks and the chroma
+ *     planes, averaged over 2 by 2 pixels as in format 2, into blocks of
+ *     the same size. Each block goes through a separable integer DCT, is
+ *     quantized with a table that keeps more of the low frequencies, and
+ *     its nonzero coefficients are packed with variable length codes by
+ *     Bit_stream. Unlike the fixed 32 bit codewords of format 2, smooth
+ *     blocks take only a few bits.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include "Planar.h"
+
+#ifndef BLOCKDCT_INCLUDED
+#define BLOCKDCT_INCLUDED
+
+/* number in the header of the block format */
+#define BLOCK_DCT_FORMAT 4
+
+/* FUNCTION:  Block_DCT_write
+ * Purpose:   Compresses an image of CV colors to the block format
+ * Arg:       cv_colors: a planar image with y, pb and pr planes and even
+ *                       dimensions
+ *            block: the width of the luma blocks, 4 or 8
+ *            file: pointer to a file open for writing
+ * Returns:   N/A
+ * Effect:    Writes the header and the coded blocks; recycles cv_colors
+ * Error:     Runtime error if a NULL pointer is passed in, if block is not
+ *            4 or 8 or if the write fails
+ */
+void Block_DCT_write(Planar_T cv_colors, int block, FILE *file);
+
+/* FUNCTION:  Block_DCT_read
+ * Purpose:   Decompresses an image in the block format
+ * Arg:       file: pointer to a file, just after the header read by
+ *                  Codewords_File_read_header
+ *            width, height: the dimensions of the image from the header
+ * Returns:   A planar image with y, pb and pr planes
+ * Effect:    Reads the rest of the image
+ * Error:     Runtime error if a NULL pointer is passed in or if the file is
+ *            not a complete image in the block format
+ */
+Planar_T Block_DCT_read(FILE *file, unsigned width, unsigned height);
+
+#endif
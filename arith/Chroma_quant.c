@@ -0,0 +1,92 @@
+/*****************************************************************************
+ *
+ *                               Chroma_quant.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Chroma_quant module. The
+ *     chroma table is the one used by the arith40 library. thresholds[i] is
+ *     the smallest float that the nearest value search maps above index i;
+ *     the values were found by bisection over the floats and checked
+ *     against Arith40_index_of_chroma for every float in [-1.5, 1.5]. They
+ *     sit within an ulp or two of the midpoints between table values.
+ *
+ *****************************************************************************/
+#include <assert.h>
+#include <stdlib.h>
+#include "Chroma_quant.h"
+
+static const float chroma_of_index[CHROMA_CODES] = {
+        -0.35f, -0.20f, -0.15f, -0.10f, -0.077f, -0.055f, -0.033f, -0.011f,
+         0.011f, 0.033f, 0.055f, 0.077f, 0.10f, 0.15f, 0.20f, 0.35f
+};
+
+static const float thresholds[CHROMA_CODES - 1] = {
+        -0x1.199998p-2f, -0x1.666666p-3f, -0x1p-3f,        -0x1.6a7ef8p-4f,
+        -0x1.0e5602p-4f, -0x1.6872aep-5f, -0x1.6872aep-6f,  0x1.000002p-31f,
+         0x1.6872b2p-6f,  0x1.6872b2p-5f,  0x1.0e5606p-4f,  0x1.6a7efcp-4f,
+         0x1.000002p-3f,  0x1.666668p-3f,  0x1.19999ap-2f
+};
+
+/* FUNCTION:  Chroma_quant_index
+ * Purpose:   Quantizes a chroma value to a 4 bit code
+ * Arg:       chroma: an average Pb or Pr value
+ * Returns:   The code, from 0 to CHROMA_CODES - 1; NaN maps to 0
+ * Effect:    N/A
+ * Error:     N/A
+ */
+unsigned Chroma_quant_index(float chroma)
+{
+        unsigned index = 0;
+
+        int i;
+        for (i = 0; i < CHROMA_CODES - 1; i++) {
+                index += chroma >= thresholds[i];
+        }
+
+        return index;
+}
+
+/* FUNCTION:  Chroma_quant_index_row
+ * Purpose:   Quantizes a row of chroma values to 4 bit codes
+ * Arg:       chroma: n average Pb or Pr values
+ *            indices: receives the n codes
+ *            n: the number of values
+ * Returns:   N/A
+ * Effect:    Writes indices[0] to indices[n - 1]
+ * Error:     Runtime error if chroma or indices is NULL
+ */
+void Chroma_quant_index_row(const float *chroma, unsigned *indices, int n)
+{
+        assert(chroma != NULL);
+        assert(indices != NULL);
+
+        /* the thresholds are the outer loop so that the inner loop is a
+           compare and add across the row */
+        int col, i;
+        for (col = 0; col < n; col++) {
+                indices[col] = 0;
+        }
+        for (i = 0; i < CHROMA_CODES - 1; i++) {
+                float threshold = thresholds[i];
+                for (col = 0; col < n; col++) {
+                        indices[col] += chroma[col] >= threshold;
+                }
+        }
+}
+
+/* FUNCTION:  Chroma_quant_chroma
+ * Purpose:   Returns the chroma value of a 4 bit code
+ * Arg:       index: a code from 0 to CHROMA_CODES - 1
+ * Returns:   The chroma value
+ * Effect:    N/A
+ * Error:     Runtime error if index is out of range
+ */
+float Chroma_quant_chroma(unsigned index)
+{
+        assert(index < CHROMA_CODES);
+        return chroma_of_index[index];
+}
@@ -0,0 +1,56 @@
+/*****************************************************************************
+ *
+ *                               Chroma_quant.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Chroma_quant module. The purpose
+ *     of this module is to quantize average Pb and Pr values to the 4 bit
+ *     chroma codes of the arith40 library, and back, without calling into
+ *     it. An index is the number of precomputed thresholds that the chroma
+ *     value reaches, so it costs 15 compares and no search or branches, and
+ *     a row of values can be quantized in one vectorizable loop. The
+ *     indices are identical to those of Arith40_index_of_chroma (nearest
+ *     table value, ties to the lower index) for every float.
+ *
+ *****************************************************************************/
+#ifndef CHROMAQUANT_INCLUDED
+#define CHROMAQUANT_INCLUDED
+
+/* number of chroma codes */
+#define CHROMA_CODES 16
+
+/* FUNCTION:  Chroma_quant_index
+ * Purpose:   Quantizes a chroma value to a 4 bit code
+ * Arg:       chroma: an average Pb or Pr value
+ * Returns:   The code, from 0 to CHROMA_CODES - 1
+ * Effect:    N/A
+ * Error:     N/A
+ */
+extern unsigned Chroma_quant_index(float chroma);
+
+/* FUNCTION:  Chroma_quant_index_row
+ * Purpose:   Quantizes a row of chroma values to 4 bit codes
+ * Arg:       chroma: n average Pb or Pr values
+ *            indices: receives the n codes
+ *            n: the number of values
+ * Returns:   N/A
+ * Effect:    Writes indices[0] to indices[n - 1]
+ * Error:     Runtime error if chroma or indices is NULL
+ */
+extern void Chroma_quant_index_row(const float *chroma, unsigned *indices,
+                                   int n);
+
+/* FUNCTION:  Chroma_quant_chroma
+ * Purpose:   Returns the chroma value of a 4 bit code
+ * Arg:       index: a code from 0 to CHROMA_CODES - 1
+ * Returns:   The chroma value
+ * Effect:    N/A
+ * Error:     Runtime error if index is out of range
+ */
+extern float Chroma_quant_chroma(unsigned index);
+
+#endif
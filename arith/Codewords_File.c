@@ -9,25 +9,36 @@
  *     Summary:
  *     This is the private implementation of our Codewords_File module. 
  *     The purpose of this module is to convert between a UArray2 of bitpacked
- *     codwords and a binary file of codewords. This module contains two public
- *     functions, one that takes in a UArray2 of codewords and writes a binary
- *     file of codewords to stdout and one that reads in a binary file of
- *     codewords and returns a UArray2 of codewords. Both these functions rely 
- *     on mapping private apply functions over the respective UArray2s to 
- *     convert between the different values. Data is not lost during
- *     reading or writing in this module.
+ *     codwords and a binary file of codewords. Codewords_File_write writes
+ *     a UArray2 of codewords as a binary file and 
+ *     Codewords_File_read_codewords reads one back after its header; a 
+ *     rectangle of blocks can also be read on its own. Both these functions
+ *     move whole rows of codewords at a time through a large buffer, with
+ *     one fwrite or fread per buffer. Each codeword is stored as 
+ *     CODEWORD_BYTES bytes, most significant byte first. Data is not lost
+ *     during reading or writing in this module.
  * 
  *
  ****************************************************************************/
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include "Codewords_File.h"
 #include <stdbool.h>
 #include <stdio.h>
-#include <bitpack.h>
+#include <stdint.h>
+#include <sys/types.h>
 #include "uarray2.h"
 /* this is the struct definition for the DCT_ints struct */
 #include "DCT_ints.h"
+/* decodes images in the entropy coded format */
+#include "Codewords_rANS.h"
+/* the number of the block format, whose header is read here too */
+#include "Block_DCT.h"
+/* the number of the sequence format, whose header is read here too */
+#include "Sequence.h"
+/* the number of the pyramid format, whose header is read here too */
+#include "Pyramid.h"
 
 /* Represents the bit size of a character */
 #define CHAR_BITS 8
@@ -36,168 +47,493 @@
 /* (uses the #define values from the DCT_ints struct)*/
 #define CODEWORD_BYTES ((A_WIDTH + 3 * BCD_WIDTH + 2 * AVG_PBPR_WIDTH) / 8)
 
+/* Header of the fixed size format, up to the dimensions */
+#define HEADER_MAGIC "COMP40 Compressed image format 2\n"
+
+/* Size of the buffer that whole rows of codewords are staged in before a
+   single fwrite or fread */
+#define BUFFER_BYTES (1 << 20)
+
 /*
  * private helper functions, functions details are included in the function
  * contracts respectively
  */
-static void     print_apply(int col, int row, UArray2_T array2, void *val, 
-                            void *mtds);
-static void     read_apply (int col, int row, UArray2_T array2, void *val, 
-                            void *mtd_file);
-static void     print_codeword(uint64_t codeword, unsigned size);
-static uint64_t read_codeword (FILE *file, unsigned size);
+static void     put_row(const uint64_t *codewords, int width, 
+                        unsigned char *bytes);
+static void     get_row(const unsigned char *bytes, int width, 
+                        uint64_t *codewords);
+static int      rows_per_buffer(int width);
+static void     skip_bytes(FILE *file, off_t nbytes);
+static size_t   put_decimal(unsigned n, unsigned char *bytes);
+static size_t   get_decimal(const unsigned char *bytes, size_t length,
+                            unsigned *n);
 
 
-/* FUNCTION:  Codewords_File_print
- * Purpose:   Prints a UArray2 of codewords into standard output
+/* FUNCTION:  Codewords_File_write
+ * Purpose:   Writes a UArray2 of codewords to a file
  * Arg:       codewords: pointer to a UArray2 of codewords
+ *            file: pointer to a file open for writing
  * Returns:   N/A
- * Effect:    Recycles the UArray2 of codewords
+ * Effect:    Writes the header and the rows; recycles the UArray2 of 
+ *            codewords
+ * Error:     Runtime error if a NULL pointer is passed in or if the write
+ *            fails
+ */
+void Codewords_File_write(UArray2_T codewords, FILE *file)
+{
+        assert(codewords != NULL);
+        assert(file != NULL);
+
+        Codewords_File_write_header(file, UArray2_width(codewords) * 2,
+                                    UArray2_height(codewords) * 2);
+        Codewords_File_write_rows(codewords, file);
+        UArray2_free(&codewords);
+}
+
+/* FUNCTION:  Codewords_File_write_header
+ * Purpose:   Writes the header of a compressed image
+ * Arg:       file: pointer to a file open for writing
+ *            width, height: the dimensions of the image in pixels
+ * Returns:   N/A
+ * Effect:    N/A
  * Error:     Runtime error if a NULL pointer is passed in
  */
-void Codewords_File_print(UArray2_T codewords)
+void Codewords_File_write_header(FILE *file, unsigned width, 
+                                 unsigned height)
+{
+        assert(file != NULL);
+
+        fprintf(file, HEADER_MAGIC "%u %u\n", width, height);
+}
+
+/* FUNCTION:  Codewords_File_write_rows
+ * Purpose:   Writes the rows of a UArray2 of codewords, without a header
+ * Arg:       codewords: pointer to a UArray2 of codewords
+ *            file: pointer to a file open for writing
+ * Returns:   N/A
+ * Effect:    Whole rows of codewords are converted to big-endian bytes in
+ *            a buffer and written with one fwrite per buffer; codewords is
+ *            not changed
+ * Error:     Runtime error if a NULL pointer is passed in or if the write
+ *            fails
+ */
+void Codewords_File_write_rows(UArray2_T codewords, FILE *file)
 {
         assert(codewords != NULL);
+        assert(file != NULL);
 
-        /* prints the header */
-        unsigned width = UArray2_width(codewords);
-        unsigned height = UArray2_height(codewords);
-        printf("COMP40 Compressed image format 2\n%u %u\n", width * 2, 
-                                                            height * 2);
+        int width = UArray2_width(codewords);
+        int height = UArray2_height(codewords);
+        size_t row_bytes = (size_t)width * CODEWORD_BYTES;
+        int nrows = rows_per_buffer(width);
+        unsigned char *buffer = malloc(row_bytes * nrows + 1);
+        assert(buffer != NULL);
 
-        /* map over the UArray2 and prints to standard output */
-        UArray2_map_row_major(codewords, print_apply, NULL);
+        int row = 0;
+        while (width > 0 && row < height) {
+                /* fill the buffer with as many rows as fit */
+                int filled = 0;
+                for (; filled < nrows && row < height; filled++, row++) {
+                        put_row(UArray2_row(codewords, row), width,
+                                buffer + filled * row_bytes);
+                }
 
-        UArray2_free(&codewords);
+                size_t written = fwrite(buffer, row_bytes, filled, file);
+                assert(written == (size_t)filled);
+        }
+
+        free(buffer);
 }
 
-/* FUNCTION:  Codewords_File_read
- * Purpose:   Reads from a binary file and initialize a UArray2 of codewords
- * Arg:       file: pointer to a file instance
+/* FUNCTION:  Codewords_File_read_codewords
+ * Purpose:   Reads the codewords of a compressed image whose header has
+ *            been read
+ * Arg:       file: pointer to a file instance, just after the header
+ *            format: the format number from the header
+ *            width, height: the dimensions of the image from the header
  * Returns:   Pointer to an instance of UArray2 of codewords
- * Effect:    N/A
- * Error:     Runtime error if a NULL pointer is passed in
- *            Runtime error for not correctly formatted header
+ * Effect:    Entropy coded images are decoded by Codewords_rANS_read
+ * Error:     Runtime error if a NULL pointer is passed in, if the format
+ *            has no codewords or if the file ends early
  */
-UArray2_T Codewords_File_read(FILE *file)
+UArray2_T Codewords_File_read_codewords(FILE *file, int format, 
+                                        unsigned width, unsigned height)
 {
         assert(file != NULL);
+        assert(format != BLOCK_DCT_FORMAT && format != SEQUENCE_FORMAT &&
+               format != PYRAMID_FORMAT);
 
-        /* gets width and height of the image from the header */
-        unsigned height, width;
-        int read = fscanf(file, "COMP40 Compressed image format 2\n%u %u", 
-                          &width, &height); 
-        assert(read == 2);
-        int c = getc(file);
-        assert(c == '\n');
+        if (format == CODEWORDS_RANS_FORMAT) {
+                return Codewords_rANS_read(file, width, height);
+        }
 
         /* Initialize a UArray2 of codewords with half the dimensions from
            the original binary file */
         unsigned size = sizeof(uint64_t);
         UArray2_T codewords = UArray2_new(width / 2, height / 2, size);
 
-        UArray2_map_row_major(codewords, read_apply, file);
+        int cols = width / 2;
+        int rows = height / 2;
+        size_t row_bytes = (size_t)cols * CODEWORD_BYTES;
+        int nrows = rows_per_buffer(cols);
+        unsigned char *buffer = malloc(row_bytes * nrows + 1);
+        assert(buffer != NULL);
+
+        int row = 0;
+        while (cols > 0 && row < rows) {
+                int wanted = rows - row < nrows ? rows - row : nrows;
+                size_t got = fread(buffer, row_bytes, wanted, file);
+                assert(got == (size_t)wanted);
+
+                int i;
+                for (i = 0; i < wanted; i++, row++) {
+                        get_row(buffer + i * row_bytes, cols,
+                                UArray2_row(codewords, row));
+                }
+        }
+
+        free(buffer);
 
         return codewords;
 }
 
-/* FUNCTION:  print_apply
- * Purpose:   For each element in the UArray2 of codewords, prints each 
-              codeword to standard output
- * Arg:       col: a int representing the current column in the array (unused)
- *            row: a row representing the current row in the array (unused)
- *            array2: pointer to a UArray2 of codewords (unused)
- *            val: pointer to the current element containing a codeword
- *            cl: unused closure variable
- * Returns:   N/A
- * Effect:    Calls a private helper function that prints a codeword
+/* FUNCTION:  Codewords_File_read_header
+ * Purpose:   Reads the header of a compressed image
+ * Arg:       file: pointer to a file instance, at the start of the image
+ *            width, height: receive the dimensions of the image in pixels
+ * Returns:   The format number of the image: 2 for fixed size codewords,
+ *            CODEWORDS_RANS_FORMAT for entropy coded ones
+ * Effect:    Leaves file at the first byte after the header
+ * Error:     Runtime error if a NULL pointer is passed in
+ *            Runtime error for not correctly formatted header or an
+ *            unknown format
+ */
+int Codewords_File_read_header(FILE *file, unsigned *width, 
+                               unsigned *height)
+{
+        assert(file != NULL);
+        assert(width != NULL && height != NULL);
+
+        int format;
+        int read = fscanf(file, "COMP40 Compressed image format %d\n%u %u", 
+                          &format, width, height); 
+        assert(read == 3);
+        assert(format == 2 || format == CODEWORDS_RANS_FORMAT || 
+               format == BLOCK_DCT_FORMAT || format == SEQUENCE_FORMAT ||
+               format == PYRAMID_FORMAT);
+        int c = getc(file);
+        assert(c == '\n');
+
+        return format;
+}
+
+/* FUNCTION:  Codewords_File_read_blocks
+ * Purpose:   Reads the codewords of a rectangle of blocks
+ * Arg:       file: pointer to a file instance, just after the header
+ *            width, height: the dimensions of the image from the header
+ *            col, row: the first block of the rectangle
+ *            ncols, nrows: the size of the rectangle, in blocks
+ * Returns:   Pointer to a UArray2 of ncols by nrows codewords
+ * Effect:    Every codeword takes CODEWORD_BYTES bytes and rows are stored
+ *            one after the other, so the codewords outside the rectangle
+ *            are skipped with a seek (or read and dropped if file cannot
+ *            seek); only the rectangle is read and converted
+ * Error:     Runtime error if a NULL pointer is passed in
+ *            Runtime error if the rectangle is empty or not inside the image
+ *            Runtime error if the file ends before the last codeword
+ */
+UArray2_T Codewords_File_read_blocks(FILE *file, unsigned width, 
+                                     unsigned height, int col, int row,
+                                     int ncols, int nrows)
+{
+        assert(file != NULL);
+
+        int cols = width / 2;
+        int rows = height / 2;
+        assert(col >= 0 && ncols > 0 && col + ncols <= cols);
+        assert(row >= 0 && nrows > 0 && row + nrows <= rows);
+
+        unsigned size = sizeof(uint64_t);
+        UArray2_T codewords = UArray2_new(ncols, nrows, size);
+
+        size_t row_bytes = (size_t)ncols * CODEWORD_BYTES;
+        unsigned char *buffer = malloc(row_bytes);
+        assert(buffer != NULL);
+
+        /* offset of the next byte to be read, from the first codeword */
+        off_t position = 0;
+
+        int i;
+        for (i = 0; i < nrows; i++) {
+                off_t start = ((off_t)(row + i) * cols + col) * 
+                              CODEWORD_BYTES;
+                skip_bytes(file, start - position);
+
+                size_t got = fread(buffer, row_bytes, 1, file);
+                assert(got == 1);
+                position = start + row_bytes;
+
+                get_row(buffer, ncols, UArray2_row(codewords, i));
+        }
+
+        free(buffer);
+
+        return codewords;
+}
+
+/* FUNCTION:  Codewords_File_bytes
+ * Purpose:   Gives the size of a compressed image in the fixed size format
+ * Arg:       width, height: the dimensions of the image in pixels, even
+ * Returns:   The number of bytes of the header and the codewords
+ * Effect:    N/A
  * Error:     N/A
  */
-static void print_apply(int col, int row, UArray2_T array2, void *val, 
-                        void *cl)
+size_t Codewords_File_bytes(unsigned width, unsigned height)
 {
-        uint64_t codeword = *(uint64_t *)val;
-        
-        print_codeword(codeword, CODEWORD_BYTES);
+        unsigned char digits[10];
+        size_t header = sizeof(HEADER_MAGIC) - 1 + 
+                        put_decimal(width, digits) + 1 + 
+                        put_decimal(height, digits) + 1;
 
-        (void) col;
-        (void) row;
-        (void) cl;
-        (void) array2;
+        return header + (size_t)(width / 2) * (height / 2) * CODEWORD_BYTES;
 }
 
-/* FUNCTION:  read_apply
- * Purpose:   Reads from a file and write to the UArray2 of codewords 
- * Arg:       col: a int representing the current column in the array (unused)
- *            row: a row representing the current row in the array (unused)
- *            array2: pointer to a UArray2 of codewords (unused)
- *            val: pointer to the current element containing a codeword
- *            cl: pointer to a file
+/* FUNCTION:  Codewords_File_store
+ * Purpose:   Stores a UArray2 of codewords in a buffer in memory, in the
+ *            same bytes that Codewords_File_write writes
+ * Arg:       codewords: pointer to a UArray2 of codewords
+ *            bytes: the buffer, of at least Codewords_File_bytes bytes
+ * Returns:   The number of bytes stored
+ * Effect:    codewords is not changed
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+size_t Codewords_File_store(UArray2_T codewords, unsigned char *bytes)
+{
+        assert(codewords != NULL);
+        assert(bytes != NULL);
+
+        int width = UArray2_width(codewords);
+        int height = UArray2_height(codewords);
+        unsigned char *start = bytes;
+
+        size_t magic = sizeof(HEADER_MAGIC) - 1;
+        memcpy(bytes, HEADER_MAGIC, magic);
+        bytes += magic;
+        bytes += put_decimal(width * 2, bytes);
+        *bytes++ = ' ';
+        bytes += put_decimal(height * 2, bytes);
+        *bytes++ = '\n';
+
+        int row;
+        for (row = 0; width > 0 && row < height; row++) {
+                put_row(UArray2_row(codewords, row), width, bytes);
+                bytes += (size_t)width * CODEWORD_BYTES;
+        }
+
+        return bytes - start;
+}
+
+/* FUNCTION:  Codewords_File_parse_header
+ * Purpose:   Parses the header of a compressed image in memory
+ * Arg:       bytes: the compressed image
+ *            length: the number of bytes of the image
+ *            width, height: receive the dimensions of the image in pixels
+ * Returns:   The number of bytes of the header, or 0 if bytes does not
+ *            start with the header of the fixed size format
+ * Effect:    Accepts exactly the headers Codewords_File_write_header writes
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+size_t Codewords_File_parse_header(const unsigned char *bytes, size_t length,
+                                   unsigned *width, unsigned *height)
+{
+        assert(bytes != NULL);
+        assert(width != NULL && height != NULL);
+
+        size_t i = sizeof(HEADER_MAGIC) - 1;
+        if (length < i || memcmp(bytes, HEADER_MAGIC, i) != 0) {
+                return 0;
+        }
+
+        size_t digits = get_decimal(bytes + i, length - i, width);
+        i += digits;
+        if (digits == 0 || i >= length || bytes[i++] != ' ') {
+                return 0;
+        }
+        digits = get_decimal(bytes + i, length - i, height);
+        i += digits;
+        if (digits == 0 || i >= length || bytes[i++] != '\n') {
+                return 0;
+        }
+
+        return i;
+}
+
+/* FUNCTION:  Codewords_File_load
+ * Purpose:   Loads the codewords of a compressed image in memory
+ * Arg:       bytes: the codewords, just after the header
+ *            width, height: the dimensions of the image from the header
+ * Returns:   Pointer to a UArray2 of width/2 by height/2 codewords
+ * Effect:    Converts the rows straight out of bytes
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+UArray2_T Codewords_File_load(const unsigned char *bytes, unsigned width,
+                              unsigned height)
+{
+        assert(bytes != NULL);
+
+        int cols = width / 2;
+        int rows = height / 2;
+        UArray2_T codewords = UArray2_new(cols, rows, sizeof(uint64_t));
+
+        int row;
+        for (row = 0; cols > 0 && row < rows; row++) {
+                get_row(bytes, cols, UArray2_row(codewords, row));
+                bytes += (size_t)cols * CODEWORD_BYTES;
+        }
+
+        return codewords;
+}
+
+/* FUNCTION:  put_row
+ * Purpose:   Converts a row of codewords to the bytes written to the file
+ * Arg:       codewords: the row of codewords
+ *            width: the number of codewords in the row
+ *            bytes: receives width * CODEWORD_BYTES bytes
  * Returns:   N/A
- * Effect:    Calls a private helper function that reads from a file
+ * Effect:    Each codeword is stored most significant byte first
  * Error:     N/A
  */
-static void read_apply(int col, int row, UArray2_T array2, void *val, 
-                       void *file)
+static void put_row(const uint64_t *codewords, int width, 
+                    unsigned char *bytes)
 {
-        *(uint64_t *)val = read_codeword((FILE *)file, CODEWORD_BYTES);
-
-        (void) col;
-        (void) row;
-        (void) array2;
+        int col;
+        unsigned i;
+        for (col = 0; col < width; col++) {
+                uint64_t codeword = codewords[col];
+                for (i = 0; i < CODEWORD_BYTES; i++) {
+                        /* total number of bits in a codeword - bits that
+                           have already been stored */
+                        unsigned lsb = (CODEWORD_BYTES - 1 - i) * CHAR_BITS;
+                        bytes[i] = (unsigned char)(codeword >> lsb);
+                }
+                bytes += CODEWORD_BYTES;
+        }
 }
 
-/* FUNCTION:  print_codeword
- * Purpose:   write a codeword to stdout
- * Arg:       codeword: a uint64_t representing a codeword
- *            size: the size of the codeword (in bytes)
+/* FUNCTION:  get_row
+ * Purpose:   Converts the bytes read from the file to a row of codewords
+ * Arg:       bytes: width * CODEWORD_BYTES bytes
+ *            width: the number of codewords in the row
+ *            codewords: receives the row of codewords
  * Returns:   N/A
- * Effect:    Codeword is printed to stdout
+ * Effect:    Each codeword is read most significant byte first
  * Error:     N/A
  */
-static void print_codeword(uint64_t codeword, unsigned size)
+static void get_row(const unsigned char *bytes, int width, 
+                    uint64_t *codewords)
 {
+        int col;
         unsigned i;
-        for (i = 0; i < size; i++) {
-                /* total number of bits in a codeword - bits that have already 
-                   been packed */
-                unsigned lsb = (CODEWORD_BYTES * CHAR_BITS) - 
-                               ((i + 1) * CHAR_BITS);
+        for (col = 0; col < width; col++) {
+                uint64_t codeword = 0;
+                for (i = 0; i < CODEWORD_BYTES; i++) {
+                        codeword = (codeword << CHAR_BITS) | bytes[i];
+                }
+                codewords[col] = codeword;
+                bytes += CODEWORD_BYTES;
+        }
+}
 
-                /* get the current bits and prints */               
-                unsigned current_bits = Bitpack_getu(codeword, CHAR_BITS, lsb);
-                putchar(current_bits);
+/* FUNCTION:  rows_per_buffer
+ * Purpose:   Computes how many rows of codewords fit in the buffer
+ * Arg:       width: the number of codewords in a row
+ * Returns:   The number of rows; at least 1
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static int rows_per_buffer(int width)
+{
+        size_t row_bytes = (size_t)width * CODEWORD_BYTES;
+        if (row_bytes == 0 || row_bytes >= BUFFER_BYTES) {
+                return 1;
         }
+
+        return BUFFER_BYTES / row_bytes;
 }
 
-/* FUNCTION:  read_codeword
- * Purpose:   Read in a codeword from the binary file
- * Arg:       file: an opened binary file of codewords
- *            size: the size of the codeword (in bytes)
- * Returns:   a uint64_t storing the codeword
- * Effect:    Data is read in from the file in byte sized chunks.
- * Error:     Runtime error if EOF is hit while reading
- *            Runtime error if file is not provided
+/* FUNCTION:  skip_bytes
+ * Purpose:   Moves forward in a file
+ * Arg:       file: pointer to a file instance
+ *            nbytes: the number of bytes to skip; not negative
+ * Returns:   N/A
+ * Effect:    Seeks when the file allows it and otherwise reads the bytes
+ *            and drops them, so that pipes work too
+ * Error:     Runtime error if the file ends first
  */
-static uint64_t read_codeword(FILE *file, unsigned size)
+static void skip_bytes(FILE *file, off_t nbytes)
 {
-        assert(file != NULL);
+        assert(nbytes >= 0);
 
-        uint64_t codeword = 0;
-        unsigned i;
-        for (i = 0; i < size; i++) {
-                /* reads in one byte */
-                int bits_read = getc(file);
-                assert(bits_read != EOF);
-                
-                /* total number of bits in a codeword - bits that have already 
-                   been packed */
-                unsigned lsb = (CODEWORD_BYTES * CHAR_BITS) - 
-                               ((i + 1) * CHAR_BITS); 
-                
-                /* pack the byte in the codeword */
-                codeword = Bitpack_newu(codeword, CHAR_BITS, lsb, bits_read);
-        }
-
-        return codeword;
-}
\ No newline at end of file
+        if (nbytes == 0 || fseeko(file, nbytes, SEEK_CUR) == 0) {
+                return;
+        }
+
+        unsigned char scratch[BUFSIZ];
+        while (nbytes > 0) {
+                size_t chunk = nbytes < BUFSIZ ? (size_t)nbytes : BUFSIZ;
+                size_t got = fread(scratch, 1, chunk, file);
+                assert(got == chunk);
+                nbytes -= chunk;
+        }
+}
+
+/* FUNCTION:  put_decimal
+ * Purpose:   Writes a number in decimal, without stdio
+ * Arg:       n: the number
+ *            bytes: room for at least 10 digits
+ * Returns:   The number of digits written
+ * Effect:    No terminating null character is written
+ * Error:     N/A
+ */
+static size_t put_decimal(unsigned n, unsigned char *bytes)
+{
+        unsigned char digits[10];
+        size_t count = 0;
+        do {
+                digits[count++] = '0' + n % 10;
+                n /= 10;
+        } while (n > 0);
+
+        size_t i;
+        for (i = 0; i < count; i++) {
+                bytes[i] = digits[count - 1 - i];
+        }
+
+        return count;
+}
+
+/* FUNCTION:  get_decimal
+ * Purpose:   Reads a number in decimal, without stdio
+ * Arg:       bytes: the digits
+ *            length: the number of bytes that may be read
+ *            n: receives the number
+ * Returns:   The number of digits read, or 0 if there is no digit or the
+ *            number does not fit in an unsigned
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static size_t get_decimal(const unsigned char *bytes, size_t length,
+                          unsigned *n)
+{
+        unsigned long long value = 0;
+        size_t i;
+        for (i = 0; i < length && bytes[i] >= '0' && bytes[i] <= '9'; i++) {
+                value = value * 10 + (bytes[i] - '0');
+                if (value > 0xffffffffULL) {
+                        return 0;
+                }
+        }
+
+        *n = value;
+        return i;
+}
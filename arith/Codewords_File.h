@@ -9,37 +9,149 @@
  *     Summary:
  *     This is the public interface of our Codewords_File module. 
  *     The purpose of this module is to convert between a UArray2 of bitpacked
- *     codwords and a binary file of codewords. This module contains two public
- *     functions, one that takes in a UArray2 of codewords and writes a binary
- *     file of codewords to stdout and one that reads in a binary file of
- *     codewords and returns a UArray2 of codewords. Data is not lost during
- *     reading or writing in this module.
+ *     codwords and a binary file of codewords. Codewords_File_write writes
+ *     a UArray2 of codewords as a binary file, and 
+ *     Codewords_File_read_header followed by Codewords_File_read_codewords
+ *     reads a binary file of codewords back into a UArray2. Because every
+ *     codeword has the same size, the header and any rectangle of blocks 
+ *     can also be read on their own. Data is not lost during reading or 
+ *     writing in this module.
  * 
  *
  ****************************************************************************/
 #include "uarray2.h"
 #include <stdio.h>
+#include <stddef.h>
 
 #ifndef CODEWORDSFILE_INCLUDED
 #define CODEWORDSFILE_INCLUDED
 
-/* FUNCTION:  Codewords_File_print
- * Purpose:   Prints a UArray2 of codewords into standard output
+/* FUNCTION:  Codewords_File_write
+ * Purpose:   Writes a UArray2 of codewords to a file
  * Arg:       codewords: pointer to a UArray2 of codewords
+ *            file: pointer to a file open for writing
  * Returns:   N/A
  * Effect:    Recycles the UArray2 of codewords
+ * Error:     Runtime error if a NULL pointer is passed in or if the write
+ *            fails
+ */
+void Codewords_File_write(UArray2_T codewords, FILE *file);
+
+/* FUNCTION:  Codewords_File_write_header
+ * Purpose:   Writes the header of a compressed image
+ * Arg:       file: pointer to a file open for writing
+ *            width, height: the dimensions of the image in pixels
+ * Returns:   N/A
+ * Effect:    Followed by Codewords_File_write_rows for every band of rows,
+ *            top to bottom, it writes the same file as Codewords_File_write
  * Error:     Runtime error if a NULL pointer is passed in
  */
-void Codewords_File_print(UArray2_T codewords);
+void Codewords_File_write_header(FILE *file, unsigned width, 
+                                 unsigned height);
+
+/* FUNCTION:  Codewords_File_write_rows
+ * Purpose:   Writes the rows of a UArray2 of codewords, without a header
+ * Arg:       codewords: pointer to a UArray2 of codewords
+ *            file: pointer to a file open for writing
+ * Returns:   N/A
+ * Effect:    codewords is not changed
+ * Error:     Runtime error if a NULL pointer is passed in or if the write
+ *            fails
+ */
+void Codewords_File_write_rows(UArray2_T codewords, FILE *file);
 
-/* FUNCTION:  Codewords_File_read
- * Purpose:   Reads from a binary file and initialize a UArray2 of codewords
- * Arg:       file: pointer to a file instance
+/* FUNCTION:  Codewords_File_read_codewords
+ * Purpose:   Reads the codewords of a compressed image whose header has
+ *            been read
+ * Arg:       file: pointer to a file instance, just after the header
+ *            format: the format number from Codewords_File_read_header
+ *            width, height: the dimensions of the image from the header
  * Returns:   Pointer to an instance of UArray2 of codewords
- * Effect:    N/A
+ * Effect:    Entropy coded images are decoded by Codewords_rANS_read
+ * Error:     Runtime error if a NULL pointer is passed in, if format is
+ *            BLOCK_DCT_FORMAT, SEQUENCE_FORMAT or PYRAMID_FORMAT, which
+ *            have no codewords of their own, or if the file ends early
+ */
+UArray2_T Codewords_File_read_codewords(FILE *file, int format, 
+                                        unsigned width, unsigned height);
+
+/* FUNCTION:  Codewords_File_read_header
+ * Purpose:   Reads the header of a compressed image
+ * Arg:       file: pointer to a file instance, at the start of the image
+ *            width, height: receive the dimensions of the image in pixels
+ * Returns:   The format number of the image: 2 for fixed size codewords,
+ *            CODEWORDS_RANS_FORMAT for entropy coded ones,
+ *            BLOCK_DCT_FORMAT for larger transform blocks,
+ *            SEQUENCE_FORMAT for sequences of frames and PYRAMID_FORMAT
+ *            for several zoom levels
+ * Effect:    Leaves file at the first byte after the header
  * Error:     Runtime error if a NULL pointer is passed in
  *            Runtime error for not correctly formatted header
  */
-UArray2_T Codewords_File_read(FILE *file);
+int Codewords_File_read_header(FILE *file, unsigned *width, 
+                                unsigned *height);
+
+/* FUNCTION:  Codewords_File_read_blocks
+ * Purpose:   Reads the codewords of a rectangle of 2 by 2 blocks, skipping
+ *            the rest of the file
+ * Arg:       file: pointer to a file instance, just after the header
+ *            width, height: the dimensions of the image from the header
+ *            col, row: the first block of the rectangle
+ *            ncols, nrows: the size of the rectangle, in blocks
+ * Returns:   Pointer to a UArray2 of ncols by nrows codewords
+ * Effect:    Seeks past the codewords outside the rectangle when file can
+ *            seek and reads past them otherwise
+ * Error:     Runtime error if a NULL pointer is passed in
+ *            Runtime error if the rectangle is empty or not inside the image
+ *            Runtime error if the file ends before the last codeword
+ */
+UArray2_T Codewords_File_read_blocks(FILE *file, unsigned width, 
+                                     unsigned height, int col, int row,
+                                     int ncols, int nrows);
+
+/* FUNCTION:  Codewords_File_bytes
+ * Purpose:   Gives the size of a compressed image in the fixed size format
+ * Arg:       width, height: the dimensions of the image in pixels, even
+ * Returns:   The number of bytes of the header and the codewords
+ * Effect:    N/A
+ * Error:     N/A
+ */
+size_t Codewords_File_bytes(unsigned width, unsigned height);
+
+/* FUNCTION:  Codewords_File_store
+ * Purpose:   Stores a UArray2 of codewords in a buffer in memory, in the
+ *            same bytes that Codewords_File_write writes
+ * Arg:       codewords: pointer to a UArray2 of codewords
+ *            bytes: the buffer, of at least Codewords_File_bytes bytes
+ * Returns:   The number of bytes stored
+ * Effect:    codewords is not changed; no stdio is used
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+size_t Codewords_File_store(UArray2_T codewords, unsigned char *bytes);
+
+/* FUNCTION:  Codewords_File_parse_header
+ * Purpose:   Parses the header of a compressed image in memory
+ * Arg:       bytes: the compressed image
+ *            length: the number of bytes of the image
+ *            width, height: receive the dimensions of the image in pixels
+ * Returns:   The number of bytes of the header, or 0 if bytes does not
+ *            start with the header of the fixed size format
+ * Effect:    No stdio is used
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+size_t Codewords_File_parse_header(const unsigned char *bytes, size_t length,
+                                   unsigned *width, unsigned *height);
+
+/* FUNCTION:  Codewords_File_load
+ * Purpose:   Loads the codewords of a compressed image in memory
+ * Arg:       bytes: the codewords, just after the header
+ *            width, height: the dimensions of the image from the header
+ * Returns:   Pointer to a UArray2 of width/2 by height/2 codewords
+ * Effect:    Reads Codewords_File_bytes(width, height) minus the header;
+ *            no stdio is used
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+UArray2_T Codewords_File_load(const unsigned char *bytes, unsigned width,
+                              unsigned height);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,433 @@
+/*****************************************************************************
+ *
+ *                              Codewords_rANS.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Codewords_rANS module. It is
+ *     a byte-wise rANS coder with a 32 bit state and 12 bit probabilities.
+ *     Compression makes two passes over the codewords: the first counts the
+ *     symbols of each model and the second codes them. rANS decodes in the
+ *     opposite order to encoding, so the encoder walks the blocks (and the
+ *     fields of each block) backwards and fills its buffer from the end.
+ *
+ *****************************************************************************/
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "Codewords_rANS.h"
+#include "Bitpack_inline.h"
+
+/* the three models and the number of symbols of each */
+enum { MODEL_A, MODEL_BCD, MODEL_CHROMA, MODELS };
+static const int model_symbols[MODELS] = {
+        1 << A_WIDTH, 1 << BCD_WIDTH, 1 << AVG_PBPR_WIDTH
+};
+
+/* largest number of symbols of any model */
+#define MAX_SYMBOLS 64
+
+/* the frequencies of a model add up to 1 << PROB_BITS */
+#define PROB_BITS 12
+#define PROB_SCALE (1u << PROB_BITS)
+
+/* lower bound of the normalized state */
+#define RANS_L (1u << 23)
+
+/* fields coded per block, and the largest number of bytes one field can
+   add to the stream (a field with frequency 1 costs PROB_BITS bits) */
+#define FIELDS 6
+#define MAX_FIELD_BYTES 2
+
+/*
+ * freq:   frequency of each symbol; they add up to PROB_SCALE
+ * start:  sum of the frequencies of the symbols before each symbol
+ * symbol: the symbol of each of the PROB_SCALE slots (decoding only)
+ */
+struct Model {
+        uint32_t freq[MAX_SYMBOLS];
+        uint32_t start[MAX_SYMBOLS];
+        unsigned char symbol[PROB_SCALE];
+};
+
+/*
+ * the fields of one block as coded: the model and symbol of each, in the
+ * order the decoder reads them
+ */
+struct Fields {
+        int model[FIELDS];
+        unsigned symbol[FIELDS];
+};
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static struct Fields block_fields(const uint64_t *row, int col);
+static void          normalize(const uint32_t *counts, int nsymbols,
+                               uint32_t *freq);
+static void          build_model(struct Model *model, int nsymbols);
+static void          put_u32(uint32_t value, unsigned char *bytes);
+static uint32_t      get_u32(const unsigned char *bytes);
+static uint64_t      pack_fields(const unsigned *fields, uint64_t left);
+
+/* FUNCTION:  Codewords_rANS_write
+ * Purpose:   Entropy codes a UArray2 of codewords to a file
+ * Arg:       codewords: pointer to a UArray2 of codewords
+ *            file: pointer to a file open for writing
+ * Returns:   N/A
+ * Effect:    Writes the header, models and stream; recycles the codewords
+ * Error:     Runtime error if a NULL pointer is passed in or if memory
+ *            cannot be allocated or the write fails
+ */
+void Codewords_rANS_write(UArray2_T codewords, FILE *file)
+{
+        assert(codewords != NULL);
+        assert(file != NULL);
+
+        int width = UArray2_width(codewords);
+        int height = UArray2_height(codewords);
+        size_t nblocks = (size_t)width * height;
+
+        /* first pass: count the symbols of each model */
+        uint32_t counts[MODELS][MAX_SYMBOLS];
+        memset(counts, 0, sizeof(counts));
+        int row, col, i;
+        for (row = 0; width > 0 && row < height; row++) {
+                const uint64_t *words = UARRAY2_ROW(uint64_t, codewords, row);
+                for (col = 0; col < width; col++) {
+                        struct Fields fields = block_fields(words, col);
+                        for (i = 0; i < FIELDS; i++) {
+                                counts[fields.model[i]][fields.symbol[i]]++;
+                        }
+                }
+        }
+
+        struct Model *models = malloc(MODELS * sizeof(*models));
+        assert(models != NULL);
+        int m;
+        for (m = 0; m < MODELS; m++) {
+                normalize(counts[m], model_symbols[m], models[m].freq);
+                build_model(&models[m], model_symbols[m]);
+        }
+
+        /* second pass: code the blocks backwards, filling the buffer from
+           its end */
+        size_t capacity = nblocks * FIELDS * MAX_FIELD_BYTES + 4;
+        unsigned char *buffer = malloc(capacity);
+        assert(buffer != NULL);
+        unsigned char *ptr = buffer + capacity;
+        uint32_t state = RANS_L;
+
+        for (row = height - 1; width > 0 && row >= 0; row--) {
+                const uint64_t *words = UARRAY2_ROW(uint64_t, codewords, row);
+                for (col = width - 1; col >= 0; col--) {
+                        struct Fields fields = block_fields(words, col);
+                        for (i = FIELDS - 1; i >= 0; i--) {
+                                const struct Model *model =
+                                        &models[fields.model[i]];
+                                uint32_t freq = model->freq[fields.symbol[i]];
+                                uint32_t start =
+                                        model->start[fields.symbol[i]];
+
+                                /* renormalize so the state stays in range
+                                   after the symbol is added */
+                                uint32_t x_max =
+                                        ((RANS_L >> PROB_BITS) << 8) * freq;
+                                while (state >= x_max) {
+                                        *--ptr = state & 0xff;
+                                        state >>= 8;
+                                }
+                                state = ((state / freq) << PROB_BITS) +
+                                        (state % freq) + start;
+                        }
+                }
+        }
+        ptr -= 4;
+        put_u32(state, ptr);
+        assert(ptr >= buffer);
+
+        /* header, models, stream length and stream */
+        fprintf(file, "COMP40 Compressed image format %d\n%u %u\n",
+                CODEWORDS_RANS_FORMAT, width * 2, height * 2);
+        for (m = 0; m < MODELS; m++) {
+                for (i = 0; i < model_symbols[m]; i++) {
+                        putc(models[m].freq[i] >> 8, file);
+                        putc(models[m].freq[i] & 0xff, file);
+                }
+        }
+        size_t length = buffer + capacity - ptr;
+        unsigned char length_bytes[4];
+        put_u32(length, length_bytes);
+        size_t written = fwrite(length_bytes, 1, 4, file);
+        written += fwrite(ptr, 1, length, file);
+        assert(written == length + 4);
+
+        free(buffer);
+        free(models);
+        UArray2_free(&codewords);
+}
+
+/* FUNCTION:  Codewords_rANS_read
+ * Purpose:   Decodes the codewords of an entropy coded image
+ * Arg:       file: pointer to a file instance, just after the header
+ *            width, height: the dimensions of the image from the header
+ * Returns:   Pointer to a UArray2 of width / 2 by height / 2 codewords
+ * Effect:    Reads the models and the stream
+ * Error:     Runtime error if a NULL pointer is passed in, if a model is
+ *            malformed, or if the file ends before the stream does
+ */
+UArray2_T Codewords_rANS_read(FILE *file, unsigned width, unsigned height)
+{
+        assert(file != NULL);
+
+        struct Model *models = malloc(MODELS * sizeof(*models));
+        assert(models != NULL);
+        int m, i;
+        for (m = 0; m < MODELS; m++) {
+                unsigned char bytes[2 * MAX_SYMBOLS];
+                size_t got = fread(bytes, 2, model_symbols[m], file);
+                assert(got == (size_t)model_symbols[m]);
+                for (i = 0; i < model_symbols[m]; i++) {
+                        models[m].freq[i] = (bytes[2 * i] << 8) |
+                                            bytes[2 * i + 1];
+                }
+                build_model(&models[m], model_symbols[m]);
+        }
+
+        unsigned char length_bytes[4];
+        size_t got = fread(length_bytes, 1, 4, file);
+        assert(got == 4);
+        uint32_t length = get_u32(length_bytes);
+        assert(length >= 4);
+        unsigned char *stream = malloc(length);
+        assert(stream != NULL);
+        got = fread(stream, 1, length, file);
+        assert(got == length);
+
+        const unsigned char *ptr = stream + 4;
+        const unsigned char *end = stream + length;
+        uint32_t state = get_u32(stream);
+
+        int cols = width / 2;
+        int rows = height / 2;
+        UArray2_T codewords = UArray2_new(cols, rows, sizeof(uint64_t));
+
+        /* the order of the models of the fields of a block */
+        static const int field_model[FIELDS] = {
+                MODEL_A, MODEL_BCD, MODEL_BCD, MODEL_BCD, MODEL_CHROMA,
+                MODEL_CHROMA
+        };
+
+        int row, col;
+        for (row = 0; cols > 0 && row < rows; row++) {
+                uint64_t *words = UARRAY2_ROW(uint64_t, codewords, row);
+                uint64_t left = 0;
+                for (col = 0; col < cols; col++) {
+                        unsigned fields[FIELDS];
+                        for (i = 0; i < FIELDS; i++) {
+                                const struct Model *model =
+                                        &models[field_model[i]];
+                                uint32_t slot = state & (PROB_SCALE - 1);
+                                unsigned symbol = model->symbol[slot];
+                                fields[i] = symbol;
+
+                                state = model->freq[symbol] *
+                                        (state >> PROB_BITS) + slot -
+                                        model->start[symbol];
+                                while (state < RANS_L) {
+                                        assert(ptr < end);
+                                        state = (state << 8) | *ptr++;
+                                }
+                        }
+                        left = pack_fields(fields, left);
+                        words[col] = left;
+                }
+        }
+
+        free(stream);
+        free(models);
+
+        return codewords;
+}
+
+/* FUNCTION:  block_fields
+ * Purpose:   Splits a codeword into the symbols that are coded
+ * Arg:       row: a row of codewords
+ *            col: the index of the block in the row
+ * Returns:   The model and symbol of each field, in decoding order: a, b,
+ *            c, d, avgPb, avgPr. a, avgPb and avgPr are the difference from
+ *            the block to the left (0 for the first block of a row), modulo
+ *            the size of their field; b, c and d are their raw bits
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static struct Fields block_fields(const uint64_t *row, int col)
+{
+        uint64_t word = row[col];
+        uint64_t left = col > 0 ? row[col - 1] : 0;
+        struct Fields fields;
+
+        fields.model[0] = MODEL_A;
+        fields.symbol[0] = (Bitpack_inline_getu(word, A_WIDTH, A_LSB) -
+                            Bitpack_inline_getu(left, A_WIDTH, A_LSB)) &
+                           ((1u << A_WIDTH) - 1);
+        fields.model[1] = MODEL_BCD;
+        fields.symbol[1] = Bitpack_inline_getu(word, BCD_WIDTH, B_LSB);
+        fields.model[2] = MODEL_BCD;
+        fields.symbol[2] = Bitpack_inline_getu(word, BCD_WIDTH, C_LSB);
+        fields.model[3] = MODEL_BCD;
+        fields.symbol[3] = Bitpack_inline_getu(word, BCD_WIDTH, D_LSB);
+        fields.model[4] = MODEL_CHROMA;
+        fields.symbol[4] = (Bitpack_inline_getu(word, AVG_PBPR_WIDTH,
+                                                AVGPB_LSB) -
+                            Bitpack_inline_getu(left, AVG_PBPR_WIDTH,
+                                                AVGPB_LSB)) &
+                           ((1u << AVG_PBPR_WIDTH) - 1);
+        fields.model[5] = MODEL_CHROMA;
+        fields.symbol[5] = (Bitpack_inline_getu(word, AVG_PBPR_WIDTH,
+                                                AVGPR_LSB) -
+                            Bitpack_inline_getu(left, AVG_PBPR_WIDTH,
+                                                AVGPR_LSB)) &
+                           ((1u << AVG_PBPR_WIDTH) - 1);
+
+        return fields;
+}
+
+/* FUNCTION:  pack_fields
+ * Purpose:   Rebuilds a codeword from its decoded symbols
+ * Arg:       fields: the symbols in decoding order (see block_fields)
+ *            left: the codeword of the block to the left, or 0
+ * Returns:   The codeword
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static uint64_t pack_fields(const unsigned *fields, uint64_t left)
+{
+        uint64_t word = 0;
+
+        word = Bitpack_inline_newu(word, A_WIDTH, A_LSB, fields[0] +
+                        Bitpack_inline_getu(left, A_WIDTH, A_LSB));
+        word = Bitpack_inline_newu(word, BCD_WIDTH, B_LSB, fields[1]);
+        word = Bitpack_inline_newu(word, BCD_WIDTH, C_LSB, fields[2]);
+        word = Bitpack_inline_newu(word, BCD_WIDTH, D_LSB, fields[3]);
+        word = Bitpack_inline_newu(word, AVG_PBPR_WIDTH, AVGPB_LSB,
+                        fields[4] + Bitpack_inline_getu(left, AVG_PBPR_WIDTH,
+                                                        AVGPB_LSB));
+        word = Bitpack_inline_newu(word, AVG_PBPR_WIDTH, AVGPR_LSB,
+                        fields[5] + Bitpack_inline_getu(left, AVG_PBPR_WIDTH,
+                                                        AVGPR_LSB));
+
+        return word;
+}
+
+/* FUNCTION:  normalize
+ * Purpose:   Scales the symbol counts of a model to frequencies that add up
+ *            to PROB_SCALE
+ * Arg:       counts: the count of each symbol
+ *            nsymbols: the number of symbols
+ *            freq: receives the frequency of each symbol
+ * Returns:   N/A
+ * Effect:    Every symbol that occurs keeps a frequency of at least 1; a
+ *            model with no symbols at all gives everything to symbol 0
+ * Error:     N/A
+ */
+static void normalize(const uint32_t *counts, int nsymbols, uint32_t *freq)
+{
+        uint64_t total = 0;
+        int s;
+        for (s = 0; s < nsymbols; s++) {
+                total += counts[s];
+        }
+
+        uint32_t sum = 0;
+        for (s = 0; s < nsymbols; s++) {
+                freq[s] = total == 0 ? 0 :
+                          (uint64_t)counts[s] * PROB_SCALE / total;
+                if (counts[s] > 0 && freq[s] == 0) {
+                        freq[s] = 1;
+                }
+                sum += freq[s];
+        }
+        if (total == 0) {
+                freq[0] = PROB_SCALE;
+                return;
+        }
+
+        /* rounding leaves the sum off by at most nsymbols; the difference
+           goes to (or comes from) the most frequent symbol */
+        while (sum != PROB_SCALE) {
+                int largest = 0;
+                for (s = 1; s < nsymbols; s++) {
+                        if (freq[s] > freq[largest]) {
+                                largest = s;
+                        }
+                }
+                if (sum < PROB_SCALE) {
+                        freq[largest] += PROB_SCALE - sum;
+                        sum = PROB_SCALE;
+                } else {
+                        uint32_t take = sum - PROB_SCALE;
+                        if (take > freq[largest] - 1) {
+                                take = freq[largest] - 1;
+                        }
+                        freq[largest] -= take;
+                        sum -= take;
+                }
+        }
+}
+
+/* FUNCTION:  build_model
+ * Purpose:   Fills in the starts and the slot table of a model from its
+ *            frequencies
+ * Arg:       model: a model whose freq has been set
+ *            nsymbols: the number of symbols
+ * Returns:   N/A
+ * Effect:    Sets model->start and model->symbol
+ * Error:     Runtime error if the frequencies do not add up to PROB_SCALE
+ */
+static void build_model(struct Model *model, int nsymbols)
+{
+        uint32_t start = 0;
+        int s;
+        for (s = 0; s < nsymbols; s++) {
+                assert(model->freq[s] <= PROB_SCALE - start);
+                model->start[s] = start;
+                memset(model->symbol + start, s, model->freq[s]);
+                start += model->freq[s];
+        }
+        assert(start == PROB_SCALE);
+}
+
+/* FUNCTION:  put_u32
+ * Purpose:   Stores a 32 bit value, most significant byte first
+ * Arg:       value: the value
+ *            bytes: receives 4 bytes
+ * Returns:   N/A
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static void put_u32(uint32_t value, unsigned char *bytes)
+{
+        bytes[0] = value >> 24;
+        bytes[1] = value >> 16;
+        bytes[2] = value >> 8;
+        bytes[3] = value;
+}
+
+/* FUNCTION:  get_u32
+ * Purpose:   Loads a 32 bit value stored most significant byte first
+ * Arg:       bytes: 4 bytes
+ * Returns:   The value
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static uint32_t get_u32(const unsigned char *bytes)
+{
+        return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) |
+               ((uint32_t)bytes[2] << 8) | bytes[3];
+}
@@ -0,0 +1,58 @@
+/*****************************************************************************
+ *
+ *                              Codewords_rANS.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Codewords_rANS module. The purpose
+ *     of this module is an entropy coded alternative to the fixed size
+ *     codewords of Codewords_File (40image -c --entropy). Each codeword is
+ *     split back into its fields and the fields are coded with rANS (range
+ *     asymmetric numeral systems) using three models that are fitted to
+ *     each image: one for a, one shared by b, c and d, and one shared by
+ *     avgPb and avgPr. a, avgPb and avgPr are coded as the difference from
+ *     the block to their left, so smooth regions cost a few bits per block.
+ *
+ *     The file starts with the header
+ *         COMP40 Compressed image format 3\n<width> <height>\n
+ *     followed by the frequency tables of the three models (16 bits each,
+ *     most significant byte first), the length in bytes of the rANS stream
+ *     (32 bits) and the stream. Decoding is table driven: the symbol of
+ *     every slot of each model is precomputed.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include "uarray2.h"
+
+#ifndef CODEWORDSRANS_INCLUDED
+#define CODEWORDSRANS_INCLUDED
+
+/* format number in the header of an entropy coded image */
+#define CODEWORDS_RANS_FORMAT 3
+
+/* FUNCTION:  Codewords_rANS_write
+ * Purpose:   Entropy codes a UArray2 of codewords to a file
+ * Arg:       codewords: pointer to a UArray2 of codewords
+ *            file: pointer to a file open for writing
+ * Returns:   N/A
+ * Effect:    Writes the header, models and stream; recycles the codewords
+ * Error:     Runtime error if a NULL pointer is passed in or if memory
+ *            cannot be allocated or the write fails
+ */
+void Codewords_rANS_write(UArray2_T codewords, FILE *file);
+
+/* FUNCTION:  Codewords_rANS_read
+ * Purpose:   Decodes the codewords of an entropy coded image
+ * Arg:       file: pointer to a file instance, just after the header
+ *            width, height: the dimensions of the image from the header
+ * Returns:   Pointer to a UArray2 of width / 2 by height / 2 codewords
+ * Effect:    Reads the models and the stream
+ * Error:     Runtime error if a NULL pointer is passed in, if a model is
+ *            malformed, or if the file ends before the stream does
+ */
+UArray2_T Codewords_rANS_read(FILE *file, unsigned width, unsigned height);
+
+#endif
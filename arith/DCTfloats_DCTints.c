@@ -8,16 +8,16 @@
  *
  *     Summary:
  *     This is the private implementation of our DCTfloats_DCTints module. The
- *     purpose of this module is to convert between a UArray2 of DCT (discrete
- *     cosine transformation) floats and a UArray2 scaled DCT ints. This module
- *     contains two public functions, one that takes in a UArray2 of DCT float
- *     values and returns a UArray2 of DCT scaled int values, and one that 
- *     takes in a UArray2 of DCT scaled int values and returns a UArray2 of DCT
- *     float values. Both these functions rely on mapping private apply
- *     functions over the respective UArray2s to convert between the different
- *     values. In compression, data is lost when mapping a float value to a
- *     specific int in our scale. More data is lost when compressing
- *     extreme DCT float values due to rounding.
+ *     purpose of this module is to convert between a planar image of DCT 
+ *     (discrete cosine transformation) floats and a UArray2 of scaled DCT 
+ *     ints. This module contains two public functions, one that takes the
+ *     planes of DCT floats and returns a UArray2 of DCT scaled int values, 
+ *     and one that takes a UArray2 of DCT scaled int values and returns the
+ *     planes of DCT floats, and a third that decodes a thumbnail straight 
+ *     from the codewords. The functions walk each row through row pointers
+ *     and convert one block at a time. In compression, data is lost when 
+ *     mapping a float value to a specific int in our scale. More data is 
+ *     lost when compressing extreme DCT float values due to rounding.
  *     
  *
  *****************************************************************************/
@@ -27,7 +27,9 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include "DCTfloats_DCTints.h"
-#include "arith40.h"
+#include "SIMD_kernels.h"
+#include "Chroma_quant.h"
+#include "Bitpack_inline.h"
 
 /* this is the struct definition for the DCT_floats struct */
 #include "DCT_floats.h"
@@ -38,150 +40,146 @@
  * private helper functions, functions details are included in the function
  * contracts respectively
  */
-static void              to_dctints_apply(int col, int row, UArray2_T array2,
-                                          void *val, void *dctfloats_ua2);
-static void              to_dctfloats_apply(int col, int row, UArray2_T array2,
-                                            void *val, void *dctints_ua2);
 static struct DCT_floats DCT_ints_to_floats(struct DCT_ints dct_ints);
-static struct DCT_ints   DCT_floats_to_ints(struct DCT_floats dct_floats);
 static unsigned          scale_a(float a);
 static float             unscale_a(unsigned a);
 static int               scale_bcd(float bcd);
 static float             unscale_bcd(int bcd);
 
-/* FUNCTION:  DCTfloats_ints_compress
- * Purpose:   Converts a UArray2 of DCT floats to a UArray2 of DCT scaled ints
- * Arg:       dct_floats: pointer to an instance of UArray2 that stores the 
- *                        DCT floats values
+/* FUNCTION:  DCTfloats_ints_compress_planar
+ * Purpose:   Converts the planes of DCT floats to DCT scaled ints
+ * Arg:       dct_floats: a planar image with avgPb, avgPr, a, b, c and d
+ *                        planes
  * Returns:   Pointer to an UArray2 that stores the DCT scaled int values
- * Effect:    initializes a new UArray2 and recycles the dct_floats UArray2
+ * Effect:    initializes a new UArray2 and recycles the DCT floats
  * Error:     Runtime error if a NULL pointer is passed in
  */
-UArray2_T DCTfloats_ints_compress(UArray2_T dct_floats)
+UArray2_T DCTfloats_ints_compress_planar(Planar_T dct_floats)
 {
         assert(dct_floats != NULL);
-        
-        /* initialize an uarray2 of DCT_ints structs */
-        unsigned width = UArray2_width(dct_floats);
-        unsigned height = UArray2_height(dct_floats);
+
+        int width = Planar_width(dct_floats);
+        int height = Planar_height(dct_floats);
         unsigned size = sizeof(struct DCT_ints);
         UArray2_T dct_ints = UArray2_new(width, height, size);
 
-        UArray2_map_row_major(dct_floats, to_dctints_apply, dct_ints);
+        /* chroma codes of a row, quantized a whole row at a time */
+        unsigned *pb_codes = malloc((width + 1) * sizeof(*pb_codes));
+        unsigned *pr_codes = malloc((width + 1) * sizeof(*pr_codes));
+        assert(pb_codes != NULL && pr_codes != NULL);
+
+        int row, col, i;
+        for (row = 0; width > 0 && row < height; row++) {
+                struct DCT_ints *ints = UArray2_row(dct_ints, row);
+                const float *dct[6];
+                for (i = 0; i < 6; i++) {
+                        dct[i] = Planar_row(dct_floats, i, row);
+                }
+
+                Chroma_quant_index_row(dct[SIMD_AVGPB], pb_codes, width);
+                Chroma_quant_index_row(dct[SIMD_AVGPR], pr_codes, width);
+
+                for (col = 0; col < width; col++) {
+                        ints[col].avgPb = pb_codes[col];
+                        ints[col].avgPr = pr_codes[col];
+                        ints[col].a = scale_a(dct[SIMD_A][col]);
+                        ints[col].b = scale_bcd(dct[SIMD_B][col]);
+                        ints[col].c = scale_bcd(dct[SIMD_C][col]);
+                        ints[col].d = scale_bcd(dct[SIMD_D][col]);
+                }
+        }
+
+        free(pb_codes);
+        free(pr_codes);
+        Planar_free(&dct_floats);
 
-        UArray2_free(&dct_floats);
-        
         return dct_ints;
 }
 
-/* FUNCTION:  DCTfloats_ints_decompress
- * Purpose:   Converts a UArray2 of DCT scaled int to a UArray2 of DCT floats
+/* FUNCTION:  DCTfloats_ints_decompress_planar
+ * Purpose:   Converts DCT scaled ints to planes of DCT floats
  * Arg:       dct_ints: pointer to an instance of UArray2 that stores the 
  *                      DCT scaled ints
- * Returns:   Pointer to an UArray2 that stores the DCT floats values
- * Effect:    initializes a new UArray2 and recycles the dct_ints UArray2
+ * Returns:   A planar image with avgPb, avgPr, a, b, c and d planes
+ * Effect:    initializes a new Planar_T and recycles the dct_ints UArray2
  * Error:     Runtime error if a NULL pointer is passed in
  */
-UArray2_T DCTfloats_ints_decompress(UArray2_T dct_ints)
+Planar_T DCTfloats_ints_decompress_planar(UArray2_T dct_ints)
 {
         assert(dct_ints != NULL);
 
-        /* initialize an uarray2 of DCT_floats structs */
-        unsigned width = UArray2_width(dct_ints);
-        unsigned height = UArray2_height(dct_ints);
-        unsigned size = sizeof(struct DCT_floats);
-        UArray2_T dct_floats = UArray2_new(width, height, size);
+        int width = UArray2_width(dct_ints);
+        int height = UArray2_height(dct_ints);
+        Planar_T dct_floats = Planar_new(width, height, 6);
 
-        UArray2_map_row_major(dct_ints, to_dctfloats_apply, dct_floats);
+        int row, col, i;
+        for (row = 0; width > 0 && row < height; row++) {
+                struct DCT_ints *ints = UArray2_row(dct_ints, row);
+                float *dct[6];
+                for (i = 0; i < 6; i++) {
+                        dct[i] = Planar_row(dct_floats, i, row);
+                }
 
-        UArray2_free(&dct_ints);
-        
-        return dct_floats;
-}
+                for (col = 0; col < width; col++) {
+                        struct DCT_floats floats = 
+                                DCT_ints_to_floats(ints[col]);
 
-/* FUNCTION:  to_dctints_apply
- * Purpose:   For each element in the UArray2 of DCT_floats, convert each 
- *            DCT_floats struct into a DCT_ints struct, and add them to the
- *            UArray2 of DCT_ints
- * Arg:       col: a int representing the current column in the array
- *            row: a row representing the current row in the array
- *            array2: pointer to a UArray2 of DCT_floats (unused)
- *            val: pointer to the current pixel containing a DCT_floats struct
- *            dct_ints_ua2: pointer to the UArray2 of DCT_ints
- * Returns:   N/A
- * Effect:    Calls a private helper function that converts a DCT_floats struct
- *            to a DCT_ints struct and adds it to the UArray2 of DCT_ints 
- * Error:     N/A
- */
-static void to_dctints_apply(int col, int row, UArray2_T array2, void *val, 
-                             void *dct_ints_ua2)
-{
-        struct DCT_floats *dct_floats = val;
+                        dct[SIMD_AVGPB][col] = floats.avgPb;
+                        dct[SIMD_AVGPR][col] = floats.avgPr;
+                        dct[SIMD_A][col] = floats.a;
+                        dct[SIMD_B][col] = floats.b;
+                        dct[SIMD_C][col] = floats.c;
+                        dct[SIMD_D][col] = floats.d;
+                }
+        }
 
-        /* converts a DCT_floats struct to a DCT_ints struct using a private
-           helper function */
-        struct DCT_ints dct_ints = DCT_floats_to_ints(*dct_floats);
-        
-        /* store a DCT_ints to the UArray2 of DCT_ints at the respective
-           column and row indices */
-        *(struct DCT_ints *)(UArray2_at(dct_ints_ua2, col, row)) = dct_ints;
+        UArray2_free(&dct_ints);
 
-        (void) array2;
+        return dct_floats;
 }
 
-/* FUNCTION:  to_dctfloats_apply
- * Purpose:   For each element in the UArray2 of DCT_ints, convert each 
- *            DCT_ints struct into a DCT_floats struct, and add them to the
- *            UArray2 of DCT floats
- * Arg:       col: a int representing the current column in the array
- *            row: a row representing the current row in the array
- *            array2: pointer to a UArray2 of DCT_ints (unused)
- *            val: pointer to the current pixel containing a DCT_int struct
- *            dct_floats_ua2: pointer to the UArray2 of DCT floats
- * Returns:   N/A
- * Effect:    Calls a private helper function that converts a DCT_ints struct
- *            to a DCT_float struct, and adds it to the UArray2 of DCT_floats 
- * Error:     N/A
+/* FUNCTION:  DCTfloats_ints_thumbnail
+ * Purpose:   Converts a UArray2 of codewords straight to a half size image
+ *            of CV colors, one pixel per 2 by 2 block
+ * Arg:       codewords: pointer to an instance of UArray2 that stores the 
+ *                       codewords
+ * Returns:   A planar image with y, pb and pr planes (in the order of 
+ *            SIMD_kernels.h) and the dimensions of codewords
+ * Effect:    Only the a, avgPb and avgPr fields of each codeword are
+ *            unpacked: a is the average luma of the block, so the pixel is
+ *            the average of the 4 pixels a full decode would give, with no
+ *            inverse DCT. Recycles the codewords UArray2
+ * Error:     Runtime error if a NULL pointer is passed in
  */
-static void to_dctfloats_apply(int col, int row, UArray2_T array2, void *val,
-                               void *dct_floats_ua2)
+Planar_T DCTfloats_ints_thumbnail(UArray2_T codewords)
 {
-        struct DCT_ints *dct_ints = val;
+        assert(codewords != NULL);
 
-        /* converts a DCT_ints struct to a DCT_floats struct using a private
-           helper function */
-        struct DCT_floats dct_floats = DCT_ints_to_floats(*dct_ints);
-        
-        /* store a DCT_floats to the UArray2 of DCT_floats at the respective
-           column and row indices */
-        *(struct DCT_floats *)(UArray2_at(dct_floats_ua2, col, row)) 
-                = dct_floats;
+        int width = UArray2_width(codewords);
+        int height = UArray2_height(codewords);
+        Planar_T cv_colors = Planar_new(width, height, 3);
 
-        (void) array2;
-}
+        int row, col;
+        for (row = 0; width > 0 && row < height; row++) {
+                const uint64_t *words = UARRAY2_ROW(uint64_t, codewords, row);
+                float *y = Planar_row(cv_colors, SIMD_Y, row);
+                float *pb = Planar_row(cv_colors, SIMD_PB, row);
+                float *pr = Planar_row(cv_colors, SIMD_PR, row);
 
-/* FUNCTION:  DCT_floats_to_ints
- * Purpose:   Convert an instance of DCT floats to DCT scaled ints using our
- *            private helper functions
- * Arg:       dct_floats: an instance of a DCT_floats struct 
- * Returns:   An instance of a DCT_ints struct
- * Effect:    N/A
- * Error:     N/A
- */
-static struct DCT_ints DCT_floats_to_ints(struct DCT_floats dct_floats)
-{
-        struct DCT_ints dct_ints;
+                for (col = 0; col < width; col++) {
+                        uint64_t word = words[col];
+                        y[col] = unscale_a(Bitpack_inline_getu(word, A_WIDTH,
+                                                               A_LSB));
+                        pb[col] = Chroma_quant_chroma(Bitpack_inline_getu(
+                                        word, AVG_PBPR_WIDTH, AVGPB_LSB));
+                        pr[col] = Chroma_quant_chroma(Bitpack_inline_getu(
+                                        word, AVG_PBPR_WIDTH, AVGPR_LSB));
+                }
+        }
 
-        /* initialize the DCT_ints struct by computing each of its field using
-           private helper functions */
-        dct_ints.avgPb = Arith40_index_of_chroma(dct_floats.avgPb);
-        dct_ints.avgPr = Arith40_index_of_chroma(dct_floats.avgPr);
-        dct_ints.a = scale_a(dct_floats.a);
-        dct_ints.b = scale_bcd(dct_floats.b);
-        dct_ints.c = scale_bcd(dct_floats.c);
-        dct_ints.d = scale_bcd(dct_floats.d);
+        UArray2_free(&codewords);
 
-        return dct_ints;
+        return cv_colors;
 }
 
 /* FUNCTION:  DCT_ints_to_floats
@@ -198,8 +196,8 @@ static struct DCT_floats DCT_ints_to_floats(struct DCT_ints dct_ints)
         
         /* initialize the DCT_floats struct by computing each of its field 
            using private helper functions */
-        dct_floats.avgPb = Arith40_chroma_of_index(dct_ints.avgPb);
-        dct_floats.avgPr = Arith40_chroma_of_index(dct_ints.avgPr);
+        dct_floats.avgPb = Chroma_quant_chroma(dct_ints.avgPb);
+        dct_floats.avgPr = Chroma_quant_chroma(dct_ints.avgPr);
         dct_floats.a = unscale_a(dct_ints.a);
         dct_floats.b = unscale_bcd(dct_ints.b);
         dct_floats.c = unscale_bcd(dct_ints.c);
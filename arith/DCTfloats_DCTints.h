@@ -8,40 +8,57 @@
  *
  *     Summary:
  *     This is the public interface of our DCTfloats_DCTints module. The
- *     purpose of this module is to convert between a UArray2 of DCT (discrete
- *     cosine transformation) floats and a UArray2 scaled DCT ints. This module
- *     contains two public functions, one that takes in a UArray2 of DCT float
- *     values and returns a UArray2 of DCT scaled int values, and one that 
- *     takes in a UArray2 of DCT scaled int values and returns a UArray2 of DCT
- *     float values. In compression, data is lost when mapping a float value to
- *     a specific int in our scale. More data is lost when compressing
- *     extreme DCT float values due to rounding.
+ *     purpose of this module is to convert between a planar image of DCT 
+ *     (discrete cosine transformation) floats and a UArray2 of scaled DCT 
+ *     ints. This module contains two public functions, one that takes the
+ *     planes of DCT floats and returns a UArray2 of DCT scaled int values, 
+ *     and one that takes a UArray2 of DCT scaled int values and returns the
+ *     planes of DCT floats, and a third that decodes a thumbnail straight 
+ *     from the codewords. In compression, data is lost when mapping a float
+ *     value to a specific int in our scale. More data is lost when 
+ *     compressing extreme DCT float values due to rounding.
  *     
  *
  *****************************************************************************/
 #include "uarray2.h"
+#include "Planar.h"
 
 #ifndef DCTFLOATSDCTINTS_INCLUDED
 #define DCTFLOATSDCTINTS_INCLUDED
 
-/* FUNCTION:  DCTfloats_ints_compress
- * Purpose:   Converts a UArray2 of DCT floats to a UArray2 of DCT scaled ints
- * Arg:       dct_floats: pointer to an instance of UArray2 that stores the 
- *                        DCT floats values
+/* FUNCTION:  DCTfloats_ints_compress_planar
+ * Purpose:   Converts the planes of DCT floats to DCT scaled ints
+ * Arg:       dct_floats: a planar image with avgPb, avgPr, a, b, c and d
+ *                        planes
  * Returns:   Pointer to an UArray2 that stores the DCT scaled int values
- * Effect:    initializes a new UArray2 and recycles the dct_floats UArray2
+ * Effect:    initializes a new UArray2 and recycles the DCT floats
  * Error:     Runtime error if a NULL pointer is passed in
  */
-UArray2_T DCTfloats_ints_compress(UArray2_T dct_floats);
+UArray2_T DCTfloats_ints_compress_planar(Planar_T dct_floats);
 
-/* FUNCTION:  DCTfloats_ints_decompress
- * Purpose:   Converts a UArray2 of DCT scaled int to a UArray2 of DCT floats
+/* FUNCTION:  DCTfloats_ints_decompress_planar
+ * Purpose:   Converts DCT scaled ints to planes of DCT floats
  * Arg:       dct_ints: pointer to an instance of UArray2 that stores the 
  *                      DCT scaled ints
- * Returns:   Pointer to an UArray2 that stores the DCT floats values
- * Effect:    initializes a new UArray2 and recycles the dct_ints UArray2
+ * Returns:   A planar image with avgPb, avgPr, a, b, c and d planes
+ * Effect:    initializes a new Planar_T and recycles the dct_ints UArray2
  * Error:     Runtime error if a NULL pointer is passed in
  */
-UArray2_T DCTfloats_ints_decompress(UArray2_T dct_ints);
+Planar_T DCTfloats_ints_decompress_planar(UArray2_T dct_ints);
+
+/* FUNCTION:  DCTfloats_ints_thumbnail
+ * Purpose:   Converts a UArray2 of codewords straight to a half size image
+ *            of CV colors, one pixel per 2 by 2 block
+ * Arg:       codewords: pointer to an instance of UArray2 that stores the 
+ *                       codewords
+ * Returns:   A planar image with y, pb and pr planes (in the order of 
+ *            SIMD_kernels.h) and the dimensions of codewords
+ * Effect:    Only the a, avgPb and avgPr fields of each codeword are
+ *            unpacked: a is the average luma of the block, so the pixel is
+ *            the average of the 4 pixels a full decode would give, with no
+ *            inverse DCT. Recycles the codewords UArray2
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+Planar_T DCTfloats_ints_thumbnail(UArray2_T codewords);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,500 @@
+/*****************************************************************************
+ *
+ *                               Fixed_decode.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Fixed_decode module. A row
+ *     of codewords is first unpacked through the tables into 7 rows of 16
+ *     bit values (a, b, c, d and the red, green and blue offsets of each
+ *     block). A kernel then turns them into the upper and lower rows of
+ *     pixels, one row of bytes per channel, and the channels are interleaved
+ *     into the PPM row that is written. As in SIMD_kernels, the first call
+ *     picks the kernel for the CPU once; the integer kernels give the same
+ *     bytes whichever is picked.
+ *
+ *****************************************************************************/
+#include <assert.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
+#include "Fixed_decode.h"
+#include "Bitpack_inline.h"
+#include "Chroma_quant.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_AVX2_KERNELS 1
+#endif
+
+/* bits after the binary point, and one sample in fixed point */
+#define FRAC_BITS 5
+#define SAMPLE_MAX 255
+#define ONE (SAMPLE_MAX << FRAC_BITS)
+
+/* coefficients of the component video to RGB conversion, as in
+   SIMD_kernels.c */
+#define RED_PR    1.402
+#define GREEN_PB  0.344136
+#define GREEN_PR  0.714136
+#define BLUE_PB   1.772
+
+/* the rows of 16 bit values a row of codewords is unpacked into */
+enum { FIXED_A, FIXED_B, FIXED_C, FIXED_D, FIXED_RED, FIXED_GREEN,
+       FIXED_BLUE, FIXED_PLANES };
+
+/* the channels of a row of pixels */
+enum { CHANNEL_RED, CHANNEL_GREEN, CHANNEL_BLUE, CHANNELS };
+
+/*
+ * the fixed point value of every code of each field
+ * a:        indexed by the a field
+ * bcd:      indexed by the 6 raw bits of a b, c or d field
+ * red:      red offset, indexed by the avgPr field
+ * blue:     blue offset, indexed by the avgPb field
+ * green:    green offset, indexed by the avgPb and avgPr fields
+ */
+struct Fixed_tables {
+        int16_t a[1 << A_WIDTH];
+        int16_t bcd[1 << BCD_WIDTH];
+        int16_t red[CHROMA_CODES];
+        int16_t blue[CHROMA_CODES];
+        int16_t green[CHROMA_CODES][CHROMA_CODES];
+};
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static void    build_tables(struct Fixed_tables *tables);
+static int16_t to_fixed(double value);
+static void    unpack_row(const struct Fixed_tables *tables,
+                          const uint64_t *words, int16_t *const blocks[],
+                          int n);
+static void    blocks_to_rgb(const int16_t *const blocks[],
+                             unsigned char *const top[],
+                             unsigned char *const bottom[], int n);
+static void    choose_kernel(void);
+static void    blocks_to_rgb_scalar(const int16_t *const blocks[],
+                                    unsigned char *const top[],
+                                    unsigned char *const bottom[],
+                                    int first, int n);
+static unsigned char clamp_sample(int value);
+#ifdef __SSE2__
+static int     blocks_to_rgb_sse2(const int16_t *const blocks[],
+                                  unsigned char *const top[],
+                                  unsigned char *const bottom[], int n);
+#endif
+#ifdef HAVE_AVX2_KERNELS
+static int     blocks_to_rgb_avx2(const int16_t *const blocks[],
+                                  unsigned char *const top[],
+                                  unsigned char *const bottom[], int n);
+#endif
+
+/* chooses the kernel once for the whole program */
+static pthread_once_t chosen = PTHREAD_ONCE_INIT;
+static bool use_avx2 = false;
+
+/* FUNCTION:  Fixed_decode_write
+ * Purpose:   Decodes a rectangle of an image from its codewords and writes
+ *            it as a binary PPM with a maxval of 255
+ * Arg:       codewords: pointer to a UArray2 of codewords
+ *            col, row: the top left pixel of the rectangle
+ *            width, height: the size of the rectangle, in pixels
+ *            output: pointer to a file open for writing
+ * Returns:   N/A
+ * Effect:    Only the blocks that cover the rectangle are decoded, one row
+ *            of blocks at a time; recycles the codewords
+ * Error:     Runtime error if a NULL pointer is passed in, if the rectangle
+ *            is not inside the image, if memory cannot be allocated or if
+ *            the write fails
+ */
+void Fixed_decode_write(UArray2_T codewords, int col, int row, int width,
+                        int height, FILE *output)
+{
+        assert(codewords != NULL);
+        assert(output != NULL);
+        assert(col >= 0 && row >= 0 && width >= 0 && height >= 0);
+        assert(col + width <= 2 * UArray2_width(codewords));
+        assert(row + height <= 2 * UArray2_height(codewords));
+
+        fprintf(output, "P6\n%d %d\n%d\n", width, height, SAMPLE_MAX);
+        if (width == 0 || height == 0) {
+                UArray2_free(&codewords);
+                return;
+        }
+
+        struct Fixed_tables tables;
+        build_tables(&tables);
+
+        /* the blocks that cover the rectangle */
+        int first_col = col / 2;
+        int nblocks = (col + width - 1) / 2 - first_col + 1;
+        int first_row = row / 2;
+        int last_row = (row + height - 1) / 2;
+
+        int16_t *values = malloc(FIXED_PLANES * nblocks * sizeof(*values));
+        unsigned char *samples = malloc(2 * CHANNELS * 2 * nblocks);
+        unsigned char *line = malloc(3 * (size_t)width);
+        assert(values != NULL && samples != NULL && line != NULL);
+
+        int16_t *blocks[FIXED_PLANES];
+        unsigned char *top[CHANNELS], *bottom[CHANNELS];
+        int i;
+        for (i = 0; i < FIXED_PLANES; i++) {
+                blocks[i] = values + i * nblocks;
+        }
+        for (i = 0; i < CHANNELS; i++) {
+                top[i] = samples + i * 2 * nblocks;
+                bottom[i] = samples + (CHANNELS + i) * 2 * nblocks;
+        }
+
+        /* column of the first pixel of the rectangle in the decoded rows */
+        int skip = col - 2 * first_col;
+
+        int block_row;
+        for (block_row = first_row; block_row <= last_row; block_row++) {
+                const uint64_t *words = UARRAY2_ROW(uint64_t, codewords,
+                                                    block_row);
+                unpack_row(&tables, words + first_col, blocks, nblocks);
+                blocks_to_rgb((const int16_t *const *)blocks, top, bottom,
+                              nblocks);
+
+                int half;
+                for (half = 0; half < 2; half++) {
+                        int y = 2 * block_row + half;
+                        if (y < row || y >= row + height) {
+                                continue;
+                        }
+                        unsigned char *const *pixels = half ? bottom : top;
+                        int x;
+                        for (x = 0; x < width; x++) {
+                                line[3 * x] = pixels[CHANNEL_RED][skip + x];
+                                line[3 * x + 1] =
+                                        pixels[CHANNEL_GREEN][skip + x];
+                                line[3 * x + 2] =
+                                        pixels[CHANNEL_BLUE][skip + x];
+                        }
+                        size_t written = fwrite(line, 3, width, output);
+                        assert(written == (size_t)width);
+                }
+        }
+
+        free(line);
+        free(samples);
+        free(values);
+        UArray2_free(&codewords);
+}
+
+/* FUNCTION:  build_tables
+ * Purpose:   Computes the fixed point value of every code of every field
+ * Arg:       tables: receives the tables
+ * Returns:   N/A
+ * Effect:    The values match DCTfloats_DCTints and RGBfloats_CV: a is
+ *            a / A_MAX, b, c and d are clamped to +-BCD_INT_BOUND and
+ *            divided by BCD_SCALE_FACTOR, and the chroma fields go through
+ *            Chroma_quant_chroma before the color conversion
+ * Error:     N/A
+ */
+static void build_tables(struct Fixed_tables *tables)
+{
+        int code;
+        for (code = 0; code < (1 << A_WIDTH); code++) {
+                tables->a[code] = to_fixed((double)code / A_MAX);
+        }
+        for (code = 0; code < (1 << BCD_WIDTH); code++) {
+                int bcd = Bitpack_inline_gets(code, BCD_WIDTH, 0);
+                if (bcd < -BCD_INT_BOUND) {
+                        bcd = -BCD_INT_BOUND;
+                }
+                tables->bcd[code] = to_fixed(bcd / BCD_SCALE_FACTOR);
+        }
+
+        int pb, pr;
+        for (pr = 0; pr < CHROMA_CODES; pr++) {
+                tables->red[pr] = to_fixed(RED_PR * Chroma_quant_chroma(pr));
+                tables->blue[pr] =
+                        to_fixed(BLUE_PB * Chroma_quant_chroma(pr));
+        }
+        for (pb = 0; pb < CHROMA_CODES; pb++) {
+                for (pr = 0; pr < CHROMA_CODES; pr++) {
+                        tables->green[pb][pr] = to_fixed(
+                                -GREEN_PB * Chroma_quant_chroma(pb) -
+                                GREEN_PR * Chroma_quant_chroma(pr));
+                }
+        }
+}
+
+/* FUNCTION:  to_fixed
+ * Purpose:   Converts a value on the 0 to 1 scale to fixed point
+ * Arg:       value: the value
+ * Returns:   value * ONE, rounded to the nearest integer
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static int16_t to_fixed(double value)
+{
+        return (int16_t)lround(value * ONE);
+}
+
+/* FUNCTION:  unpack_row
+ * Purpose:   Looks up the fixed point values of a row of codewords
+ * Arg:       tables: the tables from build_tables
+ *            words: the n codewords
+ *            blocks: FIXED_PLANES rows that receive n values each
+ *            n: the number of codewords
+ * Returns:   N/A
+ * Effect:    Writes n values to each row of blocks
+ * Error:     N/A
+ */
+static void unpack_row(const struct Fixed_tables *tables,
+                       const uint64_t *words, int16_t *const blocks[], int n)
+{
+        int i;
+        for (i = 0; i < n; i++) {
+                uint64_t word = words[i];
+                unsigned pb = Bitpack_inline_getu(word, AVG_PBPR_WIDTH,
+                                                  AVGPB_LSB);
+                unsigned pr = Bitpack_inline_getu(word, AVG_PBPR_WIDTH,
+                                                  AVGPR_LSB);
+
+                blocks[FIXED_A][i] =
+                        tables->a[Bitpack_inline_getu(word, A_WIDTH, A_LSB)];
+                blocks[FIXED_B][i] = tables->bcd[
+                        Bitpack_inline_getu(word, BCD_WIDTH, B_LSB)];
+                blocks[FIXED_C][i] = tables->bcd[
+                        Bitpack_inline_getu(word, BCD_WIDTH, C_LSB)];
+                blocks[FIXED_D][i] = tables->bcd[
+                        Bitpack_inline_getu(word, BCD_WIDTH, D_LSB)];
+                blocks[FIXED_RED][i] = tables->red[pr];
+                blocks[FIXED_GREEN][i] = tables->green[pb][pr];
+                blocks[FIXED_BLUE][i] = tables->blue[pb];
+        }
+}
+
+/* FUNCTION:  blocks_to_rgb
+ * Purpose:   Converts n blocks of fixed point values to pixels
+ * Arg:       blocks: FIXED_PLANES rows of n values
+ *            top, bottom: CHANNELS rows each that receive the 2 * n samples
+ *                         of the upper and lower row of pixels
+ *            n: the number of blocks
+ * Returns:   N/A
+ * Effect:    Uses the widest kernel the CPU supports, then the scalar
+ *            kernel for the blocks left over
+ * Error:     N/A
+ */
+static void blocks_to_rgb(const int16_t *const blocks[],
+                          unsigned char *const top[],
+                          unsigned char *const bottom[], int n)
+{
+        pthread_once(&chosen, choose_kernel);
+
+        int done = 0;
+#ifdef HAVE_AVX2_KERNELS
+        if (use_avx2) {
+                done = blocks_to_rgb_avx2(blocks, top, bottom, n);
+        }
+#endif
+#ifdef __SSE2__
+        if (done == 0) {
+                done = blocks_to_rgb_sse2(blocks, top, bottom, n);
+        }
+#endif
+        blocks_to_rgb_scalar(blocks, top, bottom, done, n);
+}
+
+/* FUNCTION:  choose_kernel
+ * Purpose:   Checks once whether the CPU supports AVX2
+ * Arg:       N/A
+ * Returns:   N/A
+ * Effect:    Sets use_avx2
+ * Error:     N/A
+ */
+static void choose_kernel(void)
+{
+#ifdef HAVE_AVX2_KERNELS
+        __builtin_cpu_init();
+        use_avx2 = __builtin_cpu_supports("avx2");
+#endif
+}
+
+/* FUNCTION:  blocks_to_rgb_scalar
+ * Purpose:   Scalar version of blocks_to_rgb, starting at block first
+ * Arg:       see blocks_to_rgb
+ *            first: the first block to convert
+ * Returns:   N/A
+ * Effect:    Writes the pixels of blocks first through n - 1
+ * Error:     N/A
+ */
+static void blocks_to_rgb_scalar(const int16_t *const blocks[],
+                                 unsigned char *const top[],
+                                 unsigned char *const bottom[],
+                                 int first, int n)
+{
+        int i, k;
+        for (i = first; i < n; i++) {
+                int a = blocks[FIXED_A][i], b = blocks[FIXED_B][i];
+                int c = blocks[FIXED_C][i], d = blocks[FIXED_D][i];
+                int l = 2 * i;
+                int r = 2 * i + 1;
+
+                /* the luma of the 4 pixels, as in SIMD_kernels */
+                int y1 = a - b - c + d, y2 = a - b + c - d;
+                int y3 = a + b - c - d, y4 = a + b + c + d;
+
+                for (k = 0; k < CHANNELS; k++) {
+                        int offset = blocks[FIXED_RED + k][i];
+                        top[k][l] = clamp_sample((y1 + offset) >> FRAC_BITS);
+                        top[k][r] = clamp_sample((y2 + offset) >> FRAC_BITS);
+                        bottom[k][l] =
+                                clamp_sample((y3 + offset) >> FRAC_BITS);
+                        bottom[k][r] =
+                                clamp_sample((y4 + offset) >> FRAC_BITS);
+                }
+        }
+}
+
+/* FUNCTION:  clamp_sample
+ * Purpose:   Clamps a value to a sample
+ * Arg:       value: the value
+ * Returns:   value clamped to [0, SAMPLE_MAX]
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static unsigned char clamp_sample(int value)
+{
+        if (value < 0) {
+                return 0;
+        }
+        if (value > SAMPLE_MAX) {
+                return SAMPLE_MAX;
+        }
+
+        return value;
+}
+
+#ifdef __SSE2__
+
+/* FUNCTION:  blocks_to_rgb_sse2
+ * Purpose:   SSE2 version of blocks_to_rgb, 8 blocks at a time
+ * Arg:       see blocks_to_rgb
+ * Returns:   The number of blocks converted, a multiple of 8
+ * Effect:    Writes the pixels of the blocks converted
+ * Error:     N/A
+ */
+static int blocks_to_rgb_sse2(const int16_t *const blocks[],
+                              unsigned char *const top[],
+                              unsigned char *const bottom[], int n)
+{
+        int i, k;
+        for (i = 0; i + 8 <= n; i += 8) {
+                __m128i a = _mm_loadu_si128((const void *)(blocks[FIXED_A] +
+                                                           i));
+                __m128i b = _mm_loadu_si128((const void *)(blocks[FIXED_B] +
+                                                           i));
+                __m128i c = _mm_loadu_si128((const void *)(blocks[FIXED_C] +
+                                                           i));
+                __m128i d = _mm_loadu_si128((const void *)(blocks[FIXED_D] +
+                                                           i));
+                __m128i a_b = _mm_sub_epi16(a, b);
+                __m128i ab = _mm_add_epi16(a, b);
+                __m128i y1 = _mm_add_epi16(_mm_sub_epi16(a_b, c), d);
+                __m128i y2 = _mm_sub_epi16(_mm_add_epi16(a_b, c), d);
+                __m128i y3 = _mm_sub_epi16(_mm_sub_epi16(ab, c), d);
+                __m128i y4 = _mm_add_epi16(_mm_add_epi16(ab, c), d);
+
+                for (k = 0; k < CHANNELS; k++) {
+                        __m128i offset = _mm_loadu_si128(
+                                (const void *)(blocks[FIXED_RED + k] + i));
+                        __m128i l, r;
+
+                        /* left and right pixels alternate; the saturating
+                           pack clamps to [0, 255] */
+                        l = _mm_srai_epi16(_mm_add_epi16(y1, offset),
+                                           FRAC_BITS);
+                        r = _mm_srai_epi16(_mm_add_epi16(y2, offset),
+                                           FRAC_BITS);
+                        _mm_storeu_si128((void *)(top[k] + 2 * i),
+                                _mm_packus_epi16(_mm_unpacklo_epi16(l, r),
+                                                 _mm_unpackhi_epi16(l, r)));
+                        l = _mm_srai_epi16(_mm_add_epi16(y3, offset),
+                                           FRAC_BITS);
+                        r = _mm_srai_epi16(_mm_add_epi16(y4, offset),
+                                           FRAC_BITS);
+                        _mm_storeu_si128((void *)(bottom[k] + 2 * i),
+                                _mm_packus_epi16(_mm_unpacklo_epi16(l, r),
+                                                 _mm_unpackhi_epi16(l, r)));
+                }
+        }
+
+        return i;
+}
+
+#endif
+
+#ifdef HAVE_AVX2_KERNELS
+
+/* FUNCTION:  blocks_to_rgb_avx2
+ * Purpose:   AVX2 version of blocks_to_rgb, 16 blocks at a time
+ * Arg:       see blocks_to_rgb
+ * Returns:   The number of blocks converted, a multiple of 16
+ * Effect:    Writes the pixels of the blocks converted. The unpacks and the
+ *            pack work within 128 bit lanes, which happens to leave the 32
+ *            samples of each store in pixel order
+ * Error:     N/A
+ */
+__attribute__((target("avx2")))
+static int blocks_to_rgb_avx2(const int16_t *const blocks[],
+                              unsigned char *const top[],
+                              unsigned char *const bottom[], int n)
+{
+        int i, k;
+        for (i = 0; i + 16 <= n; i += 16) {
+                __m256i a = _mm256_loadu_si256(
+                        (const void *)(blocks[FIXED_A] + i));
+                __m256i b = _mm256_loadu_si256(
+                        (const void *)(blocks[FIXED_B] + i));
+                __m256i c = _mm256_loadu_si256(
+                        (const void *)(blocks[FIXED_C] + i));
+                __m256i d = _mm256_loadu_si256(
+                        (const void *)(blocks[FIXED_D] + i));
+                __m256i a_b = _mm256_sub_epi16(a, b);
+                __m256i ab = _mm256_add_epi16(a, b);
+                __m256i y1 = _mm256_add_epi16(_mm256_sub_epi16(a_b, c), d);
+                __m256i y2 = _mm256_sub_epi16(_mm256_add_epi16(a_b, c), d);
+                __m256i y3 = _mm256_sub_epi16(_mm256_sub_epi16(ab, c), d);
+                __m256i y4 = _mm256_add_epi16(_mm256_add_epi16(ab, c), d);
+
+                for (k = 0; k < CHANNELS; k++) {
+                        __m256i offset = _mm256_loadu_si256(
+                                (const void *)(blocks[FIXED_RED + k] + i));
+                        __m256i l, r;
+
+                        l = _mm256_srai_epi16(_mm256_add_epi16(y1, offset),
+                                              FRAC_BITS);
+                        r = _mm256_srai_epi16(_mm256_add_epi16(y2, offset),
+                                              FRAC_BITS);
+                        _mm256_storeu_si256((void *)(top[k] + 2 * i),
+                                _mm256_packus_epi16(
+                                        _mm256_unpacklo_epi16(l, r),
+                                        _mm256_unpackhi_epi16(l, r)));
+                        l = _mm256_srai_epi16(_mm256_add_epi16(y3, offset),
+                                              FRAC_BITS);
+                        r = _mm256_srai_epi16(_mm256_add_epi16(y4, offset),
+                                              FRAC_BITS);
+                        _mm256_storeu_si256((void *)(bottom[k] + 2 * i),
+                                _mm256_packus_epi16(
+                                        _mm256_unpacklo_epi16(l, r),
+                                        _mm256_unpackhi_epi16(l, r)));
+                }
+        }
+
+        return i;
+}
+
+#endif
@@ -0,0 +1,50 @@
+/*****************************************************************************
+ *
+ *                               Fixed_decode.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Fixed_decode module. The purpose
+ *     of this module is an all integer decompressor (40image -d --fixed)
+ *     that goes from codewords straight to the bytes of a binary PPM, with
+ *     no floats in between. Every value is a 16 bit fixed point number in
+ *     units of 1/32 of a sample (Q5 on a 0 to 255 scale). The a, b, c and d
+ *     fields and the red, green and blue offsets of the two chroma fields
+ *     come from small tables built once per image, the inverse DCT and the
+ *     color conversion are 16 bit additions, and the clamp to [0, 255] is a
+ *     saturating pack. The kernels run 16 blocks at a time with AVX2, 8 with
+ *     SSE2, or one at a time in plain C, with identical output.
+ *
+ *     Error bound: each table entry is the exact value rounded to 1/64 of a
+ *     sample, and a sample adds up at most 5 entries, so it is within 5/64
+ *     of the sample the float decoder computes before truncation. Every
+ *     sample therefore differs from the float decoder's by at most 1.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include "uarray2.h"
+
+#ifndef FIXEDDECODE_INCLUDED
+#define FIXEDDECODE_INCLUDED
+
+/* FUNCTION:  Fixed_decode_write
+ * Purpose:   Decodes a rectangle of an image from its codewords and writes
+ *            it as a binary PPM with a maxval of 255
+ * Arg:       codewords: pointer to a UArray2 of codewords
+ *            col, row: the top left pixel of the rectangle
+ *            width, height: the size of the rectangle, in pixels
+ *            output: pointer to a file open for writing
+ * Returns:   N/A
+ * Effect:    Only the blocks that cover the rectangle are decoded, one row
+ *            of blocks at a time; recycles the codewords
+ * Error:     Runtime error if a NULL pointer is passed in, if the rectangle
+ *            is not inside the image, if memory cannot be allocated or if
+ *            the write fails
+ */
+void Fixed_decode_write(UArray2_T codewords, int col, int row, int width,
+                        int height, FILE *output);
+
+#endif
@@ -0,0 +1,294 @@
+/*****************************************************************************
+ *
+ *                               Frame_stream.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Frame_stream module. The
+ *     ring is RING_FRAMES planar frames that pass between two queues: the
+ *     reader pops a free frame, fills it from one ppm_RGBfloats stream that
+ *     moves from PPM to PPM, and pushes it to the full queue; the calling
+ *     thread pops it, copies it into a plane of its arena and gives it back
+ *     at once, so the reader can go on parsing while the copy is being
+ *     compressed and written.
+ *
+ *****************************************************************************/
+#include <assert.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include "Frame_stream.h"
+#include "Band_queue.h"
+#include "Planar.h"
+#include "uarray2.h"
+
+/* the modules that read, compress and write each frame */
+#include "ppm_RGBfloats.h"
+#include "Row_bands.h"
+#include "Codewords_File.h"
+
+/* frames in the ring */
+#define RING_FRAMES 4
+
+/* seconds between the lines of the report */
+#define REPORT_SECONDS 5.0
+
+/*
+ * The state shared by the reader and the calling thread
+ * stream:        the PPMs being read
+ * width, height: the dimensions every frame must have
+ * free_frames:   frames of the ring waiting to be filled
+ * full_frames:   frames of the ring filled, waiting to be compressed
+ * lock:          guards stalls and stall_seconds
+ * stalls:        times the reader found no free frame
+ * stall_seconds: time the reader waited for a free frame
+ */
+struct Frame_stream {
+        ppm_RGBfloats_stream_T stream;
+        int width, height;
+        Band_queue_T free_frames;
+        Band_queue_T full_frames;
+        pthread_mutex_t lock;
+        unsigned long stalls;
+        double stall_seconds;
+};
+
+/*
+ * the counts at one line of the report
+ * when:            the time of the line
+ * frames:          frames written so far
+ * stalls:          stalls of the reader so far
+ * stall_seconds:   seconds the reader stalled so far
+ * starved_seconds: seconds the compressor waited for a frame so far
+ */
+struct Totals {
+        struct timespec when;
+        unsigned long frames;
+        unsigned long stalls;
+        double stall_seconds;
+        double starved_seconds;
+};
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static void     *read_frames(void *cl);
+static Planar_T  pop_timed(Band_queue_T queue, double *seconds);
+static void      take_totals(struct Frame_stream *frames,
+                             struct Totals *totals);
+static void      report_line(FILE *report, const char *name,
+                             const struct Totals *from,
+                             const struct Totals *to);
+static double    seconds_between(struct timespec from, struct timespec to);
+
+/* FUNCTION:  Frame_stream_compress
+ * Purpose:   Compresses PPM frames until the end of the input
+ * Arg:       input: pointer to one or more PPMs of the same dimensions
+ *            output: pointer to a file open for writing
+ *            nthreads: worker threads for the stages of each frame
+ *            report: pointer to a file for the statistics, or NULL
+ * Returns:   The size of the frames in 8 bit pixels
+ * Effect:    The calling thread compresses and writes; the ring and its
+ *            queues are allocated before the first frame and the stages
+ *            recycle their planes through an arena of the calling thread
+ * Error:     Runtime error if input or output is NULL, if nthreads is 0,
+ *            if input holds no PPM, if the frames differ in size or if a
+ *            thread cannot be created
+ */
+size_t Frame_stream_compress(FILE *input, FILE *output, unsigned nthreads,
+                             FILE *report)
+{
+        assert(input != NULL && output != NULL);
+        assert(nthreads > 0);
+
+        struct Frame_stream frames;
+        frames.stream = ppm_RGBfloats_stream_open(input);
+        frames.width = ppm_RGBfloats_stream_width(frames.stream);
+        frames.height = ppm_RGBfloats_stream_height(frames.stream);
+        frames.free_frames = Band_queue_new(RING_FRAMES);
+        frames.full_frames = Band_queue_new(RING_FRAMES);
+        pthread_mutex_init(&frames.lock, NULL);
+        frames.stalls = 0;
+        frames.stall_seconds = 0;
+
+        /* the ring comes from the heap, before the arena is in use */
+        Planar_T ring[RING_FRAMES];
+        int i;
+        for (i = 0; i < RING_FRAMES; i++) {
+                ring[i] = Planar_new(frames.width, frames.height, 3);
+                Band_queue_push(frames.free_frames, ring[i]);
+        }
+        Planar_arena_T arena = Planar_arena_new();
+        Planar_arena_use(arena);
+
+        pthread_t reader;
+        int err = pthread_create(&reader, NULL, read_frames, &frames);
+        assert(err == 0);
+
+        struct Totals start, last, now;
+        take_totals(&frames, &start);
+        start.frames = 0;
+        start.starved_seconds = 0;
+        last = start;
+        now = start;
+        if (report != NULL) {
+                fprintf(report, "stream\tframes\tseconds\tfps\tstalls\t"
+                        "stall_seconds\tstarved_seconds\n");
+        }
+
+        Planar_T frame;
+        while ((frame = pop_timed(frames.full_frames,
+                                  &now.starved_seconds)) != NULL) {
+                Planar_T copy = Planar_crop(frame, 0, 0, frames.width,
+                                            frames.height);
+                Band_queue_push(frames.free_frames, frame);
+
+                Codewords_File_write(Row_bands_compress(copy, nthreads, NULL),
+                                     output);
+                fflush(output);
+                now.frames++;
+
+                take_totals(&frames, &now);
+                if (report != NULL &&
+                    seconds_between(last.when, now.when) >= REPORT_SECONDS) {
+                        report_line(report, "interval", &last, &now);
+                        last = now;
+                }
+        }
+
+        err = pthread_join(reader, NULL);
+        assert(err == 0);
+        take_totals(&frames, &now);
+        if (report != NULL) {
+                report_line(report, "total", &start, &now);
+        }
+
+        Planar_arena_use(NULL);
+        Planar_arena_free(&arena);
+        for (i = 0; i < RING_FRAMES; i++) {
+                Planar_free(&ring[i]);
+        }
+        pthread_mutex_destroy(&frames.lock);
+        Band_queue_free(&frames.free_frames);
+        Band_queue_free(&frames.full_frames);
+        ppm_RGBfloats_stream_free(&frames.stream);
+
+        return (size_t)now.frames * frames.width * frames.height * 3;
+}
+
+/* FUNCTION:  read_frames
+ * Purpose:   Body of the reader thread
+ * Arg:       cl: pointer to the shared Frame_stream
+ * Returns:   NULL
+ * Effect:    Fills a free frame of the ring with each PPM of the input and
+ *            queues it, counting the times it has to wait for a free frame,
+ *            then closes the full queue
+ * Error:     Runtime error if a frame differs in size from the first
+ */
+static void *read_frames(void *cl)
+{
+        struct Frame_stream *frames = cl;
+
+        do {
+                assert(ppm_RGBfloats_stream_width(frames->stream) ==
+                       frames->width);
+                assert(ppm_RGBfloats_stream_height(frames->stream) ==
+                       frames->height);
+
+                double waited = 0;
+                bool stalled = Band_queue_length(frames->free_frames) == 0;
+                Planar_T frame = pop_timed(frames->free_frames, &waited);
+                if (stalled) {
+                        pthread_mutex_lock(&frames->lock);
+                        frames->stalls++;
+                        frames->stall_seconds += waited;
+                        pthread_mutex_unlock(&frames->lock);
+                }
+
+                ppm_RGBfloats_stream_read(frames->stream, frame);
+                Band_queue_push(frames->full_frames, frame);
+        } while (ppm_RGBfloats_stream_next(frames->stream));
+
+        Band_queue_close(frames->full_frames);
+
+        return NULL;
+}
+
+/* FUNCTION:  pop_timed
+ * Purpose:   Removes the frame at the front of a queue, timing the wait
+ * Arg:       queue: an initialized queue of frames
+ *            seconds: the time spent is added to *seconds
+ * Returns:   The frame, or NULL once the queue is closed and empty
+ * Effect:    Waits while the queue is empty and not closed
+ * Error:     N/A
+ */
+static Planar_T pop_timed(Band_queue_T queue, double *seconds)
+{
+        struct timespec from, to;
+        clock_gettime(CLOCK_MONOTONIC, &from);
+        Planar_T frame = Band_queue_pop(queue);
+        clock_gettime(CLOCK_MONOTONIC, &to);
+        *seconds += seconds_between(from, to);
+
+        return frame;
+}
+
+/* FUNCTION:  take_totals
+ * Purpose:   Brings the time and the counts of the reader up to date
+ * Arg:       frames: the shared Frame_stream
+ *            totals: the totals to update; frames and starved_seconds are
+ *                    kept by the calling thread and left alone
+ * Returns:   N/A
+ * Effect:    Reads the clock and, under the lock, the stalls
+ * Error:     N/A
+ */
+static void take_totals(struct Frame_stream *frames, struct Totals *totals)
+{
+        clock_gettime(CLOCK_MONOTONIC, &totals->when);
+
+        pthread_mutex_lock(&frames->lock);
+        totals->stalls = frames->stalls;
+        totals->stall_seconds = frames->stall_seconds;
+        pthread_mutex_unlock(&frames->lock);
+}
+
+/* FUNCTION:  report_line
+ * Purpose:   Writes the statistics between two points of a run
+ * Arg:       report: pointer to a file open for writing
+ *            name: the first field of the line
+ *            from, to: the totals at the start and at the end
+ * Returns:   N/A
+ * Effect:    Writes one tab separated line and flushes report, so the
+ *            statistics of an endless run can be followed as it goes
+ * Error:     N/A
+ */
+static void report_line(FILE *report, const char *name,
+                        const struct Totals *from, const struct Totals *to)
+{
+        unsigned long frames = to->frames - from->frames;
+        double seconds = seconds_between(from->when, to->when);
+        double fps = seconds > 0 ? frames / seconds : 0;
+
+        fprintf(report, "%s\t%lu\t%.3f\t%.2f\t%lu\t%.3f\t%.3f\n", name,
+                frames, seconds, fps, to->stalls - from->stalls,
+                to->stall_seconds - from->stall_seconds,
+                to->starved_seconds - from->starved_seconds);
+        fflush(report);
+}
+
+/* FUNCTION:  seconds_between
+ * Purpose:   Returns the time between two readings of the clock
+ * Arg:       from, to: the readings
+ * Returns:   The seconds from from to to
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static double seconds_between(struct timespec from, struct timespec to)
+{
+        return (to.tv_sec - from.tv_sec) +
+               (to.tv_nsec - from.tv_nsec) / 1e9;
+}
@@ -0,0 +1,54 @@
+/*****************************************************************************
+ *
+ *                               Frame_stream.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Frame_stream module. The purpose
+ *     of this module is to compress an endless run of PPM frames from a
+ *     pipe, such as a camera or a renderer writing one PPM after another
+ *     (40image -c --stream). Each frame becomes one record: a complete
+ *     image in format 2, flushed as soon as it is written, so a reader at
+ *     the other end can decode each record as it arrives (40image -d
+ *     --stream). Unlike the sequence format, no frame depends on another.
+ *
+ *     A reader thread parses the frames into a small ring of frames that
+ *     is allocated once, while the calling thread compresses and writes
+ *     them; the stages take their planes from an arena, so a run of any
+ *     length allocates no new pixels once the first frame is through. When
+ *     the output cannot keep up, the ring fills and the reader waits for a
+ *     free frame: that wait is a backpressure stall, and it is counted and
+ *     timed along with the frames per second.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stddef.h>
+
+#ifndef FRAME_STREAM_INCLUDED
+#define FRAME_STREAM_INCLUDED
+
+/* FUNCTION:  Frame_stream_compress
+ * Purpose:   Compresses PPM frames until the end of the input
+ * Arg:       input: pointer to one or more binary or plain PPMs of the
+ *                   same dimensions, one after another; it can be a pipe
+ *            output: pointer to a file open for writing
+ *            nthreads: worker threads for the stages of each frame
+ *            report: pointer to a file for the statistics, or NULL
+ * Returns:   The size of the frames in 8 bit pixels
+ * Effect:    Writes one format 2 image per frame, flushing output after
+ *            each. Every few seconds, and once at the end, writes a tab
+ *            separated line to report with the frames and seconds since the
+ *            last line, the frames per second, the number of stalls of the
+ *            reader, the seconds it stalled and the seconds the compressor
+ *            waited for input
+ * Error:     Runtime error if input or output is NULL, if nthreads is 0,
+ *            if input holds no PPM, if the frames differ in size or if a
+ *            thread cannot be created
+ */
+size_t Frame_stream_compress(FILE *input, FILE *output, unsigned nthreads,
+                             FILE *report);
+
+#endif
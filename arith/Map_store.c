@@ -0,0 +1,137 @@
+/*****************************************************************************
+ *
+ *                                 Map_store.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Map_store module. Each
+ *     allocation gets its own temporary file, unlinked and closed as soon
+ *     as it is mapped shared, so the mapping keeps the file alive and
+ *     dirty pages have somewhere to go other than swap.
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "Map_store.h"
+
+/* directory of the temporary files when $TMPDIR is not set; /tmp is often
+   held in memory itself */
+#define DEFAULT_DIR "/var/tmp"
+
+/* share of the physical memory that is the default threshold */
+#define MEMORY_SHARE 8
+
+/* smallest default threshold, for machines that do not report their
+   memory */
+#define MIN_THRESHOLD ((size_t)256 << 20)
+
+/* the threshold set by Map_store_set_threshold, or 0 for the default */
+static size_t threshold = 0;
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static size_t default_threshold(void);
+
+/* FUNCTION:  Map_store_set_threshold
+ * Purpose:   Sets the smallest allocation that is mapped from a file
+ * Arg:       bytes: the threshold; 0 restores the default
+ * Returns:   N/A
+ * Effect:    Applies to later calls of Map_store_alloc on every thread
+ * Error:     N/A
+ */
+void Map_store_set_threshold(size_t bytes)
+{
+        threshold = bytes;
+}
+
+/* FUNCTION:  Map_store_alloc
+ * Purpose:   Maps zeroed memory from a temporary file
+ * Arg:       bytes: the number of bytes needed
+ * Returns:   A page aligned pointer, or NULL if bytes is below the
+ *            threshold or no temporary file can be made
+ * Effect:    Creates, unlinks and closes a file of bytes bytes; the pages
+ *            are hinted to be used in order
+ * Error:     N/A
+ */
+void *Map_store_alloc(size_t bytes)
+{
+        size_t limit = threshold > 0 ? threshold : default_threshold();
+        if (bytes == 0 || bytes < limit) {
+                return NULL;
+        }
+
+        const char *dir = getenv("TMPDIR");
+        if (dir == NULL || *dir == '\0') {
+                dir = DEFAULT_DIR;
+        }
+        char path[4096];
+        int n = snprintf(path, sizeof(path), "%s/arith-XXXXXX", dir);
+        if (n < 0 || (size_t)n >= sizeof(path)) {
+                return NULL;
+        }
+
+        int fd = mkstemp(path);
+        if (fd < 0) {
+                return NULL;
+        }
+        unlink(path);
+
+        void *memory = MAP_FAILED;
+        if (ftruncate(fd, bytes) == 0) {
+                memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                              MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (memory == MAP_FAILED) {
+                return NULL;
+        }
+        madvise(memory, bytes, MADV_SEQUENTIAL);
+
+        return memory;
+}
+
+/* FUNCTION:  Map_store_free
+ * Purpose:   Unmaps memory from Map_store_alloc
+ * Arg:       memory: the pointer Map_store_alloc returned
+ *            bytes: the number of bytes asked for
+ * Returns:   N/A
+ * Effect:    The pages and the file are released; since the file is
+ *            unlinked, its dirty pages are dropped rather than written
+ * Error:     Runtime error if memory is NULL or the unmapping fails
+ */
+void Map_store_free(void *memory, size_t bytes)
+{
+        assert(memory != NULL);
+
+        int err = munmap(memory, bytes);
+        assert(err == 0);
+}
+
+/* FUNCTION:  default_threshold
+ * Purpose:   Gives the threshold used when none was set
+ * Arg:       N/A
+ * Returns:   An eighth of the physical memory, or MIN_THRESHOLD if that is
+ *            smaller or unknown
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static size_t default_threshold(void)
+{
+        long pages = sysconf(_SC_PHYS_PAGES);
+        long page_bytes = sysconf(_SC_PAGESIZE);
+        if (pages <= 0 || page_bytes <= 0) {
+                return MIN_THRESHOLD;
+        }
+
+        size_t share = (size_t)pages * page_bytes / MEMORY_SHARE;
+
+        return share > MIN_THRESHOLD ? share : MIN_THRESHOLD;
+}
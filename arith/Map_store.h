@@ -0,0 +1,60 @@
+/*****************************************************************************
+ *
+ *                                 Map_store.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Map_store module. The purpose of
+ *     this module is to back the largest arrays (UArray2 and Planar) with
+ *     a temporary file instead of the heap, so that an image whose stage
+ *     copies do not fit in memory still compresses: the kernel writes the
+ *     pages the stages are done with back to the file and drops them,
+ *     rather than swapping or failing. Allocations of at least a threshold
+ *     number of bytes are mapped from an unlinked file in $TMPDIR (or
+ *     /var/tmp, which unlike /tmp is rarely held in memory) with a
+ *     sequential access hint, which suits the row by row stages; smaller
+ *     ones are left to the heap. The threshold defaults to an eighth of
+ *     the physical memory, since a compression has up to five copies of
+ *     the image alive at once.
+ *
+ *****************************************************************************/
+#include <stddef.h>
+
+#ifndef MAP_STORE_INCLUDED
+#define MAP_STORE_INCLUDED
+
+/* FUNCTION:  Map_store_set_threshold
+ * Purpose:   Sets the smallest allocation that is mapped from a file
+ * Arg:       bytes: the threshold; 0 restores the default
+ * Returns:   N/A
+ * Effect:    Applies to later calls of Map_store_alloc on every thread
+ * Error:     N/A
+ */
+extern void Map_store_set_threshold(size_t bytes);
+
+/* FUNCTION:  Map_store_alloc
+ * Purpose:   Maps zeroed memory from a temporary file
+ * Arg:       bytes: the number of bytes needed
+ * Returns:   A page aligned pointer, or NULL if bytes is below the
+ *            threshold or no temporary file can be made, in which case the
+ *            caller allocates from the heap
+ * Effect:    The file is unlinked at once, so it goes away with the
+ *            mapping, even if the program is killed
+ * Error:     N/A
+ */
+extern void *Map_store_alloc(size_t bytes);
+
+/* FUNCTION:  Map_store_free
+ * Purpose:   Unmaps memory from Map_store_alloc
+ * Arg:       memory: the pointer Map_store_alloc returned
+ *            bytes: the number of bytes asked for
+ * Returns:   N/A
+ * Effect:    The pages and the file are released
+ * Error:     Runtime error if memory is NULL or the unmapping fails
+ */
+extern void Map_store_free(void *memory, size_t bytes);
+
+#endif
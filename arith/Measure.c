@@ -0,0 +1,190 @@
+/*****************************************************************************
+ *
+ *                                 Measure.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Measure module. Each
+ *     thread takes an equal band of rows and keeps its own sums; the sums
+ *     are added in thread order at the end, so the result does not depend
+ *     on which thread finishes first.
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include "Measure.h"
+#include "SIMD_kernels.h"
+
+/* largest sample of the PPMs the decoder writes */
+#define SAMPLE_MAX 255.0
+
+/*
+ * original, decoded: the images compared
+ * first, last:       the rows of the band, last not included
+ * sum_squares:       the sums of the band for each channel
+ */
+struct Band {
+        Planar_T original, decoded;
+        int first, last;
+        double sum_squares[3];
+};
+
+/* names of the channels in the report */
+static const char *const channels[3] = { "red", "green", "blue" };
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static void *band_errors(void *cl);
+static void  report_line(FILE *report, const char *name, double sum,
+                         size_t samples);
+
+/* FUNCTION:  Measure_errors
+ * Purpose:   Sums the squared errors of a decoded image
+ * Arg:       original, decoded: planar images of the same size with red,
+ *                               green and blue planes
+ *            nthreads: the number of threads to share the rows among
+ *            sum_squares: receives the sums of the 3 channels
+ * Returns:   N/A
+ * Effect:    Runs band_errors on nthreads - 1 new threads and the calling
+ *            thread
+ * Error:     Runtime error if a NULL pointer is passed in, if nthreads is
+ *            0, if the images differ in size or if a thread cannot be
+ *            created
+ */
+void Measure_errors(Planar_T original, Planar_T decoded, unsigned nthreads,
+                    double sum_squares[3])
+{
+        assert(original != NULL && decoded != NULL && sum_squares != NULL);
+        assert(nthreads > 0);
+        assert(Planar_width(original) == Planar_width(decoded));
+        assert(Planar_height(original) == Planar_height(decoded));
+        assert(Planar_nplanes(original) >= 3 && Planar_nplanes(decoded) >= 3);
+
+        int height = Planar_height(original);
+        if ((int)nthreads > height) {
+                nthreads = height > 0 ? height : 1;
+        }
+
+        struct Band *bands = malloc(nthreads * sizeof(*bands));
+        pthread_t *threads = malloc(nthreads * sizeof(*threads));
+        assert(bands != NULL && threads != NULL);
+
+        unsigned i;
+        for (i = 0; i < nthreads; i++) {
+                bands[i].original = original;
+                bands[i].decoded = decoded;
+                bands[i].first = (long)height * i / nthreads;
+                bands[i].last = (long)height * (i + 1) / nthreads;
+        }
+        for (i = 1; i < nthreads; i++) {
+                int err = pthread_create(&threads[i], NULL, band_errors,
+                                         &bands[i]);
+                assert(err == 0);
+        }
+        band_errors(&bands[0]);
+
+        int plane;
+        for (plane = 0; plane < 3; plane++) {
+                sum_squares[plane] = bands[0].sum_squares[plane];
+        }
+        for (i = 1; i < nthreads; i++) {
+                int err = pthread_join(threads[i], NULL);
+                assert(err == 0);
+                for (plane = 0; plane < 3; plane++) {
+                        sum_squares[plane] += bands[i].sum_squares[plane];
+                }
+        }
+
+        free(threads);
+        free(bands);
+}
+
+/* FUNCTION:  Measure_report
+ * Purpose:   Writes the quality and the size of a round trip
+ * Arg:       report: pointer to a file open for writing
+ *            sum_squares: the sums from Measure_errors
+ *            pixels: the number of pixels compared
+ *            compressed_bytes: the size of the compressed image
+ * Returns:   N/A
+ * Effect:    Writes the lines described in Measure.h
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+void Measure_report(FILE *report, const double sum_squares[3], size_t pixels,
+                    size_t compressed_bytes)
+{
+        assert(report != NULL && sum_squares != NULL);
+
+        fprintf(report, "channel\trmse\tpsnr_db\n");
+        int plane;
+        for (plane = 0; plane < 3; plane++) {
+                report_line(report, channels[plane], sum_squares[plane],
+                            pixels);
+        }
+        report_line(report, "all", sum_squares[0] + sum_squares[1] +
+                                   sum_squares[2], pixels * 3);
+
+        size_t pixel_bytes = pixels * 3;
+        fprintf(report, "pixel_bytes\t%zu\n", pixel_bytes);
+        fprintf(report, "compressed_bytes\t%zu\n", compressed_bytes);
+        if (compressed_bytes > 0) {
+                fprintf(report, "ratio\t%.3f\n",
+                        (double)pixel_bytes / compressed_bytes);
+        }
+}
+
+/* FUNCTION:  band_errors
+ * Purpose:   Sums the squared errors of one band of rows
+ * Arg:       cl: pointer to the struct Band
+ * Returns:   NULL
+ * Effect:    Sets the sums of the band
+ * Error:     N/A
+ */
+static void *band_errors(void *cl)
+{
+        struct Band *band = cl;
+        int width = Planar_width(band->original);
+
+        int plane, row;
+        for (plane = 0; plane < 3; plane++) {
+                double sum = 0;
+                for (row = band->first; width > 0 && row < band->last;
+                     row++) {
+                        sum += SIMD_kernels_squared_error(
+                                Planar_row(band->original, plane, row),
+                                Planar_row(band->decoded, plane, row),
+                                width);
+                }
+                band->sum_squares[plane] = sum;
+        }
+
+        return NULL;
+}
+
+/* FUNCTION:  report_line
+ * Purpose:   Writes the RMSE and PSNR of a channel
+ * Arg:       report: pointer to a file open for writing
+ *            name: the name of the channel
+ *            sum: the sum of its squared errors
+ *            samples: the number of its samples
+ * Returns:   N/A
+ * Effect:    Writes one tab separated line
+ * Error:     N/A
+ */
+static void report_line(FILE *report, const char *name, double sum,
+                        size_t samples)
+{
+        double rmse = samples > 0 ? sqrt(sum / samples) : 0;
+        if (rmse > 0) {
+                fprintf(report, "%s\t%.4f\t%.2f\n", name, rmse,
+                        20 * log10(SAMPLE_MAX / rmse));
+        } else {
+                fprintf(report, "%s\t%.4f\tinf\n", name, rmse);
+        }
+}
@@ -0,0 +1,59 @@
+/*****************************************************************************
+ *
+ *                                 Measure.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Measure module. The purpose of
+ *     this module is to report how close a decoded image is to the
+ *     original without writing either to disk (40image --measure): the
+ *     root mean square error and the peak signal to noise ratio of each
+ *     channel and of all three, in the 0 to 255 units of the PPM the
+ *     decoder would write, and the compression ratio. The squared errors
+ *     are summed by a SIMD kernel over bands of rows on several threads.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stddef.h>
+#include "Planar.h"
+
+#ifndef MEASURE_INCLUDED
+#define MEASURE_INCLUDED
+
+/* FUNCTION:  Measure_errors
+ * Purpose:   Sums the squared errors of a decoded image
+ * Arg:       original: a planar image with red, green and blue planes
+ *            decoded: a planar image of the same dimensions and planes
+ *            nthreads: the number of threads to share the rows among
+ *            sum_squares: receives the sum of the squared errors of the
+ *                         red, green and blue samples, in that order
+ * Returns:   N/A
+ * Effect:    Neither image is changed; the decoded samples are clamped and
+ *            truncated as the decoder writes them
+ * Error:     Runtime error if a NULL pointer is passed in, if nthreads is
+ *            0, if the images differ in size or if a thread cannot be
+ *            created
+ */
+void Measure_errors(Planar_T original, Planar_T decoded, unsigned nthreads,
+                    double sum_squares[3]);
+
+/* FUNCTION:  Measure_report
+ * Purpose:   Writes the quality and the size of a round trip
+ * Arg:       report: pointer to a file open for writing
+ *            sum_squares: the sums from Measure_errors
+ *            pixels: the number of pixels compared
+ *            compressed_bytes: the size of the compressed image
+ * Returns:   N/A
+ * Effect:    Writes a header line, then one tab separated line for each
+ *            channel and for all three with the RMSE and the PSNR in dB
+ *            ("inf" when there is no error), then the pixel and compressed
+ *            sizes and their ratio
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+void Measure_report(FILE *report, const double sum_squares[3], size_t pixels,
+                    size_t compressed_bytes);
+
+#endif
@@ -0,0 +1,154 @@
+/*****************************************************************************
+ *
+ *                               Memory_codec.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Memory_codec module. The
+ *     pixels are converted straight to and from planar RGB floats by
+ *     ppm_RGBfloats, the same stages as compress40 run in between through
+ *     Row_bands, on as many worker threads as asked for, and the codewords
+ *     are stored to and loaded from memory by Codewords_File. Nothing is
+ *     read from or written to a FILE, and no setting of compress40 is used,
+ *     so several threads can run the codec at once.
+ *
+ *****************************************************************************/
+#include <assert.h>
+#include "Memory_codec.h"
+#include "uarray2.h"
+#include "Planar.h"
+
+/* the modules that convert, compress and store the pixels */
+#include "ppm_RGBfloats.h"
+#include "Row_bands.h"
+#include "Codewords_File.h"
+
+/* FUNCTION:  Memory_codec_compressed_size
+ * Purpose:   Gives the size of the compressed image of some pixels
+ * Arg:       width, height: the dimensions of the pixels
+ * Returns:   The number of bytes Memory_codec_compress stores
+ * Effect:    Odd dimensions are trimmed by one
+ * Error:     Runtime error if a dimension is negative
+ */
+size_t Memory_codec_compressed_size(int width, int height)
+{
+        assert(width >= 0 && height >= 0);
+
+        return Codewords_File_bytes(width - width % 2, height - height % 2);
+}
+
+/* FUNCTION:  Memory_codec_compress
+ * Purpose:   Compresses 8 bit RGB pixels in memory
+ * Arg:       pixels: rows of width red, green, blue byte triples
+ *            width, height: the dimensions of the pixels
+ *            stride: the number of bytes from one row to the next
+ *            output: the buffer the compressed image is stored in
+ *            capacity: the number of bytes of output
+ *            nthreads: the number of worker threads
+ * Returns:   The number of bytes stored, or 0 if output is too small
+ * Effect:    The size is checked before any work is done
+ * Error:     Runtime error if a NULL pointer is passed in, if a dimension
+ *            is negative, if stride is less than 3 * width or if nthreads
+ *            is 0
+ */
+size_t Memory_codec_compress(const unsigned char *pixels, int width,
+                             int height, size_t stride, unsigned char *output,
+                             size_t capacity, unsigned nthreads)
+{
+        assert(pixels != NULL && output != NULL);
+        assert(nthreads > 0);
+
+        if (capacity < Memory_codec_compressed_size(width, height)) {
+                return 0;
+        }
+
+        Planar_T rgb_floats = ppm_RGBfloats_from_pixels(pixels, width,
+                                                        height, stride);
+        UArray2_T codewords = Row_bands_compress(rgb_floats, nthreads, NULL);
+        size_t stored = Codewords_File_store(codewords, output);
+        UArray2_free(&codewords);
+
+        return stored;
+}
+
+/* FUNCTION:  Memory_codec_decompressed_size
+ * Purpose:   Gives the dimensions of a compressed image in memory
+ * Arg:       input: the compressed image
+ *            length: the number of bytes of input
+ *            width, height: receive the dimensions of the image
+ * Returns:   3 * width * height, or 0 if input is not a complete image in
+ *            the fixed size format or the image is empty
+ * Effect:    *width and *height are set only when the header is valid
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+size_t Memory_codec_decompressed_size(const unsigned char *input,
+                                      size_t length, int *width,
+                                      int *height)
+{
+        assert(input != NULL);
+        assert(width != NULL && height != NULL);
+
+        unsigned image_width, image_height;
+        size_t header = Codewords_File_parse_header(input, length,
+                                                    &image_width,
+                                                    &image_height);
+        if (header == 0 || image_width % 2 != 0 || image_height % 2 != 0 ||
+            image_width > (1u << 30) || image_height > (1u << 30) ||
+            length < Codewords_File_bytes(image_width, image_height)) {
+                return 0;
+        }
+
+        *width = image_width;
+        *height = image_height;
+
+        return (size_t)image_width * image_height * 3;
+}
+
+/* FUNCTION:  Memory_codec_decompress
+ * Purpose:   Decompresses a compressed image in memory to 8 bit RGB pixels
+ * Arg:       input: the compressed image
+ *            length: the number of bytes of input
+ *            pixels: the buffer the rows of pixels are stored in
+ *            stride: the number of bytes from one row to the next
+ *            capacity: the number of bytes of pixels
+ *            nthreads: the number of worker threads
+ * Returns:   The number of bytes from the first pixel to the end of the
+ *            last, or 0 if the input is not valid or pixels is too small
+ * Effect:    The input and the sizes are checked before any work is done
+ * Error:     Runtime error if a NULL pointer is passed in or if nthreads is
+ *            0
+ */
+size_t Memory_codec_decompress(const unsigned char *input, size_t length,
+                               unsigned char *pixels, size_t stride,
+                               size_t capacity, unsigned nthreads)
+{
+        assert(input != NULL && pixels != NULL);
+        assert(nthreads > 0);
+
+        int width, height;
+        if (Memory_codec_decompressed_size(input, length, &width,
+                                           &height) == 0) {
+                return 0;
+        }
+
+        size_t row_bytes = (size_t)width * 3;
+        size_t needed = (height - 1) * stride + row_bytes;
+        if (stride < row_bytes || capacity < needed) {
+                return 0;
+        }
+
+        unsigned image_width, image_height;
+        size_t header = Codewords_File_parse_header(input, length,
+                                                    &image_width,
+                                                    &image_height);
+        UArray2_T codewords = Codewords_File_load(input + header,
+                                                  image_width, image_height);
+        Planar_T rgb_floats = Row_bands_decompress(codewords, nthreads, NULL);
+        ppm_RGBfloats_to_pixels(rgb_floats, pixels, stride);
+
+        return needed;
+}
+
@@ -0,0 +1,93 @@
+/*****************************************************************************
+ *
+ *                               Memory_codec.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Memory_codec module. The purpose
+ *     of this module is to let another program embed the codec: it
+ *     compresses 8 bit RGB pixels in a buffer of the caller's into a
+ *     buffer of the caller's, and decompresses the other way, with no
+ *     stdio and no temporary files. The compressed bytes are the same as
+ *     those of 40image -c on a PPM of the same pixels, so either side can
+ *     read what the other writes. Both directions can first ask for the
+ *     size of their output; a buffer that is too small or input that is
+ *     not a compressed image is reported by returning 0 rather than by
+ *     aborting.
+ *
+ *****************************************************************************/
+#include <stddef.h>
+
+#ifndef MEMORY_CODEC_INCLUDED
+#define MEMORY_CODEC_INCLUDED
+
+/* FUNCTION:  Memory_codec_compressed_size
+ * Purpose:   Gives the size of the compressed image of some pixels
+ * Arg:       width, height: the dimensions of the pixels
+ * Returns:   The number of bytes Memory_codec_compress stores
+ * Effect:    Odd dimensions are trimmed by one, as in 40image -c
+ * Error:     Runtime error if a dimension is negative
+ */
+size_t Memory_codec_compressed_size(int width, int height);
+
+/* FUNCTION:  Memory_codec_compress
+ * Purpose:   Compresses 8 bit RGB pixels in memory
+ * Arg:       pixels: rows of width red, green, blue byte triples
+ *            width, height: the dimensions of the pixels
+ *            stride: the number of bytes from one row to the next
+ *            output: the buffer the compressed image is stored in
+ *            capacity: the number of bytes of output
+ *            nthreads: the number of worker threads
+ * Returns:   The number of bytes stored, or 0 if capacity is less than
+ *            Memory_codec_compressed_size, in which case output is not
+ *            touched
+ * Effect:    Reentrant; the settings of compress40 do not apply
+ * Error:     Runtime error if a NULL pointer is passed in, if a dimension
+ *            is negative, if stride is less than 3 * width or if nthreads
+ *            is 0
+ */
+size_t Memory_codec_compress(const unsigned char *pixels, int width,
+                             int height, size_t stride, unsigned char *output,
+                             size_t capacity, unsigned nthreads);
+
+/* FUNCTION:  Memory_codec_decompressed_size
+ * Purpose:   Gives the dimensions of a compressed image in memory
+ * Arg:       input: the compressed image
+ *            length: the number of bytes of input
+ *            width, height: receive the dimensions of the image
+ * Returns:   The number of bytes of its pixels with no padding between rows
+ *            (3 * width * height), or 0 if input is not a complete image
+ *            in the fixed size format or the image is empty
+ * Effect:    Only the header is parsed
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+size_t Memory_codec_decompressed_size(const unsigned char *input,
+                                      size_t length, int *width,
+                                      int *height);
+
+/* FUNCTION:  Memory_codec_decompress
+ * Purpose:   Decompresses a compressed image in memory to 8 bit RGB pixels
+ * Arg:       input: the compressed image
+ *            length: the number of bytes of input
+ *            pixels: the buffer the rows of red, green, blue byte triples
+ *                    are stored in
+ *            stride: the number of bytes from one row to the next
+ *            capacity: the number of bytes of pixels
+ *            nthreads: the number of worker threads
+ * Returns:   The number of bytes from the first pixel to the end of the
+ *            last, or 0 if Memory_codec_decompressed_size gives 0, if
+ *            stride is less than 3 * width or if capacity is less than
+ *            (height - 1) * stride + 3 * width; pixels is then not touched
+ * Effect:    Reentrant; the pixels are those 40image -d writes. Bytes
+ *            between the end of a row and the next row are not touched
+ * Error:     Runtime error if a NULL pointer is passed in or if nthreads is
+ *            0
+ */
+size_t Memory_codec_decompress(const unsigned char *input, size_t length,
+                               unsigned char *pixels, size_t stride,
+                               size_t capacity, unsigned nthreads);
+
+#endif
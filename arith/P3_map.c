@@ -0,0 +1,275 @@
+/*****************************************************************************
+ *
+ *                                  P3_map.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our P3_map module. The text
+ *     after the header, as mapped by PPM_map, is cut into one chunk per 
+ *     thread; each cut is moved
+ *     forward to the next white space so that no number is split. Parsing
+ *     takes two parallel passes. The first counts the numbers that start
+ *     in each chunk, which is a branch free loop over the bytes that the
+ *     compiler can vectorize. A running sum of the counts gives the index
+ *     of the first sample of every chunk, so in the second pass each chunk
+ *     knows the row, column and channel of its first sample and stores its
+ *     samples with no further coordination.
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <ctype.h>
+#include <pthread.h>
+#include "P3_map.h"
+
+/* smallest chunk worth a thread of its own, in bytes */
+#define MIN_CHUNK_BYTES (1 << 16)
+
+/*
+ * one chunk of the text and the work on it
+ * begin, end:  the bytes of the chunk
+ * first:       index of the first sample that starts in the chunk
+ * count:       number of samples that start in the chunk
+ * width, denominator: the width and maxval from the header
+ * planar, to_float: as passed to P3_map_parse
+ */
+struct Chunk {
+        const unsigned char *begin, *end;
+        size_t first;
+        size_t count;
+        unsigned width, denominator;
+        Planar_T planar;
+        const float *to_float;
+};
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static void     run_chunks(struct Chunk *chunks, int nchunks,
+                           void *(*fun)(void *));
+static void    *count_chunk(void *cl);
+static void    *parse_chunk(void *cl);
+static inline bool is_digit(unsigned char c);
+
+/* FUNCTION:  P3_map_parse
+ * Purpose:   Parses the samples of the top left corner of the image into a
+ *            planar image
+ * Arg:       map: an initialized PPM_map_T of a plain PPM
+ *            RGB_floats: a planar image with red, green and blue planes,
+ *                        no larger than the image
+ *            to_float: the float of every sample value from 0 to the maxval
+ *            nthreads: the number of threads to parse with
+ * Returns:   N/A
+ * Effect:    Cuts the text into at most nthreads chunks of at least
+ *            MIN_CHUNK_BYTES, counts and then parses them in parallel.
+ *            Only the rows up to the height of RGB_floats are parsed, and
+ *            nothing is when RGB_floats is empty
+ * Error:     Runtime error if a NULL pointer is passed in, if the PPM is
+ *            binary, if nthreads is 0, if RGB_floats is larger than the
+ *            image, if the text holds anything but digits and white space,
+ *            a sample larger than the maxval or too few samples, or if a
+ *            thread cannot be created
+ */
+void P3_map_parse(PPM_map_T map, Planar_T RGB_floats, const float *to_float,
+                  unsigned nthreads)
+{
+        assert(map != NULL && RGB_floats != NULL && to_float != NULL);
+        assert(nthreads > 0);
+        unsigned width = PPM_map_width(map);
+        unsigned height = PPM_map_height(map);
+        assert((unsigned)Planar_width(RGB_floats) <= width);
+        assert((unsigned)Planar_height(RGB_floats) <= height);
+
+        /* nothing to store, and a width of 0 leaves no rows to step
+           through */
+        if (Planar_width(RGB_floats) == 0 || Planar_height(RGB_floats) == 0) {
+                return;
+        }
+
+        size_t length;
+        const unsigned char *text = PPM_map_text(map, &length);
+        int nchunks = nthreads;
+        if (length / MIN_CHUNK_BYTES < (size_t)nchunks) {
+                nchunks = length / MIN_CHUNK_BYTES + 1;
+        }
+
+        struct Chunk *chunks = malloc(nchunks * sizeof(*chunks));
+        assert(chunks != NULL);
+
+        /* cut just after white space, so that every number lies in one
+           chunk */
+        const unsigned char *end = text + length;
+        const unsigned char *begin = text;
+        int i;
+        for (i = 0; i < nchunks; i++) {
+                const unsigned char *cut = text + length * (i + 1) / nchunks;
+                if (cut < begin) {
+                        cut = begin;
+                }
+                while (cut < end && !isspace(cut[-1])) {
+                        cut++;
+                }
+                chunks[i].begin = begin;
+                chunks[i].end = cut;
+                chunks[i].width = width;
+                chunks[i].denominator = PPM_map_denominator(map);
+                chunks[i].planar = RGB_floats;
+                chunks[i].to_float = to_float;
+                begin = cut;
+        }
+
+        run_chunks(chunks, nchunks, count_chunk);
+
+        size_t first = 0;
+        for (i = 0; i < nchunks; i++) {
+                chunks[i].first = first;
+                first += chunks[i].count;
+        }
+        assert(first >= (size_t)width * height * 3);
+
+        run_chunks(chunks, nchunks, parse_chunk);
+
+        free(chunks);
+}
+
+/* FUNCTION:  run_chunks
+ * Purpose:   Runs a function over every chunk, one thread per chunk
+ * Arg:       chunks: the chunks
+ *            nchunks: the number of chunks
+ *            fun: the function, given a pointer to its chunk
+ * Returns:   N/A
+ * Effect:    The first chunk runs on the calling thread; returns when every
+ *            chunk is done
+ * Error:     Runtime error if a thread cannot be created
+ */
+static void run_chunks(struct Chunk *chunks, int nchunks,
+                       void *(*fun)(void *))
+{
+        pthread_t *threads = malloc(nchunks * sizeof(*threads));
+        assert(threads != NULL);
+
+        int i, err;
+        for (i = 1; i < nchunks; i++) {
+                err = pthread_create(&threads[i], NULL, fun, &chunks[i]);
+                assert(err == 0);
+        }
+        fun(&chunks[0]);
+        for (i = 1; i < nchunks; i++) {
+                err = pthread_join(threads[i], NULL);
+                assert(err == 0);
+        }
+
+        free(threads);
+}
+
+/* FUNCTION:  count_chunk
+ * Purpose:   Counts the numbers that start in a chunk
+ * Arg:       cl: pointer to the chunk
+ * Returns:   NULL
+ * Effect:    Sets the count of the chunk. A number starts at every digit
+ *            that does not follow a digit; the first byte of a chunk always
+ *            follows white space
+ * Error:     N/A
+ */
+static void *count_chunk(void *cl)
+{
+        struct Chunk *chunk = cl;
+        const unsigned char *p = chunk->begin;
+        size_t n = chunk->end - chunk->begin;
+
+        size_t count = 0;
+        bool previous = false;
+        size_t i;
+        for (i = 0; i < n; i++) {
+                bool digit = is_digit(p[i]);
+                count += digit & !previous;
+                previous = digit;
+        }
+
+        chunk->count = count;
+
+        return NULL;
+}
+
+/* FUNCTION:  parse_chunk
+ * Purpose:   Parses the numbers of a chunk into the planar image
+ * Arg:       cl: pointer to the chunk, with first set
+ * Returns:   NULL
+ * Effect:    Stores the samples that fall in the planar image; stops at the
+ *            end of the last row of the planar image
+ * Error:     Runtime error if the chunk holds anything but digits and white
+ *            space, or a sample larger than the maxval
+ */
+static void *parse_chunk(void *cl)
+{
+        struct Chunk *chunk = cl;
+        unsigned width = Planar_width(chunk->planar);
+        unsigned height = Planar_height(chunk->planar);
+        unsigned denominator = chunk->denominator;
+
+        /* position of the first sample of the chunk in the image */
+        size_t pixel = chunk->first / 3;
+        unsigned channel = chunk->first % 3;
+        unsigned row = pixel / chunk->width;
+        unsigned col = pixel % chunk->width;
+        float *planes[3] = { NULL, NULL, NULL };
+        unsigned c;
+        for (c = 0; c < 3 && row < height; c++) {
+                planes[c] = Planar_row(chunk->planar, c, row);
+        }
+
+        const unsigned char *p = chunk->begin;
+        const unsigned char *end = chunk->end;
+        while (p < end && row < height) {
+                if (!is_digit(*p)) {
+                        assert(isspace(*p));
+                        p++;
+                        continue;
+                }
+
+                unsigned value = 0;
+                while (p < end && is_digit(*p)) {
+                        value = value * 10 + (*p - '0');
+                        assert(value <= denominator);
+                        p++;
+                }
+
+                if (col < width) {
+                        planes[channel][col] = chunk->to_float[value];
+                }
+
+                /* next sample: channel, then column, then row */
+                if (++channel < 3) {
+                        continue;
+                }
+                channel = 0;
+                if (++col < chunk->width) {
+                        continue;
+                }
+                col = 0;
+                row++;
+                for (c = 0; c < 3 && row < height; c++) {
+                        planes[c] = Planar_row(chunk->planar, c, row);
+                }
+        }
+
+        return NULL;
+}
+
+/* FUNCTION:  is_digit
+ * Purpose:   Tells whether a byte is a decimal digit
+ * Arg:       c: the byte
+ * Returns:   true for '0' to '9'
+ * Effect:    A single unsigned comparison, unlike isdigit
+ * Error:     N/A
+ */
+static inline bool is_digit(unsigned char c)
+{
+        return (unsigned char)(c - '0') < 10;
+}
+
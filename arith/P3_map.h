@@ -0,0 +1,44 @@
+/*****************************************************************************
+ *
+ *                                  P3_map.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our P3_map module. The purpose of this
+ *     module is to read a plain (P3) PPM much faster than one number at a
+ *     time: once PPM_map has mapped the file and parsed its header, the 
+ *     text of the samples is cut into chunks at white space, and the chunks
+ *     are parsed by several threads at once, straight into the planes of a
+ *     planar image.
+ *
+ *****************************************************************************/
+#include "Planar.h"
+#include "PPM_map.h"
+
+#ifndef P3MAP_INCLUDED
+#define P3MAP_INCLUDED
+
+/* FUNCTION:  P3_map_parse
+ * Purpose:   Parses the samples of the top left corner of the image into a
+ *            planar image
+ * Arg:       map: an initialized PPM_map_T of a plain PPM
+ *            RGB_floats: a planar image with red, green and blue planes,
+ *                        no larger than the image; it receives its
+ *                        width by height corner of the image
+ *            to_float: the float of every sample value from 0 to the maxval
+ *            nthreads: the number of threads to parse with
+ * Returns:   N/A
+ * Effect:    Samples outside the corner are checked but not stored
+ * Error:     Runtime error if a NULL pointer is passed in, if the PPM is
+ *            binary, if nthreads is 0, if RGB_floats is larger than the
+ *            image, if the text holds anything but digits and white space,
+ *            a sample larger than the maxval or too few samples, or if a
+ *            thread cannot be created
+ */
+extern void P3_map_parse(PPM_map_T map, Planar_T RGB_floats, 
+                         const float *to_float, unsigned nthreads);
+
+#endif
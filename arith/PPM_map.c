@@ -0,0 +1,294 @@
+/*****************************************************************************
+ *
+ *                                 PPM_map.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our PPM_map module. The whole
+ *     file is mapped read only, with a sequential access hint for a binary
+ *     PPM, whose rows are converted in order, and a will need hint for a
+ *     plain one, whose text is parsed by several threads at once. The
+ *     header, which is the same in both but for the magic number, is parsed
+ *     in place and the samples are never copied.
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <ctype.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "PPM_map.h"
+
+#define T PPM_map_T
+
+/* largest denominator allowed by the PPM format */
+#define MAX_DENOMINATOR 65535
+
+/*
+ * base, length: the mapping of the whole file
+ * plain:        whether the PPM is plain (P3) rather than binary (P6)
+ * pixels:       first byte after the header
+ * width, height, denominator: values from the header
+ * sample_bytes: 1 or 2 bytes per sample of a binary PPM
+ * row_bytes:    bytes in each row of samples of a binary PPM
+ */
+struct T {
+        unsigned char *base;
+        size_t length;
+        bool plain;
+        const unsigned char *pixels;
+        unsigned width, height, denominator;
+        unsigned sample_bytes;
+        size_t row_bytes;
+};
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static size_t   skip_space(const unsigned char *bytes, size_t length,
+                           size_t i);
+static unsigned read_number(const unsigned char *bytes, size_t length,
+                            size_t *i);
+
+/* FUNCTION:  PPM_map_open
+ * Purpose:   Maps a binary or plain PPM into memory and parses its header
+ * Arg:       file: an opened file, positioned at the start of the PPM
+ * Returns:   A new PPM_map_T, or NULL if file is not a regular file, cannot
+ *            be mapped, or does not start with the P6 or P3 magic number
+ * Effect:    The mapping lasts until PPM_map_free; the position of file is
+ *            not changed, so it can still be read on a NULL return
+ * Error:     Runtime error if file is NULL, if a header is malformed or if
+ *            a binary PPM is shorter than its header says
+ */
+T PPM_map_open(FILE *file)
+{
+        assert(file != NULL);
+
+        /* only a regular file that has not been read from can be mapped */
+        struct stat info;
+        int fd = fileno(file);
+        if (fd < 0 || fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) ||
+            info.st_size < 2 || ftell(file) != 0) {
+                return NULL;
+        }
+
+        size_t length = info.st_size;
+        void *base = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) {
+                return NULL;
+        }
+
+        unsigned char *bytes = base;
+        if (bytes[0] != 'P' || (bytes[1] != '6' && bytes[1] != '3')) {
+                munmap(base, length);
+                return NULL;
+        }
+        bool plain = bytes[1] == '3';
+        madvise(base, length, plain ? MADV_WILLNEED : MADV_SEQUENTIAL);
+
+        T map = malloc(sizeof(*map));
+        assert(map != NULL);
+        map->base = base;
+        map->length = length;
+        map->plain = plain;
+
+        /* width, height and denominator, then one whitespace character
+           before the samples (or their text, which may start with more) */
+        size_t i = 2;
+        map->width = read_number(bytes, length, &i);
+        map->height = read_number(bytes, length, &i);
+        map->denominator = read_number(bytes, length, &i);
+        assert(map->denominator > 0 && map->denominator <= MAX_DENOMINATOR);
+        assert(i < length && isspace(bytes[i]));
+        i++;
+        map->pixels = bytes + i;
+
+        map->sample_bytes = map->denominator < 256 ? 1 : 2;
+        map->row_bytes = (size_t)map->width * 3 * map->sample_bytes;
+        /* divide rather than multiply, which could wrap for a large
+           header */
+        assert(plain || map->row_bytes == 0 ||
+               map->height <= (length - i) / map->row_bytes);
+
+        return map;
+}
+
+/* FUNCTION:  PPM_map_free
+ * Purpose:   Unmaps the file and deallocates a PPM_map_T
+ * Arg:       map: the address of an initialized PPM_map_T
+ * Returns:   N/A
+ * Effect:    Sets *map to NULL; pointers into the file become invalid
+ * Error:     Runtime error if map or *map is NULL
+ */
+void PPM_map_free(T *map)
+{
+        assert(map != NULL);
+        assert(*map != NULL);
+
+        munmap((*map)->base, (*map)->length);
+        free(*map);
+
+        *map = NULL;
+}
+
+/* FUNCTION:  PPM_map_plain
+ * Purpose:   Tells whether the PPM is plain rather than binary
+ * Arg:       map: an initialized PPM_map_T
+ * Returns:   true for a plain PPM
+ * Effect:    N/A
+ * Error:     Runtime error if map is NULL
+ */
+bool PPM_map_plain(T map)
+{
+        assert(map != NULL);
+        return map->plain;
+}
+
+/* FUNCTION:  PPM_map_width
+ * Purpose:   Returns the width from the header
+ * Arg:       map: an initialized PPM_map_T
+ * Returns:   The width in pixels
+ * Effect:    N/A
+ * Error:     Runtime error if map is NULL
+ */
+unsigned PPM_map_width(T map)
+{
+        assert(map != NULL);
+        return map->width;
+}
+
+/* FUNCTION:  PPM_map_height
+ * Purpose:   Returns the height from the header
+ * Arg:       map: an initialized PPM_map_T
+ * Returns:   The height in pixels
+ * Effect:    N/A
+ * Error:     Runtime error if map is NULL
+ */
+unsigned PPM_map_height(T map)
+{
+        assert(map != NULL);
+        return map->height;
+}
+
+/* FUNCTION:  PPM_map_denominator
+ * Purpose:   Returns the maxval from the header
+ * Arg:       map: an initialized PPM_map_T
+ * Returns:   The denominator of every sample
+ * Effect:    N/A
+ * Error:     Runtime error if map is NULL
+ */
+unsigned PPM_map_denominator(T map)
+{
+        assert(map != NULL);
+        return map->denominator;
+}
+
+/* FUNCTION:  PPM_map_text
+ * Purpose:   Returns the text of the samples of a plain PPM
+ * Arg:       map: an initialized PPM_map_T of a plain PPM
+ *            length: receives the number of bytes of text
+ * Returns:   Pointer into the mapped file, just after the header
+ * Effect:    N/A
+ * Error:     Runtime error if a NULL pointer is passed in or if the PPM is
+ *            binary
+ */
+const unsigned char *PPM_map_text(T map, size_t *length)
+{
+        assert(map != NULL && length != NULL);
+        assert(map->plain);
+
+        *length = map->base + map->length - map->pixels;
+        return map->pixels;
+}
+
+/* FUNCTION:  PPM_map_sample_bytes
+ * Purpose:   Returns the number of bytes in each sample of a binary PPM
+ * Arg:       map: an initialized PPM_map_T of a binary PPM
+ * Returns:   1 or 2
+ * Effect:    N/A
+ * Error:     Runtime error if map is NULL or the PPM is plain
+ */
+unsigned PPM_map_sample_bytes(T map)
+{
+        assert(map != NULL);
+        assert(!map->plain);
+        return map->sample_bytes;
+}
+
+/* FUNCTION:  PPM_map_row
+ * Purpose:   Returns a pointer to the raw samples of a row of a binary PPM
+ * Arg:       map: an initialized PPM_map_T of a binary PPM
+ *            row: index of the row
+ * Returns:   Pointer into the mapped file
+ * Effect:    N/A
+ * Error:     Runtime error if map is NULL, if the PPM is plain or if row is
+ *            out of range
+ */
+const unsigned char *PPM_map_row(T map, unsigned row)
+{
+        assert(map != NULL);
+        assert(!map->plain);
+        assert(row < map->height);
+
+        return map->pixels + row * map->row_bytes;
+}
+
+/* FUNCTION:  skip_space
+ * Purpose:   Skips whitespace and comments in a PPM header
+ * Arg:       bytes: the mapped file
+ *            length: the length of the file
+ *            i: the index to start at
+ * Returns:   The index of the next character that is not whitespace or part
+ *            of a comment, or length
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static size_t skip_space(const unsigned char *bytes, size_t length, size_t i)
+{
+        while (i < length) {
+                if (bytes[i] == '#') {
+                        /* a comment runs to the end of the line */
+                        while (i < length && bytes[i] != '\n') {
+                                i++;
+                        }
+                } else if (isspace(bytes[i])) {
+                        i++;
+                } else {
+                        break;
+                }
+        }
+
+        return i;
+}
+
+/* FUNCTION:  read_number
+ * Purpose:   Reads one decimal number from a PPM header
+ * Arg:       bytes: the mapped file
+ *            length: the length of the file
+ *            i: pointer to the index to start at
+ * Returns:   The number
+ * Effect:    Advances *i to the character after the number
+ * Error:     Runtime error if there is no number or it does not fit in 32
+ *            bits
+ */
+static unsigned read_number(const unsigned char *bytes, size_t length,
+                            size_t *i)
+{
+        size_t j = skip_space(bytes, length, *i);
+        assert(j < length && isdigit(bytes[j]));
+
+        unsigned long long n = 0;
+        while (j < length && isdigit(bytes[j])) {
+                n = n * 10 + (bytes[j] - '0');
+                assert(n <= 0xffffffffULL);
+                j++;
+        }
+
+        *i = j;
+        return n;
+}
@@ -0,0 +1,106 @@
+/*****************************************************************************
+ *
+ *                                 PPM_map.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our PPM_map module. The purpose of
+ *     this module is to read a PPM without copying it: the file is mapped
+ *     into memory, its header is parsed, and the caller gets pointers
+ *     straight into the samples. A binary (P6) PPM gives its raw rows of
+ *     samples; a plain (P3) PPM gives the text of its samples, which
+ *     P3_map parses. Files that cannot be mapped (pipes, other formats) are
+ *     left untouched so that the caller can fall back to Pnm_ppmread.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifndef PPMMAP_INCLUDED
+#define PPMMAP_INCLUDED
+
+#define T PPM_map_T
+typedef struct T *T;
+
+/* FUNCTION:  PPM_map_open
+ * Purpose:   Maps a binary or plain PPM into memory and parses its header
+ * Arg:       file: an opened file, positioned at the start of the PPM
+ * Returns:   A new PPM_map_T, or NULL if file is not a regular file, cannot
+ *            be mapped, or does not start with the P6 or P3 magic number
+ * Effect:    The mapping lasts until PPM_map_free; the position of file is
+ *            not changed, so it can still be read on a NULL return
+ * Error:     Runtime error if file is NULL, if a header is malformed or if
+ *            a binary PPM is shorter than its header says
+ */
+extern T PPM_map_open(FILE *file);
+
+/* FUNCTION:  PPM_map_free
+ * Purpose:   Unmaps the file and deallocates a PPM_map_T
+ * Arg:       map: the address of an initialized PPM_map_T
+ * Returns:   N/A
+ * Effect:    Sets *map to NULL; pointers into the file become invalid
+ * Error:     Runtime error if map or *map is NULL
+ */
+extern void PPM_map_free(T *map);
+
+/* FUNCTION:  PPM_map_plain
+ * Purpose:   Tells whether the PPM is plain (P3) rather than binary (P6)
+ * Arg:       map: an initialized PPM_map_T
+ * Returns:   true for a plain PPM
+ * Effect:    N/A
+ * Error:     Runtime error if map is NULL
+ */
+extern bool PPM_map_plain(T map);
+
+/* FUNCTION:  PPM_map_width, PPM_map_height, PPM_map_denominator
+ * Purpose:   Return the width, height and maxval from the header
+ * Arg:       map: an initialized PPM_map_T
+ * Returns:   The requested value
+ * Effect:    N/A
+ * Error:     Runtime error if map is NULL
+ */
+extern unsigned PPM_map_width(T map);
+extern unsigned PPM_map_height(T map);
+extern unsigned PPM_map_denominator(T map);
+
+/* FUNCTION:  PPM_map_text
+ * Purpose:   Returns the text of the samples of a plain PPM
+ * Arg:       map: an initialized PPM_map_T of a plain PPM
+ *            length: receives the number of bytes of text
+ * Returns:   Pointer into the mapped file, just after the white space that
+ *            ends the header; the text runs to the end of the file
+ * Effect:    N/A
+ * Error:     Runtime error if a NULL pointer is passed in or if the PPM is
+ *            binary
+ */
+extern const unsigned char *PPM_map_text(T map, size_t *length);
+
+/* FUNCTION:  PPM_map_sample_bytes
+ * Purpose:   Returns the number of bytes in each sample of a binary PPM: 1
+ *            when the denominator is below 256 and 2 (most significant
+ *            byte first) otherwise
+ * Arg:       map: an initialized PPM_map_T of a binary PPM
+ * Returns:   1 or 2
+ * Effect:    N/A
+ * Error:     Runtime error if map is NULL or the PPM is plain
+ */
+extern unsigned PPM_map_sample_bytes(T map);
+
+/* FUNCTION:  PPM_map_row
+ * Purpose:   Returns a pointer to the raw samples of a row of a binary PPM;
+ *            each pixel is a red, a green and a blue sample
+ * Arg:       map: an initialized PPM_map_T of a binary PPM
+ *            row: index of the row
+ * Returns:   Pointer into the mapped file
+ * Effect:    N/A
+ * Error:     Runtime error if map is NULL, if the PPM is plain or if row is
+ *            out of range
+ */
+extern const unsigned char *PPM_map_row(T map, unsigned row);
+
+#undef T
+#endif
@@ -0,0 +1,231 @@
+/*****************************************************************************
+ *
+ *                                 Pipeline.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Pipeline module. A band is
+ *     BAND_ROWS rows of 2 by 2 blocks. The reader thread fills the RGB
+ *     floats of each band from a ppm_RGBfloats stream and queues it; the
+ *     transform thread turns it into codewords through Row_bands, with as
+ *     many worker threads as asked for, and queues it again; the calling
+ *     thread writes the bands in order. Every block is independent, so the
+ *     codewords of a band are the same as those of the same rows of the
+ *     whole image.
+ *
+ *****************************************************************************/
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "Pipeline.h"
+#include "Band_queue.h"
+#include "Planar.h"
+#include "uarray2.h"
+
+/* the modules that read, compress and write each band */
+#include "ppm_RGBfloats.h"
+#include "Row_bands.h"
+#include "Codewords_File.h"
+#include "Codewords_rANS.h"
+
+/* rows of 2 by 2 blocks in each band */
+#define BAND_ROWS 16
+
+/* bands that may wait in each queue */
+#define QUEUE_BANDS 4
+
+/*
+ * one band of the image
+ * first_row:  the first row of 2 by 2 blocks of the band
+ * rgb_floats: the pixels, until the band is compressed
+ * codewords:  the codewords, once the band is compressed
+ */
+struct Band {
+        int first_row;
+        Planar_T rgb_floats;
+        UArray2_T codewords;
+};
+
+/*
+ * The state shared by the three threads
+ * stream:     the PPM being read
+ * block_rows: number of rows of 2 by 2 blocks in the image
+ * nthreads:   worker threads for the stages of each band
+ * parsed:     bands read, waiting to be compressed
+ * packed:     bands compressed, waiting to be written
+ */
+struct Pipeline {
+        ppm_RGBfloats_stream_T stream;
+        int block_rows;
+        unsigned nthreads;
+        Band_queue_T parsed;
+        Band_queue_T packed;
+};
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static void     *read_bands(void *cl);
+static void     *compress_bands(void *cl);
+static void      paste_band(UArray2_T band, UArray2_T codewords, int row);
+
+/* FUNCTION:  Pipeline_compress
+ * Purpose:   Compresses a PPM with reading, compressing and writing
+ *            running at the same time
+ * Arg:       input: pointer to a binary or plain PPM; it can be a pipe
+ *            output: pointer to a file open for writing
+ *            nthreads: worker threads that share the stages of each band
+ *            entropy: whether to write the entropy coded format
+ * Returns:   The size of the image in 8 bit pixels, after trimming
+ * Effect:    The calling thread is the writer. In the fixed size format
+ *            each band is written as soon as it arrives; the entropy coded
+ *            format collects every band first
+ * Error:     Runtime error if a NULL pointer is passed in, if nthreads is
+ *            0, if input is not a PPM or if a thread cannot be created
+ */
+size_t Pipeline_compress(FILE *input, FILE *output, unsigned nthreads,
+                         bool entropy)
+{
+        assert(input != NULL && output != NULL);
+        assert(nthreads > 0);
+
+        struct Pipeline pipeline;
+        pipeline.stream = ppm_RGBfloats_stream_open(input);
+        pipeline.nthreads = nthreads;
+        pipeline.parsed = Band_queue_new(QUEUE_BANDS);
+        pipeline.packed = Band_queue_new(QUEUE_BANDS);
+
+        int width = ppm_RGBfloats_stream_width(pipeline.stream);
+        int height = ppm_RGBfloats_stream_height(pipeline.stream);
+        pipeline.block_rows = width > 0 ? height / 2 : 0;
+
+        UArray2_T codewords = NULL;
+        if (entropy) {
+                codewords = UArray2_new(width / 2, height / 2,
+                                        sizeof(uint64_t));
+        } else {
+                Codewords_File_write_header(output, width, height);
+        }
+
+        pthread_t reader, transformer;
+        int err = pthread_create(&reader, NULL, read_bands, &pipeline);
+        assert(err == 0);
+        err = pthread_create(&transformer, NULL, compress_bands, &pipeline);
+        assert(err == 0);
+
+        struct Band *band;
+        while ((band = Band_queue_pop(pipeline.packed)) != NULL) {
+                if (entropy) {
+                        paste_band(band->codewords, codewords,
+                                   band->first_row);
+                } else {
+                        Codewords_File_write_rows(band->codewords, output);
+                }
+                UArray2_free(&band->codewords);
+                free(band);
+        }
+
+        err = pthread_join(reader, NULL);
+        assert(err == 0);
+        err = pthread_join(transformer, NULL);
+        assert(err == 0);
+
+        if (entropy) {
+                Codewords_rANS_write(codewords, output);
+        }
+
+        Band_queue_free(&pipeline.parsed);
+        Band_queue_free(&pipeline.packed);
+        ppm_RGBfloats_stream_free(&pipeline.stream);
+
+        return (size_t)width * height * 3;
+}
+
+/* FUNCTION:  read_bands
+ * Purpose:   Body of the reader thread
+ * Arg:       cl: pointer to the shared Pipeline
+ * Returns:   NULL
+ * Effect:    Reads every band, top to bottom, into the parsed queue, then
+ *            closes it
+ * Error:     Runtime error if memory cannot be allocated
+ */
+static void *read_bands(void *cl)
+{
+        struct Pipeline *pipeline = cl;
+        int width = ppm_RGBfloats_stream_width(pipeline->stream);
+
+        int first;
+        for (first = 0; first < pipeline->block_rows; first += BAND_ROWS) {
+                int nrows = pipeline->block_rows - first;
+                if (nrows > BAND_ROWS) {
+                        nrows = BAND_ROWS;
+                }
+
+                struct Band *band = malloc(sizeof(*band));
+                assert(band != NULL);
+                band->first_row = first;
+                band->rgb_floats = Planar_new(width, nrows * 2, 3);
+                band->codewords = NULL;
+                ppm_RGBfloats_stream_read(pipeline->stream,
+                                          band->rgb_floats);
+
+                Band_queue_push(pipeline->parsed, band);
+        }
+
+        Band_queue_close(pipeline->parsed);
+
+        return NULL;
+}
+
+/* FUNCTION:  compress_bands
+ * Purpose:   Body of the transform thread
+ * Arg:       cl: pointer to the shared Pipeline
+ * Returns:   NULL
+ * Effect:    Moves every band from the parsed queue to the packed queue,
+ *            replacing its pixels with its codewords, then closes the
+ *            packed queue
+ * Error:     N/A
+ */
+static void *compress_bands(void *cl)
+{
+        struct Pipeline *pipeline = cl;
+
+        struct Band *band;
+        while ((band = Band_queue_pop(pipeline->parsed)) != NULL) {
+                band->codewords = Row_bands_compress(band->rgb_floats,
+                                                     pipeline->nthreads, 
+                                                     NULL);
+                band->rgb_floats = NULL;
+                Band_queue_push(pipeline->packed, band);
+        }
+
+        Band_queue_close(pipeline->packed);
+
+        return NULL;
+}
+
+/* FUNCTION:  paste_band
+ * Purpose:   Copies the codewords of a band into the codewords of the whole
+ *            image
+ * Arg:       band: the codewords of the band
+ *            codewords: the codewords of the image, as wide as band
+ *            row: the row of codewords where the band starts
+ * Returns:   N/A
+ * Effect:    Overwrites the rows of codewords that belong to the band
+ * Error:     N/A
+ */
+static void paste_band(UArray2_T band, UArray2_T codewords, int row)
+{
+        int width = UArray2_width(band);
+        int i;
+        for (i = 0; width > 0 && i < UArray2_height(band); i++) {
+                memcpy(UArray2_row(codewords, row + i), UArray2_row(band, i),
+                       width * sizeof(uint64_t));
+        }
+}
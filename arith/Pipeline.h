@@ -0,0 +1,43 @@
+/*****************************************************************************
+ *
+ *                                 Pipeline.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Pipeline module. The purpose of
+ *     this module is to overlap reading and writing with computing when
+ *     compressing (40image -c --pipeline). Three threads are connected by
+ *     bounded queues of bands of rows: one parses the PPM a band at a time,
+ *     one runs the stages from RGBfloats_CV to DCTints_codewords over each
+ *     band, and one writes the codewords of each band as soon as they are
+ *     ready. The output is identical to that of compress40.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifndef PIPELINE_INCLUDED
+#define PIPELINE_INCLUDED
+
+/* FUNCTION:  Pipeline_compress
+ * Purpose:   Compresses a PPM with reading, compressing and writing
+ *            running at the same time
+ * Arg:       input: pointer to a binary or plain PPM; it can be a pipe
+ *            output: pointer to a file open for writing
+ *            nthreads: worker threads that share the stages of each band
+ *            entropy: whether to write the entropy coded format
+ * Returns:   The size of the image in 8 bit pixels (width x height x 3
+ *            bytes, after trimming), for throughput reports
+ * Effect:    At most a few bands are in memory at once, except that the
+ *            entropy coded format needs every codeword before it writes
+ * Error:     Runtime error if a NULL pointer is passed in, if nthreads is
+ *            0, if input is not a PPM or if a thread cannot be created
+ */
+size_t Pipeline_compress(FILE *input, FILE *output, unsigned nthreads,
+                         bool entropy);
+
+#endif
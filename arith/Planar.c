@@ -0,0 +1,368 @@
+/*****************************************************************************
+ *
+ *                                  Planar.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Planar module. All the
+ *     planes of an image live in one aligned allocation, one plane after
+ *     the other; each plane is height rows of stride floats. An arena is a
+ *     small list of such allocations kept for reuse by one thread. Images
+ *     too big for memory are mapped from a temporary file by Map_store
+ *     and never go through an arena.
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdbool.h>
+#include "Planar.h"
+#include "Map_store.h"
+
+#define T Planar_T
+
+/* rows start on this boundary, in bytes, which suits AVX2 loads */
+#define ALIGNMENT 32
+
+/* rows are padded to a multiple of this many floats */
+#define ROW_FLOATS (ALIGNMENT / sizeof(float))
+
+/* most allocations an arena keeps; a compression has at most three images
+   alive at once */
+#define ARENA_SLOTS 4
+
+/*
+ * width, height: dimensions of each plane
+ * nplanes:       number of planes
+ * stride:        floats from the start of one row to the start of the next
+ * floats:        the planes, one after the other
+ * capacity:      number of floats allocated, at least stride * height *
+ *                nplanes when the allocation came from an arena
+ * mapped:        whether floats was mapped by Map_store
+ */
+struct T {
+        int width;
+        int height;
+        int nplanes;
+        int stride;
+        float *floats;
+        size_t capacity;
+        bool mapped;
+};
+
+/*
+ * count:    number of kept allocations
+ * floats:   the kept allocations
+ * capacity: the number of floats of each
+ */
+struct Planar_arena {
+        int count;
+        float *floats[ARENA_SLOTS];
+        size_t capacity[ARENA_SLOTS];
+};
+
+/* arena of the calling thread, or NULL */
+static __thread Planar_arena_T thread_arena = NULL;
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static float *arena_take(Planar_arena_T arena, size_t *nfloats);
+static void   arena_keep(Planar_arena_T arena, float *floats, 
+                         size_t nfloats);
+
+/* FUNCTION:  Planar_new
+ * Purpose:   Allocates a new planar image of floats
+ * Arg:       width: non-negative number of columns
+ *            height: non-negative number of rows
+ *            nplanes: positive number of planes
+ * Returns:   A pointer to the new image; the floats are not initialized
+ * Effect:    Allocates memory for the image
+ * Error:     Runtime error for negative dimensions, for nplanes < 1, or if
+ *            memory cannot be allocated
+ */
+T Planar_new(int width, int height, int nplanes)
+{
+        assert(width >= 0);
+        assert(height >= 0);
+        assert(nplanes > 0);
+
+        T planar = malloc(sizeof(*planar));
+        assert(planar != NULL);
+
+        planar->width = width;
+        planar->height = height;
+        planar->nplanes = nplanes;
+        planar->stride = (width + ROW_FLOATS - 1) / ROW_FLOATS * ROW_FLOATS;
+
+        /* allocate at least one row so that the pointer is never NULL */
+        size_t nfloats = (size_t)planar->stride * height * nplanes;
+        if (nfloats == 0) {
+                nfloats = ROW_FLOATS;
+        }
+        planar->floats = Map_store_alloc(nfloats * sizeof(float));
+        planar->mapped = planar->floats != NULL;
+        if (!planar->mapped && thread_arena != NULL) {
+                planar->floats = arena_take(thread_arena, &nfloats);
+        }
+        if (planar->floats == NULL) {
+                int err = posix_memalign((void **)&planar->floats, 
+                                         ALIGNMENT, nfloats * sizeof(float));
+                assert(err == 0);
+        }
+        planar->capacity = nfloats;
+
+        return planar;
+}
+
+/* FUNCTION:  Planar_free
+ * Purpose:   Deallocates a planar image and clears *planar
+ * Arg:       planar: the address of an initialized image
+ * Returns:   N/A
+ * Effect:    Deallocates memory and sets *planar to NULL
+ * Error:     Runtime error if planar or *planar is NULL
+ */
+void Planar_free(T *planar)
+{
+        assert(planar != NULL);
+        assert(*planar != NULL);
+
+        if ((*planar)->mapped) {
+                Map_store_free((*planar)->floats, 
+                               (*planar)->capacity * sizeof(float));
+        } else if (thread_arena != NULL) {
+                arena_keep(thread_arena, (*planar)->floats, 
+                           (*planar)->capacity);
+        } else {
+                free((*planar)->floats);
+        }
+        free(*planar);
+
+        *planar = NULL;
+}
+
+/* FUNCTION:  Planar_width
+ * Purpose:   Returns the number of columns of an image
+ * Arg:       planar: an initialized image
+ * Returns:   The width
+ * Effect:    N/A
+ * Error:     Runtime error if planar is NULL
+ */
+int Planar_width(T planar)
+{
+        assert(planar != NULL);
+        return planar->width;
+}
+
+/* FUNCTION:  Planar_height
+ * Purpose:   Returns the number of rows of an image
+ * Arg:       planar: an initialized image
+ * Returns:   The height
+ * Effect:    N/A
+ * Error:     Runtime error if planar is NULL
+ */
+int Planar_height(T planar)
+{
+        assert(planar != NULL);
+        return planar->height;
+}
+
+/* FUNCTION:  Planar_nplanes
+ * Purpose:   Returns the number of planes of an image
+ * Arg:       planar: an initialized image
+ * Returns:   The number of planes
+ * Effect:    N/A
+ * Error:     Runtime error if planar is NULL
+ */
+int Planar_nplanes(T planar)
+{
+        assert(planar != NULL);
+        return planar->nplanes;
+}
+
+/* FUNCTION:  Planar_stride
+ * Purpose:   Returns the distance, in floats, between the starts of two
+ *            consecutive rows of a plane
+ * Arg:       planar: an initialized image
+ * Returns:   The stride; a multiple of 8 that is at least the width
+ * Effect:    N/A
+ * Error:     Runtime error if planar is NULL
+ */
+int Planar_stride(T planar)
+{
+        assert(planar != NULL);
+        return planar->stride;
+}
+
+/* FUNCTION:  Planar_row
+ * Purpose:   Returns a pointer to the first float of a row of a plane
+ * Arg:       planar: an initialized image
+ *            plane: index of the plane
+ *            row: index of the row
+ * Returns:   Pointer to the row
+ * Effect:    N/A
+ * Error:     Runtime error if planar is NULL or plane or row is out of range
+ */
+float *Planar_row(T planar, int plane, int row)
+{
+        assert(planar != NULL);
+        assert(plane >= 0 && plane < planar->nplanes);
+        assert(row >= 0 && row < planar->height);
+
+        size_t offset = ((size_t)plane * planar->height + row) *
+                        planar->stride;
+
+        return planar->floats + offset;
+}
+
+/* FUNCTION:  Planar_crop
+ * Purpose:   Copies a rectangle of an image into a new image
+ * Arg:       planar: an initialized image
+ *            col, row: the top left corner of the rectangle
+ *            width, height: the size of the rectangle
+ * Returns:   A new image with the same number of planes
+ * Effect:    planar is not changed
+ * Error:     Runtime error if planar is NULL or the rectangle is not inside
+ *            the image
+ */
+T Planar_crop(T planar, int col, int row, int width, int height)
+{
+        assert(planar != NULL);
+        assert(col >= 0 && width >= 0 && col + width <= planar->width);
+        assert(row >= 0 && height >= 0 && row + height <= planar->height);
+
+        T crop = Planar_new(width, height, planar->nplanes);
+
+        int plane, i;
+        for (plane = 0; plane < planar->nplanes; plane++) {
+                for (i = 0; i < height; i++) {
+                        memcpy(Planar_row(crop, plane, i),
+                               Planar_row(planar, plane, row + i) + col,
+                               width * sizeof(float));
+                }
+        }
+
+        return crop;
+}
+
+/* FUNCTION:  Planar_arena_new
+ * Purpose:   Allocates an empty arena of planes
+ * Arg:       N/A
+ * Returns:   A pointer to the new arena
+ * Effect:    Allocates memory for the arena
+ * Error:     Runtime error if memory cannot be allocated
+ */
+Planar_arena_T Planar_arena_new(void)
+{
+        Planar_arena_T arena = malloc(sizeof(*arena));
+        assert(arena != NULL);
+        arena->count = 0;
+
+        return arena;
+}
+
+/* FUNCTION:  Planar_arena_use
+ * Purpose:   Sets the arena of the calling thread
+ * Arg:       arena: an initialized arena, or NULL for none (the default)
+ * Returns:   N/A
+ * Effect:    Planar_new and Planar_free on this thread go through arena
+ * Error:     N/A
+ */
+void Planar_arena_use(Planar_arena_T arena)
+{
+        thread_arena = arena;
+}
+
+/* FUNCTION:  Planar_arena_free
+ * Purpose:   Deallocates an arena and the planes it keeps
+ * Arg:       arena: the address of an initialized arena that no thread is
+ *                   using
+ * Returns:   N/A
+ * Effect:    Deallocates memory and sets *arena to NULL
+ * Error:     Runtime error if arena or *arena is NULL
+ */
+void Planar_arena_free(Planar_arena_T *arena)
+{
+        assert(arena != NULL);
+        assert(*arena != NULL);
+
+        int i;
+        for (i = 0; i < (*arena)->count; i++) {
+                free((*arena)->floats[i]);
+        }
+        free(*arena);
+
+        *arena = NULL;
+}
+
+/* FUNCTION:  arena_take
+ * Purpose:   Takes the smallest kept allocation that is big enough
+ * Arg:       arena: an initialized arena
+ *            nfloats: the number of floats needed; receives the capacity
+ *                     of the allocation taken
+ * Returns:   The allocation, or NULL if none is big enough
+ * Effect:    Removes the allocation from the arena
+ * Error:     N/A
+ */
+static float *arena_take(Planar_arena_T arena, size_t *nfloats)
+{
+        int best = -1;
+        int i;
+        for (i = 0; i < arena->count; i++) {
+                if (arena->capacity[i] >= *nfloats && 
+                    (best < 0 || arena->capacity[i] < arena->capacity[best])) {
+                        best = i;
+                }
+        }
+        if (best < 0) {
+                return NULL;
+        }
+
+        float *floats = arena->floats[best];
+        *nfloats = arena->capacity[best];
+        arena->count--;
+        arena->floats[best] = arena->floats[arena->count];
+        arena->capacity[best] = arena->capacity[arena->count];
+
+        return floats;
+}
+
+/* FUNCTION:  arena_keep
+ * Purpose:   Keeps an allocation for later use
+ * Arg:       arena: an initialized arena
+ *            floats: the allocation
+ *            nfloats: its capacity
+ * Returns:   N/A
+ * Effect:    When the arena is full, the smallest of its allocations and
+ *            floats is deallocated instead, so the arena tends to hold the
+ *            largest allocations seen
+ * Error:     N/A
+ */
+static void arena_keep(Planar_arena_T arena, float *floats, size_t nfloats)
+{
+        if (arena->count < ARENA_SLOTS) {
+                arena->floats[arena->count] = floats;
+                arena->capacity[arena->count] = nfloats;
+                arena->count++;
+                return;
+        }
+
+        int smallest = 0;
+        int i;
+        for (i = 1; i < ARENA_SLOTS; i++) {
+                if (arena->capacity[i] < arena->capacity[smallest]) {
+                        smallest = i;
+                }
+        }
+        if (arena->capacity[smallest] < nfloats) {
+                free(arena->floats[smallest]);
+                arena->floats[smallest] = floats;
+                arena->capacity[smallest] = nfloats;
+        } else {
+                free(floats);
+        }
+}
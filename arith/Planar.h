@@ -0,0 +1,135 @@
+/*****************************************************************************
+ *
+ *                                  Planar.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Planar module. A Planar_T is a 2
+ *     dimensional image of floats stored as a structure of arrays: each
+ *     channel (red, green and blue; y, pb and pr; or the 6 DCT floats) is a
+ *     separate plane. Every row of every plane starts on a 32 byte boundary
+ *     and is padded to a multiple of 8 floats, so a stage that only needs
+ *     one channel reads only that channel and the SIMD kernels can always
+ *     load whole vectors. Rows are reached through row pointers rather than
+ *     one element at a time.
+ *
+ *     A thread that compresses many images can give itself a
+ *     Planar_arena_T: the planes freed on that thread are then kept and
+ *     handed to later Planar_new calls that fit in them, so after the
+ *     largest image the stages stop allocating.
+ *
+ *****************************************************************************/
+#ifndef PLANAR_INCLUDED
+#define PLANAR_INCLUDED
+
+#define T Planar_T
+typedef struct T *T;
+
+typedef struct Planar_arena *Planar_arena_T;
+
+/* order of the planes of an image of RGB floats; images of CV colors and
+   of DCT floats use the orders given in SIMD_kernels.h */
+enum { PLANAR_RED, PLANAR_GREEN, PLANAR_BLUE };
+
+/* FUNCTION:  Planar_new
+ * Purpose:   Allocates a new planar image of floats
+ * Arg:       width: non-negative number of columns
+ *            height: non-negative number of rows
+ *            nplanes: positive number of planes
+ * Returns:   A pointer to the new image; the floats are not initialized
+ * Effect:    Allocates memory for the image
+ * Error:     Runtime error for negative dimensions, for nplanes < 1, or if
+ *            memory cannot be allocated
+ */
+extern T Planar_new(int width, int height, int nplanes);
+
+/* FUNCTION:  Planar_free
+ * Purpose:   Deallocates a planar image and clears *planar
+ * Arg:       planar: the address of an initialized image
+ * Returns:   N/A
+ * Effect:    Deallocates memory and sets *planar to NULL
+ * Error:     Runtime error if planar or *planar is NULL
+ */
+extern void Planar_free(T *planar);
+
+/* FUNCTION:  Planar_width, Planar_height, Planar_nplanes
+ * Purpose:   Return the number of columns, rows and planes of an image
+ * Arg:       planar: an initialized image
+ * Returns:   The requested count
+ * Effect:    N/A
+ * Error:     Runtime error if planar is NULL
+ */
+extern int Planar_width(T planar);
+extern int Planar_height(T planar);
+extern int Planar_nplanes(T planar);
+
+/* FUNCTION:  Planar_stride
+ * Purpose:   Returns the distance, in floats, between the starts of two
+ *            consecutive rows of a plane
+ * Arg:       planar: an initialized image
+ * Returns:   The stride; a multiple of 8 that is at least the width
+ * Effect:    N/A
+ * Error:     Runtime error if planar is NULL
+ */
+extern int Planar_stride(T planar);
+
+/* FUNCTION:  Planar_row
+ * Purpose:   Returns a pointer to the first float of a row of a plane
+ * Arg:       planar: an initialized image
+ *            plane: index of the plane
+ *            row: index of the row
+ * Returns:   Pointer to the row; the following rows of the same plane come
+ *            after it, Planar_stride floats apart
+ * Effect:    N/A
+ * Error:     Runtime error if planar is NULL or plane or row is out of range
+ */
+extern float *Planar_row(T planar, int plane, int row);
+
+/* FUNCTION:  Planar_crop
+ * Purpose:   Copies a rectangle of an image into a new image
+ * Arg:       planar: an initialized image
+ *            col, row: the top left corner of the rectangle
+ *            width, height: the size of the rectangle
+ * Returns:   A new image with the same number of planes
+ * Effect:    planar is not changed
+ * Error:     Runtime error if planar is NULL or the rectangle is not inside
+ *            the image
+ */
+extern T Planar_crop(T planar, int col, int row, int width, int height);
+
+/* FUNCTION:  Planar_arena_new
+ * Purpose:   Allocates an empty arena of planes
+ * Arg:       N/A
+ * Returns:   A pointer to the new arena
+ * Effect:    Allocates memory for the arena
+ * Error:     Runtime error if memory cannot be allocated
+ */
+extern Planar_arena_T Planar_arena_new(void);
+
+/* FUNCTION:  Planar_arena_use
+ * Purpose:   Sets the arena of the calling thread
+ * Arg:       arena: an initialized arena, or NULL for none (the default)
+ * Returns:   N/A
+ * Effect:    While a thread has an arena, Planar_new on that thread takes
+ *            the smallest kept plane that is big enough, and Planar_free
+ *            keeps the planes instead of deallocating them. An arena must
+ *            not be used by two threads at once
+ * Error:     N/A
+ */
+extern void Planar_arena_use(Planar_arena_T arena);
+
+/* FUNCTION:  Planar_arena_free
+ * Purpose:   Deallocates an arena and the planes it keeps
+ * Arg:       arena: the address of an initialized arena that no thread is
+ *                   using
+ * Returns:   N/A
+ * Effect:    Deallocates memory and sets *arena to NULL
+ * Error:     Runtime error if arena or *arena is NULL
+ */
+extern void Planar_arena_free(Planar_arena_T *arena);
+
+#undef T
+#endif
@@ -0,0 +1,218 @@
+/*****************************************************************************
+ *
+ *                                 Pyramid.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Pyramid module. The sizes
+ *     of the levels are known from the dimensions alone, so the index is
+ *     written first and each level follows as soon as its codewords are
+ *     packed; only the DCT floats of one level and the CV colors of the
+ *     next are alive at once.
+ *
+ *****************************************************************************/
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include "Pyramid.h"
+#include "SIMD_kernels.h"
+
+/* the stages each level goes through */
+#include "RGBfloats_CV.h"
+#include "CV_DCTfloats.h"
+#include "DCTfloats_DCTints.h"
+#include "DCTints_codewords.h"
+#include "Codewords_File.h"
+
+/* bytes of each entry of the index */
+#define ENTRY_BYTES 24
+
+/* bytes read at a time when skipping levels of a file that cannot seek */
+#define SKIP_BYTES 65536
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static Planar_T half_size(Planar_T dct_floats);
+static void     put_be(uint64_t value, unsigned char *bytes, int n);
+static uint64_t get_be(const unsigned char *bytes, int n);
+static void     skip_bytes(FILE *file, uint64_t count);
+
+/* FUNCTION:  Pyramid_write
+ * Purpose:   Compresses an image to the pyramid format
+ * Arg:       rgb_floats: a planar image of RGB floats with even dimensions
+ *            levels: the number of levels wanted, 1 to PYRAMID_MAX_LEVELS
+ *            file: pointer to a file open for writing
+ * Returns:   The number of levels written
+ * Effect:    Writes the header and the index, then each level; recycles
+ *            rgb_floats
+ * Error:     Runtime error if a NULL pointer is passed in, if levels is out
+ *            of range or if the write fails
+ */
+int Pyramid_write(Planar_T rgb_floats, int levels, FILE *file)
+{
+        assert(rgb_floats != NULL && file != NULL);
+        assert(levels >= 1 && levels <= PYRAMID_MAX_LEVELS);
+
+        /* each level keeps the even part of half the level before */
+        unsigned width[PYRAMID_MAX_LEVELS], height[PYRAMID_MAX_LEVELS];
+        width[0] = Planar_width(rgb_floats);
+        height[0] = Planar_height(rgb_floats);
+        int count = 1;
+        while (count < levels && width[count - 1] >= 4 &&
+               height[count - 1] >= 4) {
+                width[count] = width[count - 1] / 4 * 2;
+                height[count] = height[count - 1] / 4 * 2;
+                count++;
+        }
+
+        fprintf(file, "COMP40 Compressed image format %d\n%u %u\n",
+                PYRAMID_FORMAT, width[0], height[0]);
+        putc(count, file);
+        uint64_t offset = 0;
+        int k;
+        for (k = 0; k < count; k++) {
+                unsigned char entry[ENTRY_BYTES];
+                uint64_t length = Codewords_File_bytes(width[k], height[k]);
+                put_be(width[k], entry, 4);
+                put_be(height[k], entry + 4, 4);
+                put_be(offset, entry + 8, 8);
+                put_be(length, entry + 16, 8);
+                size_t written = fwrite(entry, 1, ENTRY_BYTES, file);
+                assert(written == ENTRY_BYTES);
+                offset += length;
+        }
+
+        Planar_T cv_colors = RGBfloats_CV_compress_planar(rgb_floats);
+        for (k = 0; k < count; k++) {
+                Planar_T dct_floats = CV_DCTfloats_compress_planar(cv_colors);
+                if (k + 1 < count) {
+                        cv_colors = half_size(dct_floats);
+                }
+                UArray2_T dct_ints =
+                        DCTfloats_ints_compress_planar(dct_floats);
+                UArray2_T codewords = DCTints_codewords_compress(dct_ints);
+                Codewords_File_write(codewords, file);
+        }
+
+        return count;
+}
+
+/* FUNCTION:  Pyramid_seek
+ * Purpose:   Moves to the image of one level of a pyramid
+ * Arg:       file: pointer to a file, just after the header
+ *            level: the level wanted, 0 for the full size image
+ * Returns:   N/A
+ * Effect:    Reads the index and leaves file at the header of the image of
+ *            the level
+ * Error:     Runtime error if a NULL pointer is passed in, if the pyramid
+ *            has no such level or if the index is not valid
+ */
+void Pyramid_seek(FILE *file, int level)
+{
+        assert(file != NULL);
+
+        int count = getc(file);
+        assert(count >= 1 && count <= PYRAMID_MAX_LEVELS);
+        assert(level >= 0 && level < count);
+
+        unsigned char index[PYRAMID_MAX_LEVELS * ENTRY_BYTES];
+        size_t got = fread(index, ENTRY_BYTES, count, file);
+        assert(got == (size_t)count);
+
+        uint64_t offset = get_be(index + level * ENTRY_BYTES + 8, 8);
+        skip_bytes(file, offset);
+}
+
+/* FUNCTION:  half_size
+ * Purpose:   Gives the CV colors of the next level of a pyramid
+ * Arg:       dct_floats: the DCT floats of a level
+ * Returns:   A planar image with y, pb and pr planes of the dimensions of
+ *            dct_floats: the a, avgPb and avgPr floats of each block
+ * Effect:    dct_floats is not changed
+ * Error:     N/A
+ */
+static Planar_T half_size(Planar_T dct_floats)
+{
+        int width = Planar_width(dct_floats);
+        int height = Planar_height(dct_floats);
+        Planar_T cv_colors = Planar_new(width, height, 3);
+
+        /* a is the mean of the 4 lumas of a block */
+        static const int from[3] = { SIMD_A, SIMD_AVGPB, SIMD_AVGPR };
+        static const int to[3] = { SIMD_Y, SIMD_PB, SIMD_PR };
+        int row, i;
+        for (row = 0; row < height; row++) {
+                for (i = 0; i < 3; i++) {
+                        memcpy(Planar_row(cv_colors, to[i], row),
+                               Planar_row(dct_floats, from[i], row),
+                               width * sizeof(float));
+                }
+        }
+
+        return cv_colors;
+}
+
+/* FUNCTION:  put_be
+ * Purpose:   Stores a value most significant byte first
+ * Arg:       value: the value
+ *            bytes: receives the n bytes
+ *            n: the number of bytes, up to 8
+ * Returns:   N/A
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static void put_be(uint64_t value, unsigned char *bytes, int n)
+{
+        int i;
+        for (i = n - 1; i >= 0; i--) {
+                bytes[i] = value & 0xff;
+                value >>= 8;
+        }
+}
+
+/* FUNCTION:  get_be
+ * Purpose:   Loads a value stored most significant byte first
+ * Arg:       bytes: the n bytes
+ *            n: the number of bytes, up to 8
+ * Returns:   The value
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static uint64_t get_be(const unsigned char *bytes, int n)
+{
+        uint64_t value = 0;
+        int i;
+        for (i = 0; i < n; i++) {
+                value = (value << 8) | bytes[i];
+        }
+
+        return value;
+}
+
+/* FUNCTION:  skip_bytes
+ * Purpose:   Moves forward in a file
+ * Arg:       file: pointer to a file
+ *            count: the number of bytes to move
+ * Returns:   N/A
+ * Effect:    Seeks when file can seek, and reads the bytes otherwise
+ * Error:     Runtime error if the file ends early
+ */
+static void skip_bytes(FILE *file, uint64_t count)
+{
+        if (count == 0 || fseeko(file, count, SEEK_CUR) == 0) {
+                return;
+        }
+
+        unsigned char buffer[SKIP_BYTES];
+        while (count > 0) {
+                size_t wanted = count < SKIP_BYTES ? count : SKIP_BYTES;
+                size_t got = fread(buffer, 1, wanted, file);
+                assert(got == wanted);
+                count -= got;
+        }
+}
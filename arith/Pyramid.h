@@ -0,0 +1,67 @@
+/*****************************************************************************
+ *
+ *                                 Pyramid.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Pyramid module. The purpose of
+ *     this module is to compress an image at several zoom levels in one
+ *     pass (40image -c --pyramid N, header "COMP40 Compressed image
+ *     format 6"). Level 0 is the image itself and each later level is half
+ *     the width and height of the one before. The CV colors of a level are
+ *     not computed from the pixels again: they are the a, avgPb and avgPr
+ *     floats of the 2 by 2 blocks of the level before, the averages the
+ *     DCT of that level already computes, taken before quantization.
+ *
+ *     After the header comes the number of levels (one byte) and an index
+ *     with, for each level, its width and height (4 bytes each) and the
+ *     offset from the end of the index and length of its image (8 bytes
+ *     each), all most significant byte first. Each level is a complete
+ *     image in format 2, so a viewer can seek to one level and decode it
+ *     alone.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include "Planar.h"
+
+#ifndef PYRAMID_INCLUDED
+#define PYRAMID_INCLUDED
+
+/* number in the header of the pyramid format */
+#define PYRAMID_FORMAT 6
+
+/* most levels a pyramid holds */
+#define PYRAMID_MAX_LEVELS 16
+
+/* FUNCTION:  Pyramid_write
+ * Purpose:   Compresses an image to the pyramid format
+ * Arg:       rgb_floats: a planar image of RGB floats with even dimensions
+ *            levels: the number of levels wanted, 1 to PYRAMID_MAX_LEVELS
+ *            file: pointer to a file open for writing
+ * Returns:   The number of levels written, fewer than asked when a level
+ *            would be less than 2 pixels wide or high
+ * Effect:    Writes the header and the index, then each level as soon as
+ *            it is compressed; recycles rgb_floats
+ * Error:     Runtime error if a NULL pointer is passed in, if levels is out
+ *            of range or if the write fails
+ */
+int Pyramid_write(Planar_T rgb_floats, int levels, FILE *file);
+
+/* FUNCTION:  Pyramid_seek
+ * Purpose:   Moves to the image of one level of a pyramid
+ * Arg:       file: pointer to a file, just after the header read by
+ *                  Codewords_File_read_header
+ *            level: the level wanted, 0 for the full size image
+ * Returns:   N/A
+ * Effect:    Reads the index and leaves file at the header of the image of
+ *            the level, seeking when it can and reading past the levels
+ *            before otherwise
+ * Error:     Runtime error if a NULL pointer is passed in, if the pyramid
+ *            has no such level or if the index is not valid
+ */
+void Pyramid_seek(FILE *file, int level);
+
+#endif
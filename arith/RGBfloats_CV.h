@@ -8,42 +8,36 @@
  *
  *     Summary:
  *     This is the public interface of our RGBfloats_CV module. 
- *     The purpose of this module is to convert between a UArray2 of RGB float 
- *     values and a UArray2 of CV color values. This module contains two public
- *     functions, one that takes in a UArray2 of RGB float values and returns a
- *     UArray2 of CV color values, and one that takes in a UArray2 of CV color
- *     values and returns a UArray2 of RGB float values. In compression and 
- *     decompression, data is lost due to imprecise nature of floating point
- *     math.
+ *     The purpose of this module is to convert between a planar image of RGB
+ *     floats and a planar image of CV color values. This module contains 
+ *     two public functions, one that takes RGB floats and returns CV 
+ *     colors, and one that takes CV colors and returns RGB floats. In 
+ *     compression and decompression, data is lost due to imprecise nature
+ *     of floating point math.
  *     
  *
  ****************************************************************************/
-#include "uarray2.h"
+#include "Planar.h"
 
 #ifndef RGBfloats_CV_INCLUDED
 #define RGBfloats_CV_INCLUDED
 
-/* FUNCTION:  RGBfloats_CV_compress
- * Purpose:   Converts an UArray2 of RGB_floats to an UArray2 of component 
-              video colors space
- * Arg:       RGB_floats: pointer to an instance of UArray2 that stores the 
- *                        RGB floats
- * Returns:   Pointer to an UArray2 that stores the components video color
- *            space values for each pixel
- * Effect:    initializes a new UArray2 and recycles the RGB_floats UArray2
+/* FUNCTION:  RGBfloats_CV_compress_planar
+ * Purpose:   Converts RGB floats to component video colors
+ * Arg:       RGB_floats: a planar image with red, green and blue planes
+ * Returns:   A planar image with y, pb and pr planes
+ * Effect:    initializes a new Planar_T and recycles the RGB floats
  * Error:     Runtime error if a NULL pointer is passed in
  */
-UArray2_T RGBfloats_CV_compress(UArray2_T RGB_floats);
+Planar_T RGBfloats_CV_compress_planar(Planar_T RGB_floats);
 
-/* FUNCTION:  RGBfloats_CV_decompress
- * Purpose:   Converts an UArray2 of component video colors space to 
-              an UArray2 of RGB floats values
- * Arg:       CV_colors: pointer to an instance of UArray2 that stores the 
- *                       component video color space 
- * Returns:   Pointer to an UArray2 that stores the RGB floats
- * Effect:    initializes a new UArray2 and recycles the CV colors UArray2
- * Error:     Runtime error a NULL pointer is passed in
+/* FUNCTION:  RGBfloats_CV_decompress_planar
+ * Purpose:   Converts component video colors to RGB floats
+ * Arg:       CV_colors: a planar image with y, pb and pr planes
+ * Returns:   A planar image with red, green and blue planes
+ * Effect:    initializes a new Planar_T and recycles the CV colors
+ * Error:     Runtime error if a NULL pointer is passed in
  */
-UArray2_T RGBfloats_CV_decompress(UArray2_T CV_Colors);
+Planar_T RGBfloats_CV_decompress_planar(Planar_T CV_colors);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,466 @@
+/*****************************************************************************
+ *
+ *                                Row_bands.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Row_bands module. The
+ *     purpose of this module is to run the middle stages of compression and
+ *     decompression, on the calling thread when there is one thread and on
+ *     a pool of threads otherwise. The image is cut into horizontal
+ *     bands of 2 by 2 blocks. The worker threads take bands off a shared
+ *     counter; for each band they copy its rows out of the full input array,
+ *     run the existing stage modules over the copy, and copy the result into
+ *     the rows of the full output array that belong to that band. Because
+ *     the position of every band in the output is known before any work
+ *     starts, no coordination is needed beyond handing out band numbers.
+ *
+ *****************************************************************************/
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "Row_bands.h"
+#include "Planar.h"
+
+/* the 4 modules whose stages run on each band */
+#include "RGBfloats_CV.h"
+#include "CV_DCTfloats.h"
+#include "DCTfloats_DCTints.h"
+#include "DCTints_codewords.h"
+
+/* Number of bands handed out per thread, so that threads which finish
+   early can pick up the remaining work */
+#define BANDS_PER_THREAD 4
+
+/*
+ * The work shared by every thread
+ * rgb_floats: the full planar image of RGB floats
+ * codewords:  the full UArray2 of codewords
+ * run:        copies the rows of one band out of the input, runs the stages
+ *             over them and copies the result into the output; takes the
+ *             first row of 2 by 2 blocks and the number of rows
+ * block_rows: total number of rows of 2 by 2 blocks in the image
+ * band_rows:  rows of 2 by 2 blocks in each band
+ * next_band:  the next band that has not been handed out
+ * lock:       guards next_band
+ */
+struct Band_work {
+        Planar_T rgb_floats;
+        UArray2_T codewords;
+        void (*run)(struct Band_work *work, int first, int nrows);
+        int block_rows, band_rows;
+        int next_band;
+        pthread_mutex_t lock;
+};
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static UArray2_T compress_stages(Planar_T rgb_floats, Stage_timer_T timer,
+                                 size_t bytes);
+static Planar_T  decompress_stages(UArray2_T codewords, Stage_timer_T timer,
+                                   size_t bytes);
+static void      lap(Stage_timer_T timer, const char *stage, size_t bytes);
+static void      run_bands(struct Band_work *work, unsigned nthreads);
+static void     *band_worker(void *cl);
+static int       take_band(struct Band_work *work);
+static void      compress_band(struct Band_work *work, int first, 
+                               int nrows);
+static void      decompress_band(struct Band_work *work, int first, 
+                                 int nrows);
+static UArray2_T copy_rows(UArray2_T array2, int row, int nrows);
+static void      paste_rows(UArray2_T band, UArray2_T array2, int row);
+static Planar_T  copy_planar_rows(Planar_T planar, int row, int nrows);
+static void      paste_planar_rows(Planar_T band, Planar_T planar, int row);
+
+/* FUNCTION:  Row_bands_compress
+ * Purpose:   Converts a planar image of RGB floats to an UArray2 of codewords
+ *            using nthreads worker threads
+ * Arg:       RGB_floats: a planar image of RGB floats; width and height
+ *                        must be even
+ *            nthreads: the number of worker threads to use
+ *            timer: the timer of the caller, or NULL
+ * Returns:   Pointer to an UArray2 that stores the codewords
+ * Effect:    initializes a new UArray2 and recycles the RGB floats; one
+ *            thread runs the stages itself, with no copies of bands
+ * Error:     Runtime error if a NULL pointer is passed in, if nthreads is 0
+ *            or if a thread cannot be created
+ */
+UArray2_T Row_bands_compress(Planar_T RGB_floats, unsigned nthreads,
+                             Stage_timer_T timer)
+{
+        assert(RGB_floats != NULL);
+        assert(nthreads > 0);
+
+        /* every stage is measured against the size of the 8 bit pixels */
+        size_t bytes = (size_t)Planar_width(RGB_floats) * 
+                       Planar_height(RGB_floats) * 3;
+        if (nthreads == 1) {
+                return compress_stages(RGB_floats, timer, bytes);
+        }
+
+        /* each codeword covers a 2 by 2 block of pixels */
+        unsigned width = Planar_width(RGB_floats) / 2;
+        unsigned height = Planar_height(RGB_floats) / 2;
+        UArray2_T codewords = UArray2_new(width, height, sizeof(uint64_t));
+
+        struct Band_work work;
+        work.rgb_floats = RGB_floats;
+        work.codewords = codewords;
+        work.run = compress_band;
+        work.block_rows = height;
+        run_bands(&work, nthreads);
+
+        Planar_free(&RGB_floats);
+        lap(timer, "bands", bytes);
+
+        return codewords;
+}
+
+/* FUNCTION:  Row_bands_decompress
+ * Purpose:   Converts an UArray2 of codewords to a planar image of RGB floats
+ *            using nthreads worker threads
+ * Arg:       codewords: pointer to an instance of UArray2 that stores the
+ *                       codewords
+ *            nthreads: the number of worker threads to use
+ *            timer: the timer of the caller, or NULL
+ * Returns:   A planar image of RGB floats
+ * Effect:    initializes a new Planar_T and recycles the codewords UArray2;
+ *            one thread runs the stages itself, with no copies of bands
+ * Error:     Runtime error if a NULL pointer is passed in, if nthreads is 0
+ *            or if a thread cannot be created
+ */
+Planar_T Row_bands_decompress(UArray2_T codewords, unsigned nthreads,
+                              Stage_timer_T timer)
+{
+        assert(codewords != NULL);
+        assert(nthreads > 0);
+
+        unsigned width = UArray2_width(codewords) * 2;
+        unsigned height = UArray2_height(codewords) * 2;
+        size_t bytes = (size_t)width * height * 3;
+        if (nthreads == 1) {
+                return decompress_stages(codewords, timer, bytes);
+        }
+
+        Planar_T RGB_floats = Planar_new(width, height, 3);
+
+        struct Band_work work;
+        work.rgb_floats = RGB_floats;
+        work.codewords = codewords;
+        work.run = decompress_band;
+        work.block_rows = UArray2_height(codewords);
+        run_bands(&work, nthreads);
+
+        UArray2_free(&codewords);
+        lap(timer, "bands", bytes);
+
+        return RGB_floats;
+}
+
+/* FUNCTION:  compress_stages
+ * Purpose:   Runs the compression stages over an image or a band on the
+ *            calling thread
+ * Arg:       rgb_floats: a planar image of RGB floats
+ *            timer: the timer of the caller, or NULL
+ *            bytes: the size of the 8 bit pixels, for the timer
+ * Returns:   Pointer to an UArray2 of the codewords
+ * Effect:    Recycles rgb_floats; laps timer after each stage
+ * Error:     N/A
+ */
+static UArray2_T compress_stages(Planar_T rgb_floats, Stage_timer_T timer,
+                                 size_t bytes)
+{
+        Planar_T cv_colors = RGBfloats_CV_compress_planar(rgb_floats);
+        lap(timer, "rgb_to_cv", bytes);
+        Planar_T dct_floats = CV_DCTfloats_compress_planar(cv_colors);
+        lap(timer, "cv_to_dct", bytes);
+        UArray2_T dct_ints = DCTfloats_ints_compress_planar(dct_floats);
+        lap(timer, "quantize", bytes);
+        UArray2_T codewords = DCTints_codewords_compress(dct_ints);
+        lap(timer, "pack", bytes);
+
+        return codewords;
+}
+
+/* FUNCTION:  decompress_stages
+ * Purpose:   Runs the decompression stages over an image or a band on the
+ *            calling thread
+ * Arg:       codewords: pointer to a UArray2 of codewords
+ *            timer: the timer of the caller, or NULL
+ *            bytes: the size of the 8 bit pixels, for the timer
+ * Returns:   A planar image of RGB floats
+ * Effect:    Recycles codewords; laps timer after each stage
+ * Error:     N/A
+ */
+static Planar_T decompress_stages(UArray2_T codewords, Stage_timer_T timer,
+                                  size_t bytes)
+{
+        UArray2_T dct_ints = DCTints_codewords_decompress(codewords);
+        lap(timer, "unpack", bytes);
+        Planar_T dct_floats = DCTfloats_ints_decompress_planar(dct_ints);
+        lap(timer, "dequantize", bytes);
+        Planar_T cv_colors = CV_DCTfloats_decompress_planar(dct_floats);
+        lap(timer, "dct_to_cv", bytes);
+        Planar_T rgb_floats = RGBfloats_CV_decompress_planar(cv_colors);
+        lap(timer, "cv_to_rgb", bytes);
+
+        return rgb_floats;
+}
+
+/* FUNCTION:  lap
+ * Purpose:   Ends a stage of the caller's timer, if there is one
+ * Arg:       timer: the timer of the caller, or NULL
+ *            stage: the name of the stage
+ *            bytes: the number of bytes the stage processed
+ * Returns:   N/A
+ * Effect:    See Stage_timer_lap
+ * Error:     N/A
+ */
+static void lap(Stage_timer_T timer, const char *stage, size_t bytes)
+{
+        if (timer != NULL) {
+                Stage_timer_lap(timer, stage, bytes);
+        }
+}
+
+/* FUNCTION:  run_bands
+ * Purpose:   Splits the work into bands and runs them on nthreads threads
+ * Arg:       work: the shared work, with everything but the band fields
+ *                  filled in
+ *            nthreads: the number of worker threads to use
+ * Returns:   N/A
+ * Effect:    Every row of the output is written; returns once all the
+ *            threads have finished. No more threads are started than
+ *            there are rows of blocks
+ * Error:     Runtime error if a thread cannot be created or joined
+ */
+static void run_bands(struct Band_work *work, unsigned nthreads)
+{
+        /* a thread with no row of blocks to take would only be overhead */
+        if (nthreads > (unsigned)work->block_rows) {
+                nthreads = work->block_rows > 0 ? work->block_rows : 1;
+        }
+
+        /* round up so that the last band is never left over */
+        size_t nbands = (size_t)nthreads * BANDS_PER_THREAD;
+        work->band_rows = ((size_t)work->block_rows + nbands - 1) / nbands;
+        if (work->band_rows == 0) {
+                work->band_rows = 1;
+        }
+        work->next_band = 0;
+
+        int err = pthread_mutex_init(&work->lock, NULL);
+        assert(err == 0);
+
+        pthread_t *threads = malloc(nthreads * sizeof(*threads));
+        assert(threads != NULL);
+
+        unsigned i;
+        for (i = 0; i < nthreads; i++) {
+                err = pthread_create(&threads[i], NULL, band_worker, work);
+                assert(err == 0);
+        }
+        for (i = 0; i < nthreads; i++) {
+                err = pthread_join(threads[i], NULL);
+                assert(err == 0);
+        }
+
+        pthread_mutex_destroy(&work->lock);
+        free(threads);
+}
+
+/* FUNCTION:  band_worker
+ * Purpose:   Body of each worker thread; runs bands until none are left
+ * Arg:       cl: pointer to the shared Band_work
+ * Returns:   NULL
+ * Effect:    Writes the rows of the output belonging to each band it takes
+ * Error:     N/A
+ */
+static void *band_worker(void *cl)
+{
+        struct Band_work *work = cl;
+
+        int band;
+        while ((band = take_band(work)) >= 0) {
+                int first = band * work->band_rows;
+                int nrows = work->block_rows - first;
+                if (nrows > work->band_rows) {
+                        nrows = work->band_rows;
+                }
+
+                work->run(work, first, nrows);
+        }
+
+        return NULL;
+}
+
+/* FUNCTION:  take_band
+ * Purpose:   Hands out the next band that has not been started
+ * Arg:       work: pointer to the shared Band_work
+ * Returns:   The index of the band, or -1 if every band has been handed out
+ * Effect:    Advances work->next_band
+ * Error:     N/A
+ */
+static int take_band(struct Band_work *work)
+{
+        pthread_mutex_lock(&work->lock);
+
+        int band = work->next_band;
+        if (band * work->band_rows < work->block_rows) {
+                work->next_band++;
+        } else {
+                band = -1;
+        }
+
+        pthread_mutex_unlock(&work->lock);
+
+        return band;
+}
+
+/* FUNCTION:  compress_band
+ * Purpose:   Runs the compression stages over one band
+ * Arg:       work: the shared work
+ *            first: the first row of 2 by 2 blocks in the band
+ *            nrows: the number of rows of 2 by 2 blocks in the band
+ * Returns:   N/A
+ * Effect:    Writes rows first through first + nrows - 1 of the codewords
+ * Error:     N/A
+ */
+static void compress_band(struct Band_work *work, int first, int nrows)
+{
+        Planar_T rgb_floats = copy_planar_rows(work->rgb_floats, first * 2,
+                                               nrows * 2);
+        UArray2_T codewords = compress_stages(rgb_floats, NULL, 0);
+
+        paste_rows(codewords, work->codewords, first);
+        UArray2_free(&codewords);
+}
+
+/* FUNCTION:  decompress_band
+ * Purpose:   Runs the decompression stages over one band
+ * Arg:       work: the shared work
+ *            first: the first row of 2 by 2 blocks in the band
+ *            nrows: the number of rows of 2 by 2 blocks in the band
+ * Returns:   N/A
+ * Effect:    Writes rows 2 * first through 2 * (first + nrows) - 1 of the
+ *            RGB floats
+ * Error:     N/A
+ */
+static void decompress_band(struct Band_work *work, int first, int nrows)
+{
+        UArray2_T codewords = copy_rows(work->codewords, first, nrows);
+        Planar_T rgb_floats = decompress_stages(codewords, NULL, 0);
+
+        paste_planar_rows(rgb_floats, work->rgb_floats, first * 2);
+        Planar_free(&rgb_floats);
+}
+
+/* FUNCTION:  copy_rows
+ * Purpose:   Copies nrows rows of an UArray2, starting at row, into a new
+ *            UArray2 of the same width
+ * Arg:       array2: the UArray2 to copy from
+ *            row: the first row to copy
+ *            nrows: the number of rows to copy
+ * Returns:   The new UArray2
+ * Effect:    Allocates a new UArray2. Relies on the rows of an UArray2 being
+ *            stored one after the other
+ * Error:     Runtime error if the rows are out of range
+ */
+static UArray2_T copy_rows(UArray2_T array2, int row, int nrows)
+{
+        int width = UArray2_width(array2);
+        int size = UArray2_size(array2);
+        assert(row >= 0 && row + nrows <= UArray2_height(array2));
+        UArray2_T band = UArray2_new(width, nrows, size);
+
+        if (width > 0 && nrows > 0) {
+                memcpy(UArray2_row(band, 0), UArray2_row(array2, row),
+                       (size_t)width * nrows * size);
+        }
+
+        return band;
+}
+
+/* FUNCTION:  paste_rows
+ * Purpose:   Copies every row of band into array2, starting at row
+ * Arg:       band: the UArray2 to copy from
+ *            array2: the UArray2 to copy into; same width and element size
+ *            row: the row of array2 that receives the first row of band
+ * Returns:   N/A
+ * Effect:    Overwrites rows of array2
+ * Error:     Runtime error if the widths differ or the rows are out of range
+ */
+static void paste_rows(UArray2_T band, UArray2_T array2, int row)
+{
+        int width = UArray2_width(band);
+        int nrows = UArray2_height(band);
+        int size = UArray2_size(band);
+        assert(width == UArray2_width(array2));
+        assert(row >= 0 && row + nrows <= UArray2_height(array2));
+
+        if (width > 0 && nrows > 0) {
+                memcpy(UArray2_row(array2, row), UArray2_row(band, 0),
+                       (size_t)width * nrows * size);
+        }
+}
+
+/* FUNCTION:  copy_planar_rows
+ * Purpose:   Copies nrows rows of every plane of a planar image, starting at
+ *            row, into a new planar image of the same width
+ * Arg:       planar: the image to copy from
+ *            row: the first row to copy
+ *            nrows: the number of rows to copy
+ * Returns:   The new planar image
+ * Effect:    Allocates a new planar image
+ * Error:     Runtime error if the rows are out of range
+ */
+static Planar_T copy_planar_rows(Planar_T planar, int row, int nrows)
+{
+        int nplanes = Planar_nplanes(planar);
+        int stride = Planar_stride(planar);
+        assert(row >= 0 && row + nrows <= Planar_height(planar));
+        Planar_T band = Planar_new(Planar_width(planar), nrows, nplanes);
+
+        int plane;
+        for (plane = 0; nrows > 0 && plane < nplanes; plane++) {
+                memcpy(Planar_row(band, plane, 0),
+                       Planar_row(planar, plane, row),
+                       (size_t)stride * nrows * sizeof(float));
+        }
+
+        return band;
+}
+
+/* FUNCTION:  paste_planar_rows
+ * Purpose:   Copies every row of every plane of band into planar, starting
+ *            at row
+ * Arg:       band: the image to copy from
+ *            planar: the image to copy into; same width and planes
+ *            row: the row of planar that receives the first row of band
+ * Returns:   N/A
+ * Effect:    Overwrites rows of planar
+ * Error:     Runtime error if the widths differ or the rows are out of range
+ */
+static void paste_planar_rows(Planar_T band, Planar_T planar, int row)
+{
+        int nplanes = Planar_nplanes(band);
+        int nrows = Planar_height(band);
+        int stride = Planar_stride(band);
+        assert(Planar_width(band) == Planar_width(planar));
+        assert(nplanes == Planar_nplanes(planar));
+        assert(row >= 0 && row + nrows <= Planar_height(planar));
+
+        int plane;
+        for (plane = 0; nrows > 0 && plane < nplanes; plane++) {
+                memcpy(Planar_row(planar, plane, row),
+                       Planar_row(band, plane, 0),
+                       (size_t)stride * nrows * sizeof(float));
+        }
+}
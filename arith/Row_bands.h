@@ -0,0 +1,66 @@
+/*****************************************************************************
+ *
+ *                                Row_bands.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Row_bands module. The purpose of
+ *     this module is to run the middle stages of compression and
+ *     decompression (RGBfloats_CV through DCTints_codewords), on the 
+ *     calling thread or on a pool of threads; every module that compresses
+ *     or decompresses codewords goes through it. With several threads the
+ *     image is split into horizontal bands of 2 by 2 blocks; every block is
+ *     independent, so each band is pushed through the usual stage modules
+ *     on its own and its results are copied into the rows of the full 
+ *     output array that belong to it. The output is therefore identical to
+ *     the single threaded output.
+ *
+ *****************************************************************************/
+#include "uarray2.h"
+#include "Planar.h"
+#include "Stage_timer.h"
+
+#ifndef ROWBANDS_INCLUDED
+#define ROWBANDS_INCLUDED
+
+/* FUNCTION:  Row_bands_compress
+ * Purpose:   Converts a planar image of RGB floats to an UArray2 of codewords
+ *            using nthreads worker threads
+ * Arg:       RGB_floats: a planar image of RGB floats; width and height
+ *                        must be even
+ *            nthreads: the number of worker threads to use; with 1 the
+ *                      stages run on the calling thread
+ *            timer: the timer of the caller, or NULL
+ * Returns:   Pointer to an UArray2 that stores the codewords
+ * Effect:    initializes a new UArray2 and recycles the RGB floats. On one
+ *            thread every stage is a lap of timer (rgb_to_cv, cv_to_dct,
+ *            quantize and pack); on several the bands are one lap
+ * Error:     Runtime error if a NULL pointer is passed in, if nthreads is 0
+ *            or if a thread cannot be created
+ */
+UArray2_T Row_bands_compress(Planar_T RGB_floats, unsigned nthreads,
+                             Stage_timer_T timer);
+
+/* FUNCTION:  Row_bands_decompress
+ * Purpose:   Converts an UArray2 of codewords to a planar image of RGB floats
+ *            using nthreads worker threads
+ * Arg:       codewords: pointer to an instance of UArray2 that stores the
+ *                       codewords
+ *            nthreads: the number of worker threads to use; with 1 the
+ *                      stages run on the calling thread
+ *            timer: the timer of the caller, or NULL
+ * Returns:   A planar image of RGB floats
+ * Effect:    initializes a new Planar_T and recycles the codewords UArray2.
+ *            On one thread every stage is a lap of timer (unpack, 
+ *            dequantize, dct_to_cv and cv_to_rgb); on several the bands are
+ *            one lap
+ * Error:     Runtime error if a NULL pointer is passed in, if nthreads is 0
+ *            or if a thread cannot be created
+ */
+Planar_T Row_bands_decompress(UArray2_T codewords, unsigned nthreads,
+                              Stage_timer_T timer);
+
+#endif
@@ -0,0 +1,615 @@
+/*****************************************************************************
+ *
+ *                               SIMD_kernels.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our SIMD_kernels module. Every
+ *     kernel has a scalar version, which is the reference, and on x86 an
+ *     AVX2 version compiled with the avx2 target attribute, so the rest of
+ *     the program still runs on CPUs without AVX2. The first call of any
+ *     kernel checks the CPU once and picks the version every later call
+ *     uses. The AVX2 versions run the same single precision operations in
+ *     the same order as the scalar versions (see the tolerance note in
+ *     SIMD_kernels.h); leftover pixels at the end of a row that do not fill
+ *     a vector go through the scalar version.
+ *
+ *****************************************************************************/
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
+#include "SIMD_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_AVX2_KERNELS 1
+#endif
+
+/* coefficients of the RGB to component video conversion */
+#define Y_RED     0.299f
+#define Y_GREEN   0.587f
+#define Y_BLUE    0.114f
+#define PB_RED    -0.168736f
+#define PB_GREEN  0.331264f
+#define PB_BLUE   0.5f
+#define PR_RED    0.5f
+#define PR_GREEN  0.418688f
+#define PR_BLUE   0.081312f
+
+/* coefficients of the component video to RGB conversion */
+#define RED_PR    1.402f
+#define GREEN_PB  0.344136f
+#define GREEN_PR  0.714136f
+#define BLUE_PB   1.772f
+
+/* each DCT float is the sum or difference of 4 pixels divided by 4 */
+#define QUARTER   0.25f
+
+/* largest sample of the PPMs the decoder writes */
+#define SAMPLE_MAX 255.0f
+
+/* number of floats in an AVX2 vector */
+#define LANES 8
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static void choose_kernels(void);
+static void rgb_to_cv_scalar(const float *red, const float *green,
+                             const float *blue, float *y, float *pb,
+                             float *pr, int n);
+static void cv_to_rgb_scalar(const float *y, const float *pb, const float *pr,
+                             float *red, float *green, float *blue, int n);
+static void cv_to_dct_scalar(const float *const top[3],
+                             const float *const bottom[3],
+                             float *const dct[6], int first, int n);
+static void dct_to_cv_scalar(const float *const dct[6], float *const top[3],
+                             float *const bottom[3], int first, int n);
+static double squared_error_scalar(const float *original,
+                                   const float *decoded, int n);
+
+#ifdef HAVE_AVX2_KERNELS
+static void rgb_to_cv_avx2(const float *red, const float *green,
+                           const float *blue, float *y, float *pb,
+                           float *pr, int n);
+static void cv_to_rgb_avx2(const float *y, const float *pb, const float *pr,
+                           float *red, float *green, float *blue, int n);
+static void cv_to_dct_avx2(const float *const top[3],
+                           const float *const bottom[3], float *const dct[6],
+                           int n);
+static void dct_to_cv_avx2(const float *const dct[6], float *const top[3],
+                           float *const bottom[3], int n);
+static double squared_error_avx2(const float *original, const float *decoded,
+                                 int n);
+#endif
+
+/* set once by choose_kernels */
+static pthread_once_t chosen = PTHREAD_ONCE_INIT;
+static bool use_avx2 = false;
+
+/* FUNCTION:  SIMD_kernels_RGB_to_CV
+ * Purpose:   Converts n pixels from RGB floats to component video colors
+ * Arg:       red, green, blue: the n RGB floats of each pixel
+ *            y, pb, pr: receive the n component video colors
+ * Returns:   N/A
+ * Effect:    Writes n floats to each of y, pb and pr
+ * Error:     N/A
+ */
+void SIMD_kernels_RGB_to_CV(const float *red, const float *green,
+                            const float *blue, float *y, float *pb,
+                            float *pr, int n)
+{
+        pthread_once(&chosen, choose_kernels);
+
+#ifdef HAVE_AVX2_KERNELS
+        if (use_avx2) {
+                rgb_to_cv_avx2(red, green, blue, y, pb, pr, n);
+                return;
+        }
+#endif
+        rgb_to_cv_scalar(red, green, blue, y, pb, pr, n);
+}
+
+/* FUNCTION:  SIMD_kernels_CV_to_RGB
+ * Purpose:   Converts n pixels from component video colors to RGB floats
+ * Arg:       y, pb, pr: the n component video colors of each pixel
+ *            red, green, blue: receive the n RGB floats
+ * Returns:   N/A
+ * Effect:    Writes n floats to each of red, green and blue
+ * Error:     N/A
+ */
+void SIMD_kernels_CV_to_RGB(const float *y, const float *pb, const float *pr,
+                            float *red, float *green, float *blue, int n)
+{
+        pthread_once(&chosen, choose_kernels);
+
+#ifdef HAVE_AVX2_KERNELS
+        if (use_avx2) {
+                cv_to_rgb_avx2(y, pb, pr, red, green, blue, n);
+                return;
+        }
+#endif
+        cv_to_rgb_scalar(y, pb, pr, red, green, blue, n);
+}
+
+/* FUNCTION:  SIMD_kernels_CV_to_DCT
+ * Purpose:   Converts n 2 by 2 blocks of component video colors to DCT
+ *            floats
+ * Arg:       top, bottom: 3 pointers each (y, pb, pr) to the 2 * n pixels of
+ *                         the upper and lower row of the blocks
+ *            dct: 6 pointers (avgPb, avgPr, a, b, c, d) that receive the n
+ *                 DCT floats
+ * Returns:   N/A
+ * Effect:    Writes n floats to each of the 6 dct rows
+ * Error:     N/A
+ */
+void SIMD_kernels_CV_to_DCT(const float *const top[3],
+                            const float *const bottom[3], float *const dct[6],
+                            int n)
+{
+        pthread_once(&chosen, choose_kernels);
+
+#ifdef HAVE_AVX2_KERNELS
+        if (use_avx2) {
+                cv_to_dct_avx2(top, bottom, dct, n);
+                return;
+        }
+#endif
+        cv_to_dct_scalar(top, bottom, dct, 0, n);
+}
+
+/* FUNCTION:  SIMD_kernels_DCT_to_CV
+ * Purpose:   Converts n DCT floats to 2 by 2 blocks of component video colors
+ * Arg:       dct: 6 pointers (avgPb, avgPr, a, b, c, d) to the n DCT floats
+ *            top, bottom: 3 pointers each (y, pb, pr) that receive the 2 * n
+ *                         pixels of the upper and lower row of the blocks
+ * Returns:   N/A
+ * Effect:    Writes 2 * n floats to each of the 6 pixel rows
+ * Error:     N/A
+ */
+void SIMD_kernels_DCT_to_CV(const float *const dct[6], float *const top[3],
+                            float *const bottom[3], int n)
+{
+        pthread_once(&chosen, choose_kernels);
+
+#ifdef HAVE_AVX2_KERNELS
+        if (use_avx2) {
+                dct_to_cv_avx2(dct, top, bottom, n);
+                return;
+        }
+#endif
+        dct_to_cv_scalar(dct, top, bottom, 0, n);
+}
+
+/* FUNCTION:  SIMD_kernels_squared_error
+ * Purpose:   Sums the squared errors of n decoded samples, in the 0 to 255
+ *            units of the PPM the decoder writes
+ * Arg:       original: the n floats of the original samples
+ *            decoded: the n floats of the decoded samples
+ * Returns:   The sum of the squared differences
+ * Effect:    N/A
+ * Error:     N/A
+ */
+double SIMD_kernels_squared_error(const float *original, const float *decoded,
+                                  int n)
+{
+        pthread_once(&chosen, choose_kernels);
+
+#ifdef HAVE_AVX2_KERNELS
+        if (use_avx2) {
+                return squared_error_avx2(original, decoded, n);
+        }
+#endif
+        return squared_error_scalar(original, decoded, n);
+}
+
+/* FUNCTION:  choose_kernels
+ * Purpose:   Checks once whether the CPU supports AVX2
+ * Arg:       N/A
+ * Returns:   N/A
+ * Effect:    Sets use_avx2
+ * Error:     N/A
+ */
+static void choose_kernels(void)
+{
+#ifdef HAVE_AVX2_KERNELS
+        __builtin_cpu_init();
+        use_avx2 = __builtin_cpu_supports("avx2");
+#endif
+}
+
+/* FUNCTION:  rgb_to_cv_scalar
+ * Purpose:   Scalar version of SIMD_kernels_RGB_to_CV
+ * Arg:       see SIMD_kernels_RGB_to_CV
+ * Returns:   N/A
+ * Effect:    Writes n floats to each of y, pb and pr
+ * Error:     N/A
+ */
+static void rgb_to_cv_scalar(const float *red, const float *green,
+                             const float *blue, float *y, float *pb,
+                             float *pr, int n)
+{
+        int i;
+        for (i = 0; i < n; i++) {
+                y[i] = (Y_RED * red[i]) + (Y_GREEN * green[i]) +
+                       (Y_BLUE * blue[i]);
+                pb[i] = (PB_RED * red[i]) - (PB_GREEN * green[i]) +
+                        (PB_BLUE * blue[i]);
+                pr[i] = (PR_RED * red[i]) - (PR_GREEN * green[i]) -
+                        (PR_BLUE * blue[i]);
+        }
+}
+
+/* FUNCTION:  cv_to_rgb_scalar
+ * Purpose:   Scalar version of SIMD_kernels_CV_to_RGB
+ * Arg:       see SIMD_kernels_CV_to_RGB
+ * Returns:   N/A
+ * Effect:    Writes n floats to each of red, green and blue
+ * Error:     N/A
+ */
+static void cv_to_rgb_scalar(const float *y, const float *pb, const float *pr,
+                             float *red, float *green, float *blue, int n)
+{
+        int i;
+        for (i = 0; i < n; i++) {
+                red[i] = y[i] + (RED_PR * pr[i]);
+                green[i] = y[i] - (GREEN_PB * pb[i]) - (GREEN_PR * pr[i]);
+                blue[i] = y[i] + (BLUE_PB * pb[i]);
+        }
+}
+
+/* FUNCTION:  cv_to_dct_scalar
+ * Purpose:   Scalar version of SIMD_kernels_CV_to_DCT, starting at block
+ *            first
+ * Arg:       see SIMD_kernels_CV_to_DCT
+ *            first: the first block to convert
+ * Returns:   N/A
+ * Effect:    Writes blocks first through n - 1 of the 6 dct rows
+ * Error:     N/A
+ */
+static void cv_to_dct_scalar(const float *const top[3],
+                             const float *const bottom[3],
+                             float *const dct[6], int first, int n)
+{
+        int i;
+        for (i = first; i < n; i++) {
+                /* pix1 and pix2 are the upper pixels, pix3 and pix4 the
+                   lower ones */
+                int l = 2 * i;
+                int r = 2 * i + 1;
+                float y1 = top[SIMD_Y][l], y2 = top[SIMD_Y][r];
+                float y3 = bottom[SIMD_Y][l], y4 = bottom[SIMD_Y][r];
+
+                dct[SIMD_AVGPB][i] = (bottom[SIMD_PB][r] + bottom[SIMD_PB][l]
+                                      + top[SIMD_PB][r] + top[SIMD_PB][l])
+                                     * QUARTER;
+                dct[SIMD_AVGPR][i] = (bottom[SIMD_PR][r] + bottom[SIMD_PR][l]
+                                      + top[SIMD_PR][r] + top[SIMD_PR][l])
+                                     * QUARTER;
+                dct[SIMD_A][i] = (y4 + y3 + y2 + y1) * QUARTER;
+                dct[SIMD_B][i] = (y4 + y3 - y2 - y1) * QUARTER;
+                dct[SIMD_C][i] = (y4 - y3 + y2 - y1) * QUARTER;
+                dct[SIMD_D][i] = (y4 - y3 - y2 + y1) * QUARTER;
+        }
+}
+
+/* FUNCTION:  dct_to_cv_scalar
+ * Purpose:   Scalar version of SIMD_kernels_DCT_to_CV, starting at block
+ *            first
+ * Arg:       see SIMD_kernels_DCT_to_CV
+ *            first: the first block to convert
+ * Returns:   N/A
+ * Effect:    Writes blocks first through n - 1 of the 6 pixel rows
+ * Error:     N/A
+ */
+static void dct_to_cv_scalar(const float *const dct[6], float *const top[3],
+                             float *const bottom[3], int first, int n)
+{
+        int i;
+        for (i = first; i < n; i++) {
+                float a = dct[SIMD_A][i], b = dct[SIMD_B][i];
+                float c = dct[SIMD_C][i], d = dct[SIMD_D][i];
+                int l = 2 * i;
+                int r = 2 * i + 1;
+
+                top[SIMD_Y][l] = a - b - c + d;
+                top[SIMD_Y][r] = a - b + c - d;
+                bottom[SIMD_Y][l] = a + b - c - d;
+                bottom[SIMD_Y][r] = a + b + c + d;
+
+                top[SIMD_PB][l] = top[SIMD_PB][r] = dct[SIMD_AVGPB][i];
+                bottom[SIMD_PB][l] = bottom[SIMD_PB][r] = dct[SIMD_AVGPB][i];
+                top[SIMD_PR][l] = top[SIMD_PR][r] = dct[SIMD_AVGPR][i];
+                bottom[SIMD_PR][l] = bottom[SIMD_PR][r] = dct[SIMD_AVGPR][i];
+        }
+}
+
+/* FUNCTION:  squared_error_scalar
+ * Purpose:   Scalar version of SIMD_kernels_squared_error
+ * Arg:       see SIMD_kernels_squared_error
+ * Returns:   The sum of the squared differences
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static double squared_error_scalar(const float *original,
+                                   const float *decoded, int n)
+{
+        double sum = 0;
+        int i;
+        for (i = 0; i < n; i++) {
+                float sample = decoded[i] * SAMPLE_MAX;
+                sample = sample > SAMPLE_MAX ? SAMPLE_MAX : sample;
+                sample = sample < 0 ? 0 : sample;
+                float error = original[i] * SAMPLE_MAX - truncf(sample);
+                sum += (double)error * error;
+        }
+
+        return sum;
+}
+
+#ifdef HAVE_AVX2_KERNELS
+
+/* FUNCTION:  even_odd
+ * Purpose:   Splits 16 consecutive floats into the 8 at even positions and
+ *            the 8 at odd positions
+ * Arg:       p: pointer to the 16 floats
+ *            even, odd: receive the two halves
+ * Returns:   N/A
+ * Effect:    N/A
+ * Error:     N/A
+ */
+__attribute__((target("avx2")))
+static inline void even_odd(const float *p, __m256 *even, __m256 *odd)
+{
+        __m256 lo = _mm256_loadu_ps(p);
+        __m256 hi = _mm256_loadu_ps(p + LANES);
+
+        /* shuffle works within 128 bit lanes; the permute puts the 64 bit
+           pairs back in order */
+        __m256 e = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 o = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+        *even = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(e),
+                                               _MM_SHUFFLE(3, 1, 2, 0)));
+        *odd = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(o),
+                                              _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+/* FUNCTION:  store_interleaved
+ * Purpose:   Stores 8 even and 8 odd floats as 16 consecutive floats
+ * Arg:       p: pointer to the 16 floats
+ *            even, odd: the floats for the even and odd positions
+ * Returns:   N/A
+ * Effect:    Writes 16 floats at p
+ * Error:     N/A
+ */
+__attribute__((target("avx2")))
+static inline void store_interleaved(float *p, __m256 even, __m256 odd)
+{
+        __m256 lo = _mm256_unpacklo_ps(even, odd);
+        __m256 hi = _mm256_unpackhi_ps(even, odd);
+
+        _mm256_storeu_ps(p, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(p + LANES, _mm256_permute2f128_ps(lo, hi, 0x31));
+}
+
+/* FUNCTION:  rgb_to_cv_avx2
+ * Purpose:   AVX2 version of SIMD_kernels_RGB_to_CV
+ * Arg:       see SIMD_kernels_RGB_to_CV
+ * Returns:   N/A
+ * Effect:    Writes n floats to each of y, pb and pr
+ * Error:     N/A
+ */
+__attribute__((target("avx2")))
+static void rgb_to_cv_avx2(const float *red, const float *green,
+                           const float *blue, float *y, float *pb,
+                           float *pr, int n)
+{
+        int i;
+        for (i = 0; i + LANES <= n; i += LANES) {
+                __m256 r = _mm256_loadu_ps(red + i);
+                __m256 g = _mm256_loadu_ps(green + i);
+                __m256 b = _mm256_loadu_ps(blue + i);
+
+                __m256 v = _mm256_add_ps(
+                        _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(Y_RED), r),
+                                      _mm256_mul_ps(_mm256_set1_ps(Y_GREEN),
+                                                    g)),
+                        _mm256_mul_ps(_mm256_set1_ps(Y_BLUE), b));
+                _mm256_storeu_ps(y + i, v);
+
+                v = _mm256_add_ps(
+                        _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(PB_RED), r),
+                                      _mm256_mul_ps(_mm256_set1_ps(PB_GREEN),
+                                                    g)),
+                        _mm256_mul_ps(_mm256_set1_ps(PB_BLUE), b));
+                _mm256_storeu_ps(pb + i, v);
+
+                v = _mm256_sub_ps(
+                        _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(PR_RED), r),
+                                      _mm256_mul_ps(_mm256_set1_ps(PR_GREEN),
+                                                    g)),
+                        _mm256_mul_ps(_mm256_set1_ps(PR_BLUE), b));
+                _mm256_storeu_ps(pr + i, v);
+        }
+
+        rgb_to_cv_scalar(red + i, green + i, blue + i, y + i, pb + i, pr + i,
+                         n - i);
+}
+
+/* FUNCTION:  cv_to_rgb_avx2
+ * Purpose:   AVX2 version of SIMD_kernels_CV_to_RGB
+ * Arg:       see SIMD_kernels_CV_to_RGB
+ * Returns:   N/A
+ * Effect:    Writes n floats to each of red, green and blue
+ * Error:     N/A
+ */
+__attribute__((target("avx2")))
+static void cv_to_rgb_avx2(const float *y, const float *pb, const float *pr,
+                           float *red, float *green, float *blue, int n)
+{
+        int i;
+        for (i = 0; i + LANES <= n; i += LANES) {
+                __m256 vy = _mm256_loadu_ps(y + i);
+                __m256 vpb = _mm256_loadu_ps(pb + i);
+                __m256 vpr = _mm256_loadu_ps(pr + i);
+
+                __m256 v = _mm256_add_ps(vy,
+                        _mm256_mul_ps(_mm256_set1_ps(RED_PR), vpr));
+                _mm256_storeu_ps(red + i, v);
+
+                v = _mm256_sub_ps(
+                        _mm256_sub_ps(vy,
+                                      _mm256_mul_ps(_mm256_set1_ps(GREEN_PB),
+                                                    vpb)),
+                        _mm256_mul_ps(_mm256_set1_ps(GREEN_PR), vpr));
+                _mm256_storeu_ps(green + i, v);
+
+                v = _mm256_add_ps(vy,
+                        _mm256_mul_ps(_mm256_set1_ps(BLUE_PB), vpb));
+                _mm256_storeu_ps(blue + i, v);
+        }
+
+        cv_to_rgb_scalar(y + i, pb + i, pr + i, red + i, green + i, blue + i,
+                         n - i);
+}
+
+/* FUNCTION:  cv_to_dct_avx2
+ * Purpose:   AVX2 version of SIMD_kernels_CV_to_DCT
+ * Arg:       see SIMD_kernels_CV_to_DCT
+ * Returns:   N/A
+ * Effect:    Writes n floats to each of the 6 dct rows
+ * Error:     N/A
+ */
+__attribute__((target("avx2")))
+static void cv_to_dct_avx2(const float *const top[3],
+                           const float *const bottom[3], float *const dct[6],
+                           int n)
+{
+        __m256 quarter = _mm256_set1_ps(QUARTER);
+        __m256 y1, y2, y3, y4, l1, r1, l2, r2;
+
+        int i;
+        for (i = 0; i + LANES <= n; i += LANES) {
+                int p = 2 * i;
+
+                /* average chroma, summed in the same order as the scalar
+                   version: lower right, lower left, upper right, upper left */
+                even_odd(top[SIMD_PB] + p, &l1, &r1);
+                even_odd(bottom[SIMD_PB] + p, &l2, &r2);
+                __m256 v = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(r2, l2),
+                                                       r1), l1);
+                _mm256_storeu_ps(dct[SIMD_AVGPB] + i,
+                                 _mm256_mul_ps(v, quarter));
+
+                even_odd(top[SIMD_PR] + p, &l1, &r1);
+                even_odd(bottom[SIMD_PR] + p, &l2, &r2);
+                v = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(r2, l2), r1),
+                                  l1);
+                _mm256_storeu_ps(dct[SIMD_AVGPR] + i,
+                                 _mm256_mul_ps(v, quarter));
+
+                /* luma */
+                even_odd(top[SIMD_Y] + p, &y1, &y2);
+                even_odd(bottom[SIMD_Y] + p, &y3, &y4);
+
+                v = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(y4, y3), y2),
+                                  y1);
+                _mm256_storeu_ps(dct[SIMD_A] + i, _mm256_mul_ps(v, quarter));
+                v = _mm256_sub_ps(_mm256_sub_ps(_mm256_add_ps(y4, y3), y2),
+                                  y1);
+                _mm256_storeu_ps(dct[SIMD_B] + i, _mm256_mul_ps(v, quarter));
+                v = _mm256_sub_ps(_mm256_add_ps(_mm256_sub_ps(y4, y3), y2),
+                                  y1);
+                _mm256_storeu_ps(dct[SIMD_C] + i, _mm256_mul_ps(v, quarter));
+                v = _mm256_add_ps(_mm256_sub_ps(_mm256_sub_ps(y4, y3), y2),
+                                  y1);
+                _mm256_storeu_ps(dct[SIMD_D] + i, _mm256_mul_ps(v, quarter));
+        }
+
+        cv_to_dct_scalar(top, bottom, dct, i, n);
+}
+
+/* FUNCTION:  dct_to_cv_avx2
+ * Purpose:   AVX2 version of SIMD_kernels_DCT_to_CV
+ * Arg:       see SIMD_kernels_DCT_to_CV
+ * Returns:   N/A
+ * Effect:    Writes 2 * n floats to each of the 6 pixel rows
+ * Error:     N/A
+ */
+__attribute__((target("avx2")))
+static void dct_to_cv_avx2(const float *const dct[6], float *const top[3],
+                           float *const bottom[3], int n)
+{
+        int i;
+        for (i = 0; i + LANES <= n; i += LANES) {
+                int p = 2 * i;
+                __m256 a = _mm256_loadu_ps(dct[SIMD_A] + i);
+                __m256 b = _mm256_loadu_ps(dct[SIMD_B] + i);
+                __m256 c = _mm256_loadu_ps(dct[SIMD_C] + i);
+                __m256 d = _mm256_loadu_ps(dct[SIMD_D] + i);
+                __m256 a_b = _mm256_sub_ps(a, b);
+                __m256 ab = _mm256_add_ps(a, b);
+
+                store_interleaved(top[SIMD_Y] + p,
+                        _mm256_add_ps(_mm256_sub_ps(a_b, c), d),
+                        _mm256_sub_ps(_mm256_add_ps(a_b, c), d));
+                store_interleaved(bottom[SIMD_Y] + p,
+                        _mm256_sub_ps(_mm256_sub_ps(ab, c), d),
+                        _mm256_add_ps(_mm256_add_ps(ab, c), d));
+
+                __m256 pb = _mm256_loadu_ps(dct[SIMD_AVGPB] + i);
+                __m256 pr = _mm256_loadu_ps(dct[SIMD_AVGPR] + i);
+                store_interleaved(top[SIMD_PB] + p, pb, pb);
+                store_interleaved(bottom[SIMD_PB] + p, pb, pb);
+                store_interleaved(top[SIMD_PR] + p, pr, pr);
+                store_interleaved(bottom[SIMD_PR] + p, pr, pr);
+        }
+
+        dct_to_cv_scalar(dct, top, bottom, i, n);
+}
+
+/* FUNCTION:  squared_error_avx2
+ * Purpose:   AVX2 version of SIMD_kernels_squared_error
+ * Arg:       see SIMD_kernels_squared_error
+ * Returns:   The sum of the squared differences
+ * Effect:    N/A
+ * Error:     N/A
+ */
+__attribute__((target("avx2")))
+static double squared_error_avx2(const float *original, const float *decoded,
+                                 int n)
+{
+        /* the squares are added in double precision, 4 lanes at a time */
+        __m256d low = _mm256_setzero_pd();
+        __m256d high = _mm256_setzero_pd();
+        __m256 scale = _mm256_set1_ps(SAMPLE_MAX);
+        int i;
+        for (i = 0; i + LANES <= n; i += LANES) {
+                __m256 sample = _mm256_mul_ps(_mm256_loadu_ps(decoded + i),
+                                              scale);
+                sample = _mm256_max_ps(_mm256_min_ps(sample, scale),
+                                       _mm256_setzero_ps());
+                sample = _mm256_round_ps(sample, _MM_FROUND_TO_ZERO |
+                                                 _MM_FROUND_NO_EXC);
+                __m256 error = _mm256_sub_ps(
+                        _mm256_mul_ps(_mm256_loadu_ps(original + i), scale),
+                        sample);
+
+                __m256d e = _mm256_cvtps_pd(_mm256_castps256_ps128(error));
+                low = _mm256_add_pd(low, _mm256_mul_pd(e, e));
+                e = _mm256_cvtps_pd(_mm256_extractf128_ps(error, 1));
+                high = _mm256_add_pd(high, _mm256_mul_pd(e, e));
+        }
+
+        double lanes[4];
+        _mm256_storeu_pd(lanes, _mm256_add_pd(low, high));
+
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+               squared_error_scalar(original + i, decoded + i, n - i);
+}
+
+#endif
@@ -0,0 +1,559 @@
+/*****************************************************************************
+ *
+ *                                 Sequence.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Sequence module. After the
+ *     header each frame starts with one byte: 'K' for a key frame, followed
+ *     by its codewords as in format 2, or 'D' for a delta frame, followed
+ *     by the length of its Bit_stream as 4 bytes, most significant first,
+ *     and the stream: one bit per block in raster order, set when the
+ *     codeword of the block differs from the frame before, then for each
+ *     set bit the change of a, b, c, d, avgPb and avgPr as signed
+ *     Exp-Golomb codes.
+ *
+ *     Every block is independent, so a row of blocks compresses to the
+ *     same codewords alone as within its frame. The encoder keeps the
+ *     pixels and codewords of the frame before and compresses only the
+ *     rows of blocks whose pixels changed, gathered into one band; the
+ *     decoder keeps the pixels of the frame before and decodes only the
+ *     rows of blocks that have a changed codeword.
+ *
+ *****************************************************************************/
+#include <assert.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include "Sequence.h"
+#include "Bit_stream.h"
+#include "Bitpack_inline.h"
+#include "Planar.h"
+#include "uarray2.h"
+
+/* the modules that read, compress and write each frame */
+#include "ppm_RGBfloats.h"
+#include "Row_bands.h"
+#include "Codewords_File.h"
+
+/* the first byte of each kind of frame */
+#define KEY_FRAME 'K'
+#define DELTA_FRAME 'D'
+
+/* fields of a block whose changes a delta frame stores */
+#define FIELDS 6
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static bool      next_frame(FILE *input);
+static UArray2_T compress_rows(Planar_T current, Planar_T previous,
+                               UArray2_T reference, unsigned nthreads);
+static bool      rows_differ(Planar_T current, Planar_T previous, int row);
+static void      write_frame(FILE *output, UArray2_T codewords,
+                             UArray2_T reference);
+static bool      read_frame(FILE *input, UArray2_T codewords,
+                            bool *changed);
+static void      decompress_rows(UArray2_T codewords, const bool *changed,
+                                 Planar_T pixels, unsigned nthreads);
+static void      block_fields(uint64_t codeword, int *fields);
+static uint64_t  fields_block(const int *fields);
+static void      put_u32(uint32_t value, FILE *file);
+static uint32_t  get_u32(FILE *file);
+
+/* FUNCTION:  Sequence_compress
+ * Purpose:   Compresses a sequence of PPMs
+ * Arg:       input: pointer to one or more PPMs of the same size, one after
+ *                   another; it can be a pipe
+ *            output: pointer to a file open for writing
+ *            nthreads: worker threads for the stages of each frame
+ * Returns:   The size of the frames in 8 bit pixels
+ * Effect:    Holds the pixels and codewords of the frame before, and
+ *            writes each frame as soon as it is compressed
+ * Error:     Runtime error if a NULL pointer is passed in, if nthreads is
+ *            0, if input holds no PPM or if the frames differ in size
+ */
+size_t Sequence_compress(FILE *input, FILE *output, unsigned nthreads)
+{
+        assert(input != NULL && output != NULL);
+        assert(nthreads > 0);
+        bool any = next_frame(input);
+        assert(any);
+
+        Planar_T previous = NULL;
+        UArray2_T reference = NULL;
+        int width = 0, height = 0;
+        size_t bytes = 0;
+
+        while (next_frame(input)) {
+                ppm_RGBfloats_stream_T stream =
+                        ppm_RGBfloats_stream_open(input);
+                if (previous == NULL) {
+                        width = ppm_RGBfloats_stream_width(stream);
+                        height = ppm_RGBfloats_stream_height(stream);
+                        fprintf(output, "COMP40 Compressed image format "
+                                "%d\n%u %u\n", SEQUENCE_FORMAT, width,
+                                height);
+                }
+                assert(ppm_RGBfloats_stream_width(stream) == width);
+                assert(ppm_RGBfloats_stream_height(stream) == height);
+
+                Planar_T current = Planar_new(width, height, 3);
+                ppm_RGBfloats_stream_read(stream, current);
+                ppm_RGBfloats_stream_finish(stream);
+                ppm_RGBfloats_stream_free(&stream);
+
+                UArray2_T codewords = compress_rows(current, previous,
+                                                    reference, nthreads);
+                write_frame(output, codewords, reference);
+
+                if (previous != NULL) {
+                        Planar_free(&previous);
+                        UArray2_free(&reference);
+                }
+                previous = current;
+                reference = codewords;
+                bytes += (size_t)width * height * 3;
+        }
+
+        Planar_free(&previous);
+        UArray2_free(&reference);
+
+        return bytes;
+}
+
+/* FUNCTION:  Sequence_decompress
+ * Purpose:   Decompresses a sequence to PPMs
+ * Arg:       input: pointer to a file, just after the header
+ *            width, height: the dimensions of the frames from the header
+ *            output: pointer to a file open for writing
+ *            nthreads: worker threads for the stages of each frame
+ * Returns:   The size of the frames in 8 bit pixels
+ * Effect:    Holds the codewords and pixels of the frame before, and
+ *            writes each frame as soon as it is decoded
+ * Error:     Runtime error if a NULL pointer is passed in, if nthreads is
+ *            0 or if a frame is not valid
+ */
+size_t Sequence_decompress(FILE *input, unsigned width, unsigned height,
+                           FILE *output, unsigned nthreads)
+{
+        assert(input != NULL && output != NULL);
+        assert(nthreads > 0);
+
+        UArray2_T codewords = UArray2_new(width / 2, height / 2,
+                                          sizeof(uint64_t));
+        Planar_T pixels = Planar_new(width, height, 3);
+        bool *changed = malloc(height / 2 + 1);
+        assert(changed != NULL);
+        size_t bytes = 0;
+
+        while (read_frame(input, codewords, changed)) {
+                decompress_rows(codewords, changed, pixels, nthreads);
+                ppm_RGBfloats_write_planar(pixels, output);
+                bytes += (size_t)width * height * 3;
+        }
+
+        free(changed);
+        Planar_free(&pixels);
+        UArray2_free(&codewords);
+
+        return bytes;
+}
+
+/* FUNCTION:  next_frame
+ * Purpose:   Tells whether another PPM follows in the input
+ * Arg:       input: pointer to the input
+ * Returns:   true if anything but white space is left
+ * Effect:    Skips white space between frames
+ * Error:     N/A
+ */
+static bool next_frame(FILE *input)
+{
+        int c;
+        do {
+                c = getc(input);
+        } while (c != EOF && isspace(c));
+
+        if (c == EOF) {
+                return false;
+        }
+        ungetc(c, input);
+        return true;
+}
+
+/* FUNCTION:  compress_rows
+ * Purpose:   Gives the codewords of a frame, compressing only the rows of
+ *            blocks whose pixels changed
+ * Arg:       current: the pixels of the frame
+ *            previous: the pixels of the frame before, or NULL
+ *            reference: the codewords of the frame before, or NULL
+ *            nthreads: the number of worker threads
+ * Returns:   Pointer to a new UArray2 of the codewords of the frame
+ * Effect:    The changed rows are copied into one band, which is
+ *            compressed as an image; current is not changed
+ * Error:     N/A
+ */
+static UArray2_T compress_rows(Planar_T current, Planar_T previous,
+                               UArray2_T reference, unsigned nthreads)
+{
+        int width = Planar_width(current);
+        int rows = Planar_height(current) / 2;
+        UArray2_T codewords = UArray2_new(width / 2, rows,
+                                          sizeof(uint64_t));
+        size_t row_bytes = (size_t)(width / 2) * sizeof(uint64_t);
+
+        bool *changed = malloc(rows + 1);
+        assert(changed != NULL);
+        int row, nchanged = 0;
+        for (row = 0; row < rows; row++) {
+                changed[row] = previous == NULL ||
+                               rows_differ(current, previous, row);
+                nchanged += changed[row];
+                if (!changed[row] && width > 0) {
+                        memcpy(UArray2_row(codewords, row),
+                               UArray2_row(reference, row), row_bytes);
+                }
+        }
+
+        if (nchanged > 0 && width > 0) {
+                Planar_T band = Planar_new(width, nchanged * 2, 3);
+                int i = 0, plane, k;
+                for (row = 0; row < rows; row++) {
+                        for (k = 0; changed[row] && k < 2; k++, i++) {
+                                for (plane = 0; plane < 3; plane++) {
+                                        memcpy(Planar_row(band, plane, i),
+                                               Planar_row(current, plane,
+                                                          2 * row + k),
+                                               width * sizeof(float));
+                                }
+                        }
+                }
+
+                UArray2_T packed = Row_bands_compress(band, nthreads, NULL);
+
+                for (row = 0, i = 0; row < rows; row++) {
+                        if (changed[row]) {
+                                memcpy(UArray2_row(codewords, row),
+                                       UArray2_row(packed, i++), row_bytes);
+                        }
+                }
+                UArray2_free(&packed);
+        }
+
+        free(changed);
+
+        return codewords;
+}
+
+/* FUNCTION:  rows_differ
+ * Purpose:   Tells whether the pixels of a row of blocks changed
+ * Arg:       current, previous: the pixels of two frames of the same size
+ *            row: the row of blocks
+ * Returns:   true if any sample of its two rows of pixels differs
+ * Effect:    Equal samples convert to equal floats, so the floats are
+ *            compared bit for bit
+ * Error:     N/A
+ */
+static bool rows_differ(Planar_T current, Planar_T previous, int row)
+{
+        size_t bytes = Planar_width(current) * sizeof(float);
+        int plane, k;
+        for (plane = 0; plane < 3; plane++) {
+                for (k = 0; k < 2; k++) {
+                        if (memcmp(Planar_row(current, plane, 2 * row + k),
+                                   Planar_row(previous, plane, 2 * row + k),
+                                   bytes) != 0) {
+                                return true;
+                        }
+                }
+        }
+
+        return false;
+}
+
+/* FUNCTION:  write_frame
+ * Purpose:   Writes the codewords of a frame
+ * Arg:       output: pointer to a file open for writing
+ *            codewords: the codewords of the frame
+ *            reference: the codewords of the frame before, or NULL
+ * Returns:   N/A
+ * Effect:    Writes a delta frame when there is a frame before and the
+ *            delta is smaller than the codewords, and a key frame
+ *            otherwise, which is empty when the frame is less than 2
+ *            pixels wide
+ * Error:     Runtime error if the write fails
+ */
+static void write_frame(FILE *output, UArray2_T codewords,
+                        UArray2_T reference)
+{
+        int cols = UArray2_width(codewords);
+        int rows = UArray2_height(codewords);
+        size_t key_bytes = (size_t)cols * rows * (CODEWORD_WIDTH / 8);
+
+        if (reference != NULL && cols > 0) {
+                Bit_stream_T stream = Bit_stream_new();
+                int row, col, i;
+                for (row = 0; row < rows; row++) {
+                        const uint64_t *now = UArray2_row(codewords, row);
+                        const uint64_t *before = UArray2_row(reference, row);
+                        for (col = 0; col < cols; col++) {
+                                Bit_stream_put(stream, 1,
+                                               now[col] != before[col]);
+                        }
+                }
+                for (row = 0; row < rows; row++) {
+                        const uint64_t *now = UArray2_row(codewords, row);
+                        const uint64_t *before = UArray2_row(reference, row);
+                        for (col = 0; col < cols; col++) {
+                                if (now[col] == before[col]) {
+                                        continue;
+                                }
+                                int fields[FIELDS], old[FIELDS];
+                                block_fields(now[col], fields);
+                                block_fields(before[col], old);
+                                for (i = 0; i < FIELDS; i++) {
+                                        Bit_stream_put_se(stream, fields[i] -
+                                                                  old[i]);
+                                }
+                        }
+                }
+
+                size_t length;
+                const unsigned char *bytes = Bit_stream_bytes(stream,
+                                                              &length);
+                bool smaller = length < key_bytes;
+                if (smaller) {
+                        putc(DELTA_FRAME, output);
+                        put_u32(length, output);
+                        size_t written = fwrite(bytes, 1, length, output);
+                        assert(written == length);
+                }
+                Bit_stream_free(&stream);
+                if (smaller) {
+                        return;
+                }
+        }
+
+        putc(KEY_FRAME, output);
+        Codewords_File_write_rows(codewords, output);
+}
+
+/* FUNCTION:  read_frame
+ * Purpose:   Reads the next frame of a sequence over the codewords of the
+ *            frame before
+ * Arg:       input: pointer to the sequence, at the start of a frame
+ *            codewords: the codewords of the frame before, which become
+ *                       those of the frame
+ *            changed: receives, for each row of blocks, whether any of its
+ *                     codewords changed
+ * Returns:   false at the end of the input, true otherwise
+ * Effect:    A key frame changes every row
+ * Error:     Runtime error if the frame is not valid
+ */
+static bool read_frame(FILE *input, UArray2_T codewords, bool *changed)
+{
+        int cols = UArray2_width(codewords);
+        int rows = UArray2_height(codewords);
+        int kind = getc(input);
+        if (kind == EOF) {
+                return false;
+        }
+
+        int row, col, i;
+        if (kind == KEY_FRAME) {
+                UArray2_T key = Codewords_File_read_codewords(input, 2,
+                                                              cols * 2,
+                                                              rows * 2);
+                size_t row_bytes = (size_t)cols * sizeof(uint64_t);
+                for (row = 0; row < rows; row++) {
+                        if (cols > 0) {
+                                memcpy(UArray2_row(codewords, row),
+                                       UArray2_row(key, row), row_bytes);
+                        }
+                        changed[row] = true;
+                }
+                UArray2_free(&key);
+                return true;
+        }
+        assert(kind == DELTA_FRAME);
+
+        uint32_t length = get_u32(input);
+        unsigned char *bytes = malloc((size_t)length + 1);
+        assert(bytes != NULL);
+        size_t got = fread(bytes, 1, length, input);
+        assert(got == length);
+        Bit_stream_T stream = Bit_stream_open(bytes, length);
+
+        /* the bitmap comes first in the stream, one bit per block, so it
+           is read into an array of its own before the changed fields */
+        uint8_t *bitmap = malloc((size_t)cols * rows + 1);
+        assert(bitmap != NULL);
+        for (i = 0; i < cols * rows; i++) {
+                bitmap[i] = Bit_stream_get(stream, 1);
+        }
+
+        for (row = 0; row < rows; row++) {
+                uint64_t *words = cols > 0 ? UArray2_row(codewords, row)
+                                           : NULL;
+                changed[row] = false;
+                for (col = 0; col < cols; col++) {
+                        if (!bitmap[row * cols + col]) {
+                                continue;
+                        }
+                        int fields[FIELDS];
+                        block_fields(words[col], fields);
+                        for (i = 0; i < FIELDS; i++) {
+                                fields[i] += Bit_stream_get_se(stream);
+                        }
+                        words[col] = fields_block(fields);
+                        changed[row] = true;
+                }
+        }
+
+        free(bitmap);
+        Bit_stream_free(&stream);
+        free(bytes);
+
+        return true;
+}
+
+/* FUNCTION:  decompress_rows
+ * Purpose:   Decodes the changed rows of blocks of a frame into its pixels
+ * Arg:       codewords: the codewords of the frame
+ *            changed: for each row of blocks, whether it changed
+ *            pixels: the pixels of the frame before, which become those of
+ *                    the frame
+ *            nthreads: the number of worker threads
+ * Returns:   N/A
+ * Effect:    The changed rows are copied into one band of codewords, which
+ *            is decoded as an image; codewords is not changed
+ * Error:     N/A
+ */
+static void decompress_rows(UArray2_T codewords, const bool *changed,
+                            Planar_T pixels, unsigned nthreads)
+{
+        int cols = UArray2_width(codewords);
+        int rows = UArray2_height(codewords);
+        int row, nchanged = 0;
+        for (row = 0; row < rows; row++) {
+                nchanged += changed[row];
+        }
+        if (nchanged == 0 || cols == 0) {
+                return;
+        }
+
+        UArray2_T band = UArray2_new(cols, nchanged, sizeof(uint64_t));
+        int i = 0;
+        for (row = 0; row < rows; row++) {
+                if (changed[row]) {
+                        memcpy(UArray2_row(band, i++),
+                               UArray2_row(codewords, row),
+                               cols * sizeof(uint64_t));
+                }
+        }
+
+        Planar_T rgb_floats = Row_bands_decompress(band, nthreads, NULL);
+
+        int plane, k;
+        for (row = 0, i = 0; row < rows; row++) {
+                for (k = 0; changed[row] && k < 2; k++, i++) {
+                        for (plane = 0; plane < 3; plane++) {
+                                memcpy(Planar_row(pixels, plane,
+                                                  2 * row + k),
+                                       Planar_row(rgb_floats, plane, i),
+                                       cols * 2 * sizeof(float));
+                        }
+                }
+        }
+
+        Planar_free(&rgb_floats);
+}
+
+/* FUNCTION:  block_fields
+ * Purpose:   Splits a codeword into the fields a delta frame stores
+ * Arg:       codeword: the codeword
+ *            fields: receives a, b, c, d, avgPb and avgPr
+ * Returns:   N/A
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static void block_fields(uint64_t codeword, int *fields)
+{
+        struct DCT_ints dct_ints = Bitpack_inline_unpack(codeword);
+
+        fields[0] = dct_ints.a;
+        fields[1] = dct_ints.b;
+        fields[2] = dct_ints.c;
+        fields[3] = dct_ints.d;
+        fields[4] = dct_ints.avgPb;
+        fields[5] = dct_ints.avgPr;
+}
+
+/* FUNCTION:  fields_block
+ * Purpose:   Packs the fields a delta frame stores into a codeword
+ * Arg:       fields: a, b, c, d, avgPb and avgPr
+ * Returns:   The codeword
+ * Effect:    N/A
+ * Error:     Runtime error if a field does not fit its width
+ */
+static uint64_t fields_block(const int *fields)
+{
+        int i;
+        assert(fields[0] >= 0 && fields[0] < (1 << A_WIDTH));
+        for (i = 1; i <= 3; i++) {
+                assert(fields[i] >= -(1 << (BCD_WIDTH - 1)) &&
+                       fields[i] < (1 << (BCD_WIDTH - 1)));
+        }
+        for (i = 4; i <= 5; i++) {
+                assert(fields[i] >= 0 && fields[i] < (1 << AVG_PBPR_WIDTH));
+        }
+
+        struct DCT_ints dct_ints;
+        dct_ints.a = fields[0];
+        dct_ints.b = fields[1];
+        dct_ints.c = fields[2];
+        dct_ints.d = fields[3];
+        dct_ints.avgPb = fields[4];
+        dct_ints.avgPr = fields[5];
+
+        return Bitpack_inline_pack(dct_ints);
+}
+
+/* FUNCTION:  put_u32
+ * Purpose:   Writes a 32 bit value, most significant byte first
+ * Arg:       value: the value
+ *            file: pointer to a file open for writing
+ * Returns:   N/A
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static void put_u32(uint32_t value, FILE *file)
+{
+        putc(value >> 24, file);
+        putc((value >> 16) & 0xff, file);
+        putc((value >> 8) & 0xff, file);
+        putc(value & 0xff, file);
+}
+
+/* FUNCTION:  get_u32
+ * Purpose:   Reads a 32 bit value stored most significant byte first
+ * Arg:       file: pointer to a file instance
+ * Returns:   The value
+ * Effect:    N/A
+ * Error:     Runtime error if the file ends early
+ */
+static uint32_t get_u32(FILE *file)
+{
+        unsigned char bytes[4];
+        size_t got = fread(bytes, 1, 4, file);
+        assert(got == 4);
+
+        return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) |
+               ((uint32_t)bytes[2] << 8) | bytes[3];
+}
@@ -0,0 +1,63 @@
+/*****************************************************************************
+ *
+ *                                 Sequence.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Sequence module. The purpose of
+ *     this module is to compress a sequence of frames of the same size,
+ *     such as those of a fixed camera, given as PPMs one after another
+ *     (40image -c --sequence, header "COMP40 Compressed image format 5").
+ *     The first frame is stored as plain codewords. Every later frame
+ *     stores a bitmap of the 2 by 2 blocks whose codewords changed since
+ *     the frame before, and the change of each field of those blocks;
+ *     when that would be larger than the codewords themselves, the frame
+ *     is stored as codewords again. Only rows of pixels that changed are
+ *     compressed. Frames are read, compressed and written one at a time,
+ *     and decoded the same way, so neither side holds more than two frames.
+ *     Each decoded frame is identical to the frame compressed on its own.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stddef.h>
+
+#ifndef SEQUENCE_INCLUDED
+#define SEQUENCE_INCLUDED
+
+/* number in the header of the sequence format */
+#define SEQUENCE_FORMAT 5
+
+/* FUNCTION:  Sequence_compress
+ * Purpose:   Compresses a sequence of PPMs
+ * Arg:       input: pointer to one or more binary or plain PPMs of the same
+ *                   size, one after another; it can be a pipe
+ *            output: pointer to a file open for writing
+ *            nthreads: worker threads for the stages of each frame
+ * Returns:   The size of the frames in 8 bit pixels (width x height x 3
+ *            bytes each, after trimming), for throughput reports
+ * Effect:    Writes the header, then each frame as soon as it is
+ *            compressed
+ * Error:     Runtime error if a NULL pointer is passed in, if nthreads is
+ *            0, if input holds no PPM or if the frames differ in size
+ */
+size_t Sequence_compress(FILE *input, FILE *output, unsigned nthreads);
+
+/* FUNCTION:  Sequence_decompress
+ * Purpose:   Decompresses a sequence to PPMs
+ * Arg:       input: pointer to a file, just after the header read by
+ *                   Codewords_File_read_header
+ *            width, height: the dimensions of the frames from the header
+ *            output: pointer to a file open for writing
+ *            nthreads: worker threads for the stages of each frame
+ * Returns:   The size of the frames in 8 bit pixels
+ * Effect:    Writes each frame as a PPM as soon as it is decoded
+ * Error:     Runtime error if a NULL pointer is passed in, if nthreads is
+ *            0 or if a frame is not valid
+ */
+size_t Sequence_decompress(FILE *input, unsigned width, unsigned height,
+                           FILE *output, unsigned nthreads);
+
+#endif
@@ -0,0 +1,178 @@
+/*****************************************************************************
+ *
+ *                               Stage_timer.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the private implementation of our Stage_timer module. Wall
+ *     time comes from the monotonic clock and the peak resident set size
+ *     from getrusage, which reports it in kilobytes.
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "Stage_timer.h"
+
+#define T Stage_timer_T
+
+/* bytes in a megabyte, for MB/s */
+#define MEGABYTE 1e6
+
+/*
+ * report: the stream lines are written to, or NULL
+ * prefix: put in front of every stage name
+ * start:  when the timer was made
+ * lap:    when the last stage ended
+ */
+struct T {
+        FILE *report;
+        const char *prefix;
+        struct timespec start;
+        struct timespec lap;
+};
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static double seconds_between(struct timespec from, struct timespec to);
+static long   peak_rss_bytes(void);
+static void   report_line(T timer, const char *stage, double seconds,
+                          size_t bytes);
+
+/* FUNCTION:  Stage_timer_new
+ * Purpose:   Starts a timer for a run of stages
+ * Arg:       report: the stream the lines are written to, or NULL for a
+ *                    timer that does nothing
+ *            prefix: put in front of every stage name, e.g. "compress"
+ * Returns:   A new timer; the first lap is measured from now
+ * Effect:    Writes the header line to report if it has not been written
+ * Error:     Runtime error if prefix is NULL or memory cannot be allocated
+ */
+T Stage_timer_new(FILE *report, const char *prefix)
+{
+        assert(prefix != NULL);
+
+        /* the header is only written once per run of the program */
+        static bool header_written = false;
+
+        T timer = malloc(sizeof(*timer));
+        assert(timer != NULL);
+
+        timer->report = report;
+        timer->prefix = prefix;
+        if (report != NULL && !header_written) {
+                fprintf(report, "stage\tseconds\tMB/s\tpeak_rss_bytes\n");
+                header_written = true;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &timer->start);
+        timer->lap = timer->start;
+
+        return timer;
+}
+
+/* FUNCTION:  Stage_timer_lap
+ * Purpose:   Ends a stage and reports it
+ * Arg:       timer: an initialized timer
+ *            stage: the name of the stage
+ *            bytes: the number of bytes the stage processed
+ * Returns:   N/A
+ * Effect:    Writes one line to the report stream; the next stage is
+ *            measured from now
+ * Error:     Runtime error if timer or stage is NULL
+ */
+void Stage_timer_lap(T timer, const char *stage, size_t bytes)
+{
+        assert(timer != NULL);
+        assert(stage != NULL);
+
+        if (timer->report == NULL) {
+                return;
+        }
+
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        report_line(timer, stage, seconds_between(timer->lap, now), bytes);
+        timer->lap = now;
+}
+
+/* FUNCTION:  Stage_timer_free
+ * Purpose:   Reports the total of all stages and deallocates the timer
+ * Arg:       timer: the address of an initialized timer
+ *            bytes: the number of bytes for the total line
+ * Returns:   N/A
+ * Effect:    Writes the total line and sets *timer to NULL
+ * Error:     Runtime error if timer or *timer is NULL
+ */
+void Stage_timer_free(T *timer, size_t bytes)
+{
+        assert(timer != NULL);
+        assert(*timer != NULL);
+
+        if ((*timer)->report != NULL) {
+                struct timespec now;
+                clock_gettime(CLOCK_MONOTONIC, &now);
+                report_line(*timer, "total", 
+                            seconds_between((*timer)->start, now), bytes);
+                fflush((*timer)->report);
+        }
+
+        free(*timer);
+        *timer = NULL;
+}
+
+/* FUNCTION:  seconds_between
+ * Purpose:   Computes the time between two readings of the clock
+ * Arg:       from, to: the readings
+ * Returns:   to - from, in seconds
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static double seconds_between(struct timespec from, struct timespec to)
+{
+        return (double)(to.tv_sec - from.tv_sec) + 
+               (double)(to.tv_nsec - from.tv_nsec) / 1e9;
+}
+
+/* FUNCTION:  peak_rss_bytes
+ * Purpose:   Returns the largest resident set size of the process so far
+ * Arg:       N/A
+ * Returns:   The size in bytes, or -1 if it cannot be read
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static long peak_rss_bytes(void)
+{
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+                return -1;
+        }
+
+        return usage.ru_maxrss * 1024L;
+}
+
+/* FUNCTION:  report_line
+ * Purpose:   Writes the line of one stage
+ * Arg:       timer: an initialized timer with a report stream
+ *            stage: the name of the stage
+ *            seconds: the time the stage took
+ *            bytes: the number of bytes the stage processed
+ * Returns:   N/A
+ * Effect:    Writes to the report stream
+ * Error:     N/A
+ */
+static void report_line(T timer, const char *stage, double seconds,
+                        size_t bytes)
+{
+        double rate = seconds > 0 ? bytes / MEGABYTE / seconds : 0;
+
+        fprintf(timer->report, "%s.%s\t%.6f\t%.1f\t%ld\n", timer->prefix,
+                stage, seconds, rate, peak_rss_bytes());
+}
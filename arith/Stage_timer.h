@@ -0,0 +1,69 @@
+/*****************************************************************************
+ *
+ *                               Stage_timer.h
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the public interface of our Stage_timer module. The purpose of
+ *     this module is to time the stages of compress40 and decompress40
+ *     (40image -T). The caller marks the end of each stage with a lap; for
+ *     every lap one tab separated line is written to the report stream:
+ *
+ *         stage  seconds  MB/s  peak_rss_bytes
+ *
+ *     seconds is the wall clock time since the previous lap, MB/s is the
+ *     number of bytes given for the stage (10^6 bytes to the MB) divided by
+ *     seconds, and peak_rss_bytes is the largest resident set size of the
+ *     process so far, so a stage that raises it is the one that allocated
+ *     the most. Stage_timer_free writes a final "total" line. A timer made
+ *     with a NULL stream does nothing, so the calls can stay in place when
+ *     timing is off.
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stddef.h>
+
+#ifndef STAGETIMER_INCLUDED
+#define STAGETIMER_INCLUDED
+
+#define T Stage_timer_T
+typedef struct T *T;
+
+/* FUNCTION:  Stage_timer_new
+ * Purpose:   Starts a timer for a run of stages
+ * Arg:       report: the stream the lines are written to, or NULL for a
+ *                    timer that does nothing
+ *            prefix: put in front of every stage name, e.g. "compress"
+ * Returns:   A new timer; the first lap is measured from now
+ * Effect:    Writes the header line to report if it has not been written
+ * Error:     Runtime error if prefix is NULL or memory cannot be allocated
+ */
+extern T Stage_timer_new(FILE *report, const char *prefix);
+
+/* FUNCTION:  Stage_timer_lap
+ * Purpose:   Ends a stage and reports it
+ * Arg:       timer: an initialized timer
+ *            stage: the name of the stage
+ *            bytes: the number of bytes the stage processed
+ * Returns:   N/A
+ * Effect:    Writes one line to the report stream; the next stage is
+ *            measured from now
+ * Error:     Runtime error if timer or stage is NULL
+ */
+extern void Stage_timer_lap(T timer, const char *stage, size_t bytes);
+
+/* FUNCTION:  Stage_timer_free
+ * Purpose:   Reports the total of all stages and deallocates the timer
+ * Arg:       timer: the address of an initialized timer
+ *            bytes: the number of bytes for the total line
+ * Returns:   N/A
+ * Effect:    Writes the total line and sets *timer to NULL
+ * Error:     Runtime error if timer or *timer is NULL
+ */
+extern void Stage_timer_free(T *timer, size_t bytes);
+
+#undef T
+#endif
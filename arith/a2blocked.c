@@ -0,0 +1,248 @@
+/*
+ *      a2blocked.c
+ *      by Eric Zhao, October 2022
+ *
+ *      Summary:
+ *      This is the private methods suite of our blocked 2 dimensional
+ *      unboxed array data structure: UArray2b. Every entry point of
+ *      A2Methods_T is implemented. Block-major mapping is the default
+ *      because it visits elements in the order they are stored; row-major
+ *      and column-major mapping go through UArray2b_at and are slower. This
+ *      methods suite is of type A2Methods_T.
+ */
+
+#include <string.h>
+#include <assert.h>
+
+#include <a2blocked.h>
+#include "uarray2b.h"
+
+
+/************************************************/
+/* Define a private version of each function in */
+/* A2Methods_T that we implement.               */
+/************************************************/
+
+/*
+ * Description: This function makes a new UArray2b based on the given width,
+ *              height and element size, with the largest blocks that fit in
+ *              64KB
+ * Expected inputs:  
+ *       width: non-negative int for the array width
+ *       height: non-negative int for the array height
+ *       size: positive int for the bytes occupied by each element
+ * Expected outputs: A new instance of the UArray2b struct
+ */
+static A2Methods_UArray2 new(int width, int height, int size)
+{
+        return UArray2b_new_64K_block(width, height, size);
+}
+
+/*
+ * Description: This function makes a new UArray2b based on the given width,
+ *              height, element size and blocksize
+ * Expected inputs:  
+ *       width: non-negative int for the array width
+ *       height: non-negative int for the array height
+ *       size: positive int for the bytes occupied by each element
+ *       blocksize: positive int for the number of elements on a side of a
+ *                  block
+ * Expected outputs: A new instance of the UArray2b struct
+ */
+static A2Methods_UArray2 new_with_blocksize(int width, int height,
+                                            int size, int blocksize)
+{
+        return UArray2b_new(width, height, size, blocksize);
+}
+
+/*
+ * Description:      This function frees the memory associated with the given
+ *                   UArray2b
+ * Expected inputs:  
+ *      array2p: A pointer to an initialized UArray2b
+ * Expected outputs: Nothing
+ */
+static void a2free(A2Methods_UArray2 *array2p) 
+{
+        UArray2b_free((UArray2b_T *) array2p);
+}
+
+/*
+ * Description: These functions return the width, height, element size and
+ *              blocksize of the given UArray2b
+ * Expected inputs:
+ *       array2: an initialized UArray2b
+ * Expected outputs: The requested positive int
+ */
+static int width(A2Methods_UArray2 array2)
+{
+        return UArray2b_width(array2);
+}
+
+static int height(A2Methods_UArray2 array2)
+{
+        return UArray2b_height(array2);
+}
+
+static int size(A2Methods_UArray2 array2) 
+{
+        return UArray2b_size(array2);
+}
+
+static int blocksize(A2Methods_UArray2 array2) 
+{
+        return UArray2b_blocksize(array2);
+}
+
+/*
+ * Description: This function returns the location of an element at the
+ *              given column and row
+ * Expected inputs: 
+ *       array2: an initialized UArray2b
+ *       col: non-negative int for the column in the UArray2b
+ *       row: non-negative int for the row in the UArray2b
+ * Expected outputs: A pointer to the corresponding location in the UArray2b
+ */
+static A2Methods_Object *at(A2Methods_UArray2 array2, int col, int row)
+{
+        return UArray2b_at(array2, col, row);
+}
+
+/*
+ * Description: This function calls a given function on every element of 
+ *              the UArray2b, one block at a time
+ * Expected inputs:
+ *       array: an initialized UArray2b
+ *       apply: a void function pointer to an apply function
+ *       cl: a void pointer to pass in values
+ * Expected outputs: Nothing from the function itself. Outputs depend on
+ *                   void function that is passed in
+ */
+static void map_block_major(A2Methods_UArray2 uarray2b,
+                            A2Methods_applyfun apply,
+                            void *cl)
+{
+        UArray2b_map(uarray2b, (void (*)(int, int, UArray2b_T, void *, 
+                                         void *))apply, cl);
+}
+
+/*
+ * Description:      This function calls a given function on every element of
+ *                   the UArray2b, incrementing columns faster than rows
+ * Expected inputs:
+ *       array: an initialized UArray2b
+ *       apply: a void function pointer to an apply function
+ *       cl: a void pointer to pass in values
+ * Expected outputs: Nothing from the function itself. Outputs depend on
+ *                   void function that is passed in
+ */
+static void map_row_major(A2Methods_UArray2 uarray2b,
+                          A2Methods_applyfun apply,
+                          void *cl)
+{
+        assert(apply != NULL);
+
+        int w = UArray2b_width(uarray2b);
+        int h = UArray2b_height(uarray2b);
+
+        int col, row;
+        for (row = 0; row < h; row++) {
+                for (col = 0; col < w; col++) {
+                        apply(col, row, uarray2b, 
+                              UArray2b_at(uarray2b, col, row), cl);
+                }
+        }
+}
+
+/*
+ * Description: This function calls a given function on every element of 
+ *              the UArray2b, incrementing rows faster than columns
+ * Expected inputs:
+ *       array: an initialized UArray2b
+ *       apply: a void function pointer to an apply function
+ *       cl: a void pointer to pass in values
+ * Expected outputs: Nothing from the function itself. Outputs depend on
+ *                   void function that is passed in
+ */
+static void map_col_major(A2Methods_UArray2 uarray2b,
+                          A2Methods_applyfun apply,
+                          void *cl)
+{
+        assert(apply != NULL);
+
+        int w = UArray2b_width(uarray2b);
+        int h = UArray2b_height(uarray2b);
+
+        int col, row;
+        for (col = 0; col < w; col++) {
+                for (row = 0; row < h; row++) {
+                        apply(col, row, uarray2b, 
+                              UArray2b_at(uarray2b, col, row), cl);
+                }
+        }
+}
+
+struct small_closure {
+        A2Methods_smallapplyfun *apply; 
+        void                    *cl;
+};
+
+static void apply_small(int i, int j, A2Methods_UArray2 uarray2b,
+                        void *elem, void *vcl)
+{
+        struct small_closure *cl = vcl;
+        (void)i;
+        (void)j;
+        (void)uarray2b;
+        cl->apply(elem, cl->cl);
+}
+
+static void small_map_block_major(A2Methods_UArray2        a2,
+                                  A2Methods_smallapplyfun  apply,
+                                  void *cl)
+{
+        struct small_closure mycl = { apply, cl };
+        map_block_major(a2, apply_small, &mycl);
+}
+
+static void small_map_row_major(A2Methods_UArray2        a2,
+                                A2Methods_smallapplyfun  apply,
+                                void *cl)
+{
+        struct small_closure mycl = { apply, cl };
+        map_row_major(a2, apply_small, &mycl);
+}
+
+static void small_map_col_major(A2Methods_UArray2        a2,
+                                A2Methods_smallapplyfun  apply,
+                                void *cl)
+{
+        struct small_closure mycl = { apply, cl };
+        map_col_major(a2, apply_small, &mycl);
+}
+
+/* 
+ * Struct defining which static function to use for each function in the
+ * method suite
+ */
+static struct A2Methods_T uarray2_methods_blocked_struct = {
+        new,
+        new_with_blocksize,
+        a2free,
+        width,
+        height,
+        size,
+        blocksize,
+        at,
+        map_row_major,          
+        map_col_major,          
+        map_block_major,
+        map_block_major,        /* map_default */
+        small_map_row_major,
+        small_map_col_major,
+        small_map_block_major,
+        small_map_block_major,  /* small_map_default */
+};
+
+/* Here is the exported pointer to the struct */
+A2Methods_T uarray2_methods_blocked = &uarray2_methods_blocked_struct;
@@ -208,11 +208,11 @@ static struct A2Methods_T uarray2_methods_plain_struct = {
         at,
         map_row_major,          
         map_col_major,          
-        NULL,                   /* map_block_major */
+        map_row_major,          /* map_block_major: blocks are 1 by 1 */
         map_row_major,          /* map_default */
         small_map_row_major,
         small_map_col_major,
-        NULL,                   /* small_map_block_major */
+        small_map_row_major,    /* small_map_block_major */
         small_map_row_major,    /* small_map_default */
 };
 
@@ -0,0 +1,85 @@
+#!/bin/sh
+#
+# bench.sh
+# Project:    Arith
+#
+# Benchmark harness run by make bench. For every kind of synthetic image
+# (gradient, noise, photo) and every size in megapixels given on the command
+# line, generates a PPM with ppmgen, compresses and decompresses it with
+# 40image -T, and prints one tab separated line:
+#
+#   image  width  height  c_MB/s  c_peak_rss  d_MB/s  d_peak_rss  ratio
+#          base_c_MB/s  base_d_MB/s
+#
+# MB/s and peak RSS come from the total lines of -T; ratio is the size of
+# the PPM over the size of the compressed file. The base columns are the
+# throughputs recorded in bench_baseline.tsv for the same image (- if there
+# are none). Dimensions are always odd so that trim_dimension is exercised.
+#
+# Environment:
+#   BENCH_DIR      where the images are written (default /tmp/40image-bench)
+#   BENCH_FLAGS    extra flags for 40image, e.g. "-j 4"
+#   BENCH_UPDATE   if set, the results replace bench_baseline.tsv
+
+set -e
+
+cd "$(dirname "$0")"
+BENCH_DIR=${BENCH_DIR:-/tmp/40image-bench}
+BASELINE=bench_baseline.tsv
+mkdir -p "$BENCH_DIR"
+
+if [ $# -eq 0 ]; then
+        set -- 0.1 1 10 50
+fi
+
+results="$BENCH_DIR/results.tsv"
+: > "$results"
+
+printf 'image\twidth\theight\tc_MB/s\tc_peak_rss\td_MB/s\td_peak_rss'
+printf '\tratio\tbase_c_MB/s\tbase_d_MB/s\n'
+
+for mp in "$@"; do
+        # a 4:3 image of about mp megapixels, with odd width and height
+        dims=$(awk -v mp="$mp" 'BEGIN {
+                w = int(sqrt(mp * 1e6 * 4 / 3)); h = int(mp * 1e6 / w);
+                if (w % 2 == 0) w++; if (h % 2 == 0) h++; print w, h }')
+        width=${dims% *}
+        height=${dims#* }
+
+        for kind in gradient noise photo; do
+                name="$kind-${mp}mp"
+                ppm="$BENCH_DIR/$name.ppm"
+                cmp="$BENCH_DIR/$name.cmp"
+
+                ./ppmgen "$kind" "$width" "$height" > "$ppm"
+                ./40image-6 $BENCH_FLAGS -T -c "$ppm" > "$cmp" \
+                        2> "$BENCH_DIR/$name.c.tsv"
+                ./40image-6 $BENCH_FLAGS -T -d "$cmp" > /dev/null \
+                        2> "$BENCH_DIR/$name.d.tsv"
+
+                c=$(awk -F'\t' '$1 == "compress.total" {print $3 "\t" $4}' \
+                        "$BENCH_DIR/$name.c.tsv")
+                d=$(awk -F'\t' '$1 == "decompress.total" {print $3 "\t" $4}' \
+                        "$BENCH_DIR/$name.d.tsv")
+                ratio=$(awk -v p=$(wc -c < "$ppm") -v c=$(wc -c < "$cmp") \
+                        'BEGIN { printf "%.2f", p / c }')
+                base=$(awk -F'\t' -v n="$name" \
+                        '$1 == n {print $4 "\t" $6; found = 1}
+                         END {if (!found) print "-\t-"}' \
+                        "$BASELINE" 2> /dev/null || printf -- '-\t-')
+
+                line="$name\t$width\t$height\t$c\t$d\t$ratio"
+                printf "$line\t$base\n"
+                printf "$line\n" >> "$results"
+
+                rm -f "$ppm" "$cmp"
+        done
+done
+
+if [ -n "$BENCH_UPDATE" ]; then
+        {
+                printf 'image\twidth\theight\tc_MB/s\tc_peak_rss\td_MB/s'
+                printf '\td_peak_rss\tratio\n'
+                cat "$results"
+        } > "$BASELINE"
+fi
@@ -16,52 +16,649 @@
  *
  ****************************************************************************/
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
+#include <stdbool.h>
 #include "compress40.h"
 #include "uarray2.h"
 
-/* 6 modules that handles compression and decompression incrementally */
+/* modules that read, convert and write the image around the middle 
+   stages, and the colors of the block format and of thumbnails */
 #include "ppm_RGBfloats.h"
 #include "RGBfloats_CV.h"
-#include "CV_DCTfloats.h"
 #include "DCTfloats_DCTints.h"
-#include "DCTints_codewords.h"
 #include "Codewords_File.h"
+#include "Codewords_rANS.h"
+
+/* runs the middle stages, on this thread or on a pool of threads */
+#include "Row_bands.h"
+
+/* overlaps reading and writing with the stages for 40image --pipeline */
+#include "Pipeline.h"
+
+/* larger transform blocks for 40image -c --block */
+#include "Block_DCT.h"
+
+/* sequences of frames for 40image -c --sequence */
+#include "Sequence.h"
+
+/* endless runs of frames from a pipe for 40image -c --stream */
+#include "Frame_stream.h"
+
+/* zoom levels for 40image -c --pyramid */
+#include "Pyramid.h"
+
+/* integer decoder for 40image -d --fixed */
+#include "Fixed_decode.h"
+
+/* reports the time of each stage for 40image -T */
+#include "Stage_timer.h"
+
+/* quality of a round trip for 40image --measure */
+#include "Measure.h"
+
+/* file backed storage for the largest arrays */
+#include "Map_store.h"
+
+/* number of worker threads; 1 runs every stage on the calling thread */
+static unsigned threads = 1;
+
+/* stream the stage timings are written to, or NULL when not timing */
+static FILE *timing = NULL;
+
+/* 
+ * a rectangle of an image, in pixels
+ * col, row:      the top left corner
+ * width, height: the size; a width of 0 means the whole image
+ */
+struct Region {
+        int col, row;
+        int width, height;
+};
+
+/* region decoded by decompress40 */
+static struct Region crop = { 0, 0, 0, 0 };
+
+/* whether decompress40 writes a half size thumbnail */
+static bool thumbnail = false;
+
+/* whether compress40 entropy codes the codewords */
+static bool entropy = false;
+
+/* whether decompress40 uses the fixed point decoder */
+static bool fixed = false;
+
+/* whether compress40 reads, compresses and writes bands concurrently */
+static bool pipeline = false;
+
+/* width of the blocks compress40 writes; 2 is the codeword format */
+static int block_size = 2;
+
+/* whether compress40 reads a sequence of frames */
+static bool sequence = false;
+
+/* whether compress40 writes one record per frame until the end of input,
+   and the stream its statistics go to */
+static bool stream = false;
+static FILE *stream_report = NULL;
+
+/* number of levels compress40 writes; 1 is a single image */
+static int pyramid_levels = 1;
+
+/* level of a pyramid decompress40 decodes */
+static int pyramid_level = 0;
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static void      compress_image(Planar_T rgb_floats, FILE *output, 
+                                Stage_timer_T timer, size_t bytes);
+static UArray2_T read_region(FILE *input, int format, unsigned width,
+                             unsigned height, struct Region *region);
+static void      clip_region(struct Region *region, unsigned width,
+                             unsigned height);
+
+/* FUNCTION:  compress40_set_threads
+ * Purpose:   Sets the number of worker threads used by compress40 and
+ *            decompress40
+ * Arg:       nthreads: the number of worker threads
+ * Returns:   N/A
+ * Effect:    Output is identical whatever the number of threads
+ * Error:     Runtime error if nthreads is 0
+ */
+extern void compress40_set_threads(unsigned nthreads)
+{
+        assert(nthreads > 0);
+        threads = nthreads;
+        ppm_RGBfloats_set_threads(nthreads);
+}
+
+/* FUNCTION:  compress40_set_timing
+ * Purpose:   Turns the per-stage timing report of compress40 and
+ *            decompress40 on or off
+ * Arg:       report: the stream the report is written to, or NULL to turn
+ *                    timing off
+ * Returns:   N/A
+ * Effect:    See Stage_timer.h for the format of the report
+ * Error:     N/A
+ */
+extern void compress40_set_timing(FILE *report)
+{
+        timing = report;
+}
+
+/* FUNCTION:  compress40_set_crop
+ * Purpose:   Makes decompress40 decode only a rectangle of the image
+ * Arg:       col, row: the top left corner of the rectangle, in pixels
+ *            width, height: the size of the rectangle, in pixels
+ * Returns:   N/A
+ * Effect:    Only the codewords of the 2 by 2 blocks that cover the
+ *            rectangle are read and decoded; a rectangle that runs past the
+ *            right or bottom edge of the image is cut at the edge
+ * Error:     Runtime error if col or row is negative or width or height is
+ *            not positive
+ */
+extern void compress40_set_crop(int col, int row, int width, int height)
+{
+        assert(col >= 0 && row >= 0);
+        assert(width > 0 && height > 0);
+
+        crop.col = col;
+        crop.row = row;
+        crop.width = width;
+        crop.height = height;
+}
+
+/* FUNCTION:  compress40_set_thumbnail
+ * Purpose:   Makes decompress40 write a half size thumbnail instead of the
+ *            full image
+ * Arg:       on: whether to write thumbnails
+ * Returns:   N/A
+ * Effect:    The thumbnail has one pixel per 2 by 2 block, made from the
+ *            average luma and chroma of the block alone
+ * Error:     N/A
+ */
+extern void compress40_set_thumbnail(bool on)
+{
+        thumbnail = on;
+}
+
+/* FUNCTION:  compress40_set_entropy
+ * Purpose:   Makes compress40 write entropy coded codewords
+ * Arg:       on: whether to entropy code
+ * Returns:   N/A
+ * Effect:    See Codewords_rANS.h for the format; decompress40 recognizes
+ *            it from the header
+ * Error:     N/A
+ */
+extern void compress40_set_entropy(bool on)
+{
+        entropy = on;
+}
+
+/* FUNCTION:  compress40_set_fixed
+ * Purpose:   Makes decompress40 use the all integer decoder
+ * Arg:       on: whether to use it
+ * Returns:   N/A
+ * Effect:    Samples may differ from the float decoder's by 1; see
+ *            Fixed_decode.h. The fixed point decoder runs on the calling
+ *            thread, does not make thumbnails and reads only images of
+ *            codewords, so not sequences or images with larger blocks
+ * Error:     N/A
+ */
+extern void compress40_set_fixed(bool on)
+{
+        fixed = on;
+}
+
+/* FUNCTION:  compress40_set_pipeline
+ * Purpose:   Makes compress40 read, compress and write at the same time
+ * Arg:       on: whether to use the pipeline
+ * Returns:   N/A
+ * Effect:    See Pipeline.h; the output does not change, and -T reports
+ *            the pipeline as one stage
+ * Error:     N/A
+ */
+extern void compress40_set_pipeline(bool on)
+{
+        pipeline = on;
+}
+
+/* FUNCTION:  compress40_set_block
+ * Purpose:   Sets the width of the blocks compress40 transforms
+ * Arg:       width: 2 for the codeword formats, 4 or 8 for the block
+ *                   format
+ * Returns:   N/A
+ * Effect:    See Block_DCT.h; the block format runs on the calling thread
+ *            and is not entropy coded or pipelined
+ * Error:     Runtime error if width is not 2, 4 or 8
+ */
+extern void compress40_set_block(int width)
+{
+        assert(width == 2 || width == 4 || width == 8);
+        block_size = width;
+}
+
+/* FUNCTION:  compress40_set_sequence
+ * Purpose:   Sets whether compress40 reads a sequence of frames
+ * Arg:       on: true to write the sequence format
+ * Returns:   N/A
+ * Effect:    See Sequence.h; each frame is compressed as by the codeword
+ *            format, on the worker threads, and is not entropy coded or
+ *            pipelined
+ * Error:     N/A
+ */
+extern void compress40_set_sequence(bool on)
+{
+        sequence = on;
+}
+
+/* FUNCTION:  compress40_set_stream
+ * Purpose:   Sets whether compress40 compresses frames until the end of
+ *            its input
+ * Arg:       on: true to write one record per frame
+ *            report: the stream the frames per second and stalls are
+ *                    written to, or NULL for none
+ * Returns:   N/A
+ * Effect:    See Frame_stream.h; each record is an image of the codeword
+ *            format, compressed on the worker threads, and is not entropy
+ *            coded or pipelined. decompress40 then reads one record per
+ *            call and accepts only that format
+ * Error:     N/A
+ */
+extern void compress40_set_stream(bool on, FILE *report)
+{
+        stream = on;
+        stream_report = report;
+}
+
+/* FUNCTION:  compress40_set_pyramid
+ * Purpose:   Sets the number of zoom levels compress40 writes
+ * Arg:       levels: 1 for a single image, up to PYRAMID_MAX_LEVELS for the
+ *                    pyramid format
+ * Returns:   N/A
+ * Effect:    See Pyramid.h; the pyramid runs on the calling thread and is
+ *            not entropy coded or pipelined
+ * Error:     Runtime error if levels is out of range
+ */
+extern void compress40_set_pyramid(int levels)
+{
+        assert(levels >= 1 && levels <= PYRAMID_MAX_LEVELS);
+        pyramid_levels = levels;
+}
+
+/* FUNCTION:  compress40_set_level
+ * Purpose:   Sets the level of a pyramid decompress40 decodes
+ * Arg:       level: 0 for the full size image, 1 for half size and so on
+ * Returns:   N/A
+ * Effect:    Images in the other formats only have level 0
+ * Error:     Runtime error if level is negative
+ */
+extern void compress40_set_level(int level)
+{
+        assert(level >= 0);
+        pyramid_level = level;
+}
+
+/* FUNCTION:  compress40_set_map_threshold
+ * Purpose:   Sets the size above which arrays are mapped from a file
+ * Arg:       bytes: the threshold, or 0 for the default
+ * Returns:   N/A
+ * Effect:    See Map_store.h; applies to compress40 and decompress40
+ * Error:     N/A
+ */
+extern void compress40_set_map_threshold(size_t bytes)
+{
+        Map_store_set_threshold(bytes);
+}
 
 /* FUNCTION:  compress40
  * Purpose:   Compress a ppm file
  * Arg:       file: pointer to a file
  * Returns:   N/A
- * Effect:    Calls compression functions from different modules
+ * Effect:    Writes the compressed image to stdout
  * Error:     Runtime error if a NULL pointer is passed in
  */
 extern void compress40(FILE *input)
+{
+        compress40_file(input, stdout);
+}
+
+/* FUNCTION:  compress40_file
+ * Purpose:   Compress a ppm file to another file
+ * Arg:       input: pointer to a file holding a PPM
+ *            output: pointer to a file open for writing
+ * Returns:   N/A
+ * Effect:    Calls compression functions from different modules
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+extern void compress40_file(FILE *input, FILE *output)
 {
         assert(input != NULL);
+        assert(output != NULL);
         
-        UArray2_T rgb_floats = ppm_RGBfloats_compress(input);
-        UArray2_T cv_colors = RGBfloats_CV_compress(rgb_floats);
-        UArray2_T dct_floats = CV_DCTfloats_compress(cv_colors);
-        UArray2_T dct_ints = DCTfloats_ints_compress(dct_floats);
-        UArray2_T codewords = DCTints_codewords_compress(dct_ints);
-        Codewords_File_print(codewords);
+        Stage_timer_T timer = Stage_timer_new(timing, "compress");
+
+        if (sequence) {
+                size_t bytes = Sequence_compress(input, output, threads);
+                Stage_timer_lap(timer, "sequence", bytes);
+                Stage_timer_free(&timer, bytes);
+                return;
+        }
+
+        if (stream) {
+                size_t bytes = Frame_stream_compress(input, output, threads,
+                                                     stream_report);
+                Stage_timer_lap(timer, "stream", bytes);
+                Stage_timer_free(&timer, bytes);
+                return;
+        }
+
+        if (pipeline && block_size == 2) {
+                size_t bytes = Pipeline_compress(input, output, threads, 
+                                                 entropy);
+                Stage_timer_lap(timer, "pipeline", bytes);
+                Stage_timer_free(&timer, bytes);
+                return;
+        }
+
+        Planar_T rgb_floats = ppm_RGBfloats_compress_planar(input);
+
+        /* every stage is measured against the size of the 8 bit pixels */
+        size_t bytes = (size_t)Planar_width(rgb_floats) * 
+                       Planar_height(rgb_floats) * 3;
+        Stage_timer_lap(timer, "read", bytes);
+
+        if (pyramid_levels > 1) {
+                Pyramid_write(rgb_floats, pyramid_levels, output);
+                Stage_timer_lap(timer, "pyramid", bytes);
+                Stage_timer_free(&timer, bytes);
+                return;
+        }
+
+        compress_image(rgb_floats, output, timer, bytes);
+        Stage_timer_free(&timer, bytes);
+}
+
+/* FUNCTION:  compress40_measure
+ * Purpose:   Compresses and decompresses a ppm file in memory and reports
+ *            the quality and size of the result
+ * Arg:       input: pointer to a file holding a PPM
+ *            report: pointer to a file open for writing
+ * Returns:   N/A
+ * Effect:    The image is compressed with the current settings into a
+ *            buffer, read back from it as decompress40 would read a file,
+ *            and compared with the original by Measure; nothing but the
+ *            report is written
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+extern void compress40_measure(FILE *input, FILE *report)
+{
+        assert(input != NULL);
+        assert(report != NULL);
+
+        Stage_timer_T timer = Stage_timer_new(timing, "measure");
+
+        Planar_T rgb_floats = ppm_RGBfloats_compress_planar(input);
+        int width = Planar_width(rgb_floats);
+        int height = Planar_height(rgb_floats);
+        size_t bytes = (size_t)width * height * 3;
+        Planar_T original = Planar_crop(rgb_floats, 0, 0, width, height);
+        Stage_timer_lap(timer, "read", bytes);
+
+        char *compressed = NULL;
+        size_t length = 0;
+        FILE *output = open_memstream(&compressed, &length);
+        assert(output != NULL);
+        compress_image(rgb_floats, output, timer, bytes);
+        fclose(output);
+
+        FILE *stream = fmemopen(compressed, length, "r");
+        assert(stream != NULL);
+        unsigned decoded_width, decoded_height;
+        int format = Codewords_File_read_header(stream, &decoded_width, 
+                                                &decoded_height);
+        Planar_T decoded;
+        if (format == BLOCK_DCT_FORMAT) {
+                Planar_T cv_colors = Block_DCT_read(stream, decoded_width,
+                                                    decoded_height);
+                Stage_timer_lap(timer, "blocks", bytes);
+                decoded = RGBfloats_CV_decompress_planar(cv_colors);
+                Stage_timer_lap(timer, "cv_to_rgb", bytes);
+        } else {
+                UArray2_T codewords = Codewords_File_read_codewords(
+                        stream, format, decoded_width, decoded_height);
+                Stage_timer_lap(timer, "read", bytes);
+                decoded = Row_bands_decompress(codewords, threads, timer);
+        }
+        fclose(stream);
+        free(compressed);
+
+        double sum_squares[3];
+        Measure_errors(original, decoded, threads, sum_squares);
+        Stage_timer_lap(timer, "measure", bytes);
+        Measure_report(report, sum_squares, (size_t)width * height, length);
+
+        Planar_free(&decoded);
+        Planar_free(&original);
+        Stage_timer_free(&timer, bytes);
 }
 
 /* FUNCTION:  decompress40
  * Purpose:   Decompress a compressed binary image file
  * Arg:       file: pointer to a file
  * Returns:   N/A
- * Effect:    Calls decompression functions from different modules
- * Error:     Runtime error if a NULL pointer is passed in
+ * Effect:    Calls decompression functions from different modules; only
+ *            the region set by compress40_set_crop is decoded, if any, and
+ *            a thumbnail is written if compress40_set_thumbnail was called.
+ *            After compress40_set_fixed the codewords go straight to the
+ *            integer decoder
+ * Error:     Runtime error if a NULL pointer is passed in, if the crop
+ *            region starts outside the image, if compress40_set_fixed
+ *            was called and the image is a sequence or has larger blocks,
+ *            which the integer decoder cannot read, or if 
+ *            compress40_set_stream was called and the image is not a 
+ *            record of a stream
  */
 extern void decompress40(FILE *input) 
 {
         assert(input != NULL);
 
-        UArray2_T codewords = Codewords_File_read(input);
-        UArray2_T dct_ints = DCTints_codewords_decompress(codewords);
-        UArray2_T dct_floats = DCTfloats_ints_decompress(dct_ints);
-        UArray2_T cv_colors = CV_DCTfloats_decompress(dct_floats);
-        UArray2_T rgb_floats = RGBfloats_CV_decompress(cv_colors);
-        ppm_RGBfloats_decompress(rgb_floats);
+        Stage_timer_T timer = Stage_timer_new(timing, "decompress");
+
+        struct Region region = crop;
+        unsigned width, height;
+        int format = Codewords_File_read_header(input, &width, &height);
+        Planar_T rgb_floats;
+
+        /* the records of a stream are all of format 2; anything else
+           would be left half read for the next record */
+        assert(!stream || format == 2);
+
+        /* a level of a pyramid is an image of its own */
+        if (format == PYRAMID_FORMAT) {
+                Pyramid_seek(input, pyramid_level);
+                format = Codewords_File_read_header(input, &width, &height);
+                assert(format == 2);
+        } else {
+                assert(pyramid_level == 0);
+        }
+
+        if (format == SEQUENCE_FORMAT) {
+                /* every frame is decoded whole */
+                assert(!thumbnail && !fixed && region.width == 0);
+                size_t bytes = Sequence_decompress(input, width, height,
+                                                   stdout, threads);
+                Stage_timer_lap(timer, "sequence", bytes);
+                Stage_timer_free(&timer, bytes);
+                return;
+        }
+
+        if (format == BLOCK_DCT_FORMAT) {
+                /* the blocks are decoded whole, then cut to the region */
+                assert(!thumbnail && !fixed);
+                size_t pixels = (size_t)width * height * 3;
+                Planar_T cv_colors = Block_DCT_read(input, width, height);
+                Stage_timer_lap(timer, "blocks", pixels);
+                rgb_floats = RGBfloats_CV_decompress_planar(cv_colors);
+                Stage_timer_lap(timer, "cv_to_rgb", pixels);
+                if (region.width > 0) {
+                        clip_region(&region, width, height);
+                        Planar_T cropped = Planar_crop(rgb_floats, 
+                                                       region.col, 
+                                                       region.row,
+                                                       region.width,
+                                                       region.height);
+                        Planar_free(&rgb_floats);
+                        rgb_floats = cropped;
+                }
+                ppm_RGBfloats_decompress_planar(rgb_floats);
+                Stage_timer_lap(timer, "write", pixels);
+                Stage_timer_free(&timer, pixels);
+                return;
+        }
+
+        UArray2_T codewords;
+        if (region.width > 0) {
+                codewords = read_region(input, format, width, height, 
+                                        &region);
+        } else {
+                codewords = Codewords_File_read_codewords(input, format, 
+                                                          width, height);
+        }
+
+        /* every stage is measured against the size of the 8 bit pixels */
+        size_t bytes = (size_t)UArray2_width(codewords) * 2 * 
+                       UArray2_height(codewords) * 2 * 3;
+        Stage_timer_lap(timer, "read", bytes);
+
+        if (fixed && !thumbnail) {
+                int width = UArray2_width(codewords) * 2;
+                int height = UArray2_height(codewords) * 2;
+                if (region.width > 0) {
+                        Fixed_decode_write(codewords, region.col, region.row,
+                                           region.width, region.height, 
+                                           stdout);
+                } else {
+                        Fixed_decode_write(codewords, 0, 0, width, height,
+                                           stdout);
+                }
+                Stage_timer_lap(timer, "fixed_decode", bytes);
+                Stage_timer_free(&timer, bytes);
+                return;
+        }
+
+        if (thumbnail) {
+                /* one pixel per block; too little work to share out */
+                Planar_T cv_colors = DCTfloats_ints_thumbnail(codewords);
+                Stage_timer_lap(timer, "thumbnail", bytes);
+                rgb_floats = RGBfloats_CV_decompress_planar(cv_colors);
+                Stage_timer_lap(timer, "cv_to_rgb", bytes);
+        } else {
+                rgb_floats = Row_bands_decompress(codewords, threads, timer);
+        }
+
+        /* the decoded blocks can reach one pixel past the region */
+        if (region.width > 0) {
+                Planar_T pixels = Planar_crop(rgb_floats, region.col, 
+                                              region.row, region.width,
+                                              region.height);
+                Planar_free(&rgb_floats);
+                rgb_floats = pixels;
+        }
+
+        ppm_RGBfloats_decompress_planar(rgb_floats);
+        Stage_timer_lap(timer, "write", bytes);
+        Stage_timer_free(&timer, bytes);
+}
+
+/* FUNCTION:  compress_image
+ * Purpose:   Runs the compression stages over an image and writes it
+ * Arg:       rgb_floats: a planar image of RGB floats
+ *            output: pointer to a file open for writing
+ *            timer: the timer of the caller
+ *            bytes: the size of the 8 bit pixels, for the timer
+ * Returns:   N/A
+ * Effect:    Writes the block format, or codewords entropy coded or not,
+ *            as set; recycles rgb_floats
+ * Error:     N/A
+ */
+static void compress_image(Planar_T rgb_floats, FILE *output, 
+                           Stage_timer_T timer, size_t bytes)
+{
+        if (block_size > 2) {
+                Planar_T cv_colors = RGBfloats_CV_compress_planar(rgb_floats);
+                Stage_timer_lap(timer, "rgb_to_cv", bytes);
+                Block_DCT_write(cv_colors, block_size, output);
+                Stage_timer_lap(timer, "blocks", bytes);
+                return;
+        }
+
+        UArray2_T codewords = Row_bands_compress(rgb_floats, threads, timer);
+
+        if (entropy) {
+                Codewords_rANS_write(codewords, output);
+        } else {
+                Codewords_File_write(codewords, output);
+        }
+        Stage_timer_lap(timer, "write", bytes);
+}
+
+/* FUNCTION:  read_region
+ * Purpose:   Reads the codewords of the blocks that cover a region
+ * Arg:       input: pointer to a compressed image, just after the header
+ *            format: the format number from the header
+ *            width, height: the dimensions of the image from the header
+ *            region: the region to decode, in pixels
+ * Returns:   Pointer to an UArray2 of the codewords of the covering blocks
+ * Effect:    Cuts *region at the edges of the image, then makes it relative
+ *            to the top left pixel of the covering blocks. Entropy coded
+ *            images cannot be read in part, so all of their blocks are
+ *            returned and *region stays relative to the whole image
+ * Error:     Runtime error if the region starts outside the image
+ */
+static UArray2_T read_region(FILE *input, int format, unsigned width,
+                             unsigned height, struct Region *region)
+{
+        clip_region(region, width, height);
+        if (format == CODEWORDS_RANS_FORMAT) {
+                return Codewords_rANS_read(input, width, height);
+        }
+
+        /* the 2 by 2 blocks from the one holding the top left pixel to the
+           one holding the bottom right pixel */
+        int first_col = region->col / 2;
+        int first_row = region->row / 2;
+        int last_col = (region->col + region->width - 1) / 2;
+        int last_row = (region->row + region->height - 1) / 2;
+
+        region->col -= first_col * 2;
+        region->row -= first_row * 2;
+
+        return Codewords_File_read_blocks(input, width, height, first_col,
+                                          first_row, last_col - first_col + 1,
+                                          last_row - first_row + 1);
+}
+
+/* FUNCTION:  clip_region
+ * Purpose:   Cuts a region at the edges of an image
+ * Arg:       region: the region, in pixels
+ *            width, height: the dimensions of the image
+ * Returns:   N/A
+ * Effect:    Shrinks the width and height of *region to fit
+ * Error:     Runtime error if the region starts outside the image
+ */
+static void clip_region(struct Region *region, unsigned width,
+                        unsigned height)
+{
+        int image_width = width;
+        int image_height = height;
+        assert(region->col < image_width && region->row < image_height);
+        if (region->width > image_width - region->col) {
+                region->width = image_width - region->col;
+        }
+        if (region->height > image_height - region->row) {
+                region->height = image_height - region->row;
+        }
 }
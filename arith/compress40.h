@@ -1,4 +1,73 @@
 #include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
 
 extern void compress40  (FILE *input);  /* reads PPM, writes compressed image */
 extern void decompress40(FILE *input);  /* reads compressed image, writes PPM */
+
+/* compress40 writing to output instead of stdout; safe to call from several
+   threads at once while no setting below is being changed */
+extern void compress40_file(FILE *input, FILE *output);
+
+/* compresses the PPM in input with the settings below and decompresses it,
+   all in memory, then writes the RMSE and PSNR of each channel and the
+   compression ratio to report (see Measure.h) */
+extern void compress40_measure(FILE *input, FILE *report);
+
+/* number of worker threads used by compress40 and decompress40 (default 1) */
+extern void compress40_set_threads(unsigned nthreads);
+
+/* writes the time, throughput and peak memory of every stage of compress40
+   and decompress40 to report, one tab separated line per stage; NULL (the
+   default) turns the report off */
+extern void compress40_set_timing(FILE *report);
+
+/* makes decompress40 decode only the width by height rectangle of pixels
+   whose top left corner is at (col, row), reading only the codewords that
+   cover it */
+extern void compress40_set_crop(int col, int row, int width, int height);
+
+/* makes decompress40 write a width/2 by height/2 thumbnail, one pixel per
+   2 by 2 block, built from the a, avgPb and avgPr fields alone */
+extern void compress40_set_thumbnail(bool on);
+
+/* makes compress40 entropy code the codewords (format 3); decompress40
+   reads either format */
+extern void compress40_set_entropy(bool on);
+
+/* makes decompress40 use the all integer decoder of Fixed_decode, whose
+   samples are within 1 of the float decoder's; it reads images of
+   codewords only, not sequences or images with larger blocks */
+extern void compress40_set_fixed(bool on);
+
+/* makes compress40 parse, compress and write bands of rows on three
+   threads at once, so that slow input or output overlaps the stages */
+extern void compress40_set_pipeline(bool on);
+
+/* makes compress40 write the block format (see Block_DCT.h) with 4 by 4
+   or 8 by 8 luma blocks; 2 (the default) keeps the codeword formats */
+extern void compress40_set_block(int width);
+
+/* makes compress40 read PPMs one after another and write the sequence
+   format (see Sequence.h); decompress40 writes the frames the same way */
+extern void compress40_set_sequence(bool on);
+
+/* makes compress40 read PPMs until the end of its input, as from a pipe,
+   and write each as a record of its own (see Frame_stream.h), with the
+   frames per second and backpressure stalls written to report if it is
+   not NULL; decompress40 then accepts only records of format 2 */
+extern void compress40_set_stream(bool on, FILE *report);
+
+/* makes compress40 write levels zoom levels, each half the size of the one
+   before, in one file with an index (see Pyramid.h); 1 (the default) writes
+   a single image */
+extern void compress40_set_pyramid(int levels);
+
+/* makes decompress40 decode level level of a pyramid, 0 (the default) being
+   the full size image */
+extern void compress40_set_level(int level);
+
+/* maps every array of at least bytes bytes from a temporary file rather
+   than the heap (see Map_store.h); 0 (the default) uses an eighth of the
+   physical memory */
+extern void compress40_set_map_threshold(size_t bytes);
@@ -0,0 +1,98 @@
+#!/bin/sh
+#
+# fixed_check.sh
+# Project:    Arith
+#
+# Error bound check run by make check. For every kind of synthetic image
+# (gradient, noise, photo) at a few sizes, generates a PPM with ppmgen,
+# compresses it with 40image, and decodes it both with the float decoder
+# and with the integer decoder of --fixed, whole and cropped. Every sample
+# of the two decodes must be within 1 of each other, as Fixed_decode
+# promises. Prints one tab separated line per decode:
+#
+#   image  width  height  bytes  differ  max_diff
+#
+# where bytes is the size of the decoded PPM and differ is the number of
+# samples that are not equal. Exits with status 1 if the two PPMs differ
+# in size or if any max_diff is above 1. Dimensions include odd ones, so
+# that trim_dimension is exercised.
+#
+# Environment:
+#   CHECK_DIR      where the images are written (default /tmp/40image-check)
+
+set -e
+
+cd "$(dirname "$0")"
+CHECK_DIR=${CHECK_DIR:-/tmp/40image-check}
+mkdir -p "$CHECK_DIR"
+
+# the region decoded by the cropped runs: x,y,w,h
+CROP=5,3,17,11
+
+printf 'image\twidth\theight\tbytes\tdiffer\tmax_diff\n'
+
+failed=0
+for dims in "37 23" "640 480" "1001 751"; do
+        width=${dims% *}
+        height=${dims#* }
+
+        for kind in gradient noise photo; do
+                name="$kind-${width}x$height"
+                ppm="$CHECK_DIR/$name.ppm"
+                cmp="$CHECK_DIR/$name.cmp"
+
+                ./ppmgen "$kind" "$width" "$height" > "$ppm"
+                ./40image-6 -c "$ppm" > "$cmp"
+
+                for crop in "" "--crop $CROP"; do
+                        ./40image-6 -d $crop "$cmp" > "$CHECK_DIR/float.ppm"
+                        ./40image-6 -d --fixed $crop "$cmp" \
+                                > "$CHECK_DIR/fixed.ppm"
+
+                        # cmp -l lists the differing bytes in octal; the
+                        # headers are equal, so every byte it lists is a
+                        # sample
+                        bytes=$(($(wc -c < "$CHECK_DIR/float.ppm")))
+                        fixed=$(($(wc -c < "$CHECK_DIR/fixed.ppm")))
+                        if [ $bytes -ne $fixed ]; then
+                                failed=1
+                        fi
+                        line=$(cmp -l "$CHECK_DIR/float.ppm" \
+                                      "$CHECK_DIR/fixed.ppm" 2> /dev/null |
+                               awk -v n="$bytes" '
+                               function octal(s,   i, v) {
+                                       v = 0
+                                       for (i = 1; i <= length(s); i++)
+                                               v = v * 8 + substr(s, i, 1)
+                                       return v
+                               }
+                               {
+                                       d = octal($2) - octal($3)
+                                       if (d < 0) d = -d
+                                       if (d > max) max = d
+                                       differ++
+                               }
+                               END { printf "%d\t%d\t%d", n, differ, max }')
+
+                        label=$name
+                        if [ -n "$crop" ]; then
+                                label="$name-crop"
+                        fi
+                        printf '%s\t%s\t%s\t%s\n' "$label" "$width" \
+                                "$height" "$line"
+                        if [ "${line##*	}" -gt 1 ]; then
+                                failed=1
+                        fi
+                done
+
+                rm -f "$ppm" "$cmp"
+        done
+done
+
+rm -f "$CHECK_DIR/float.ppm" "$CHECK_DIR/fixed.ppm"
+
+if [ $failed -ne 0 ]; then
+        echo "fixed_check.sh: --fixed is more than 1 away from the float" \
+             "decoder" >&2
+        exit 1
+fi
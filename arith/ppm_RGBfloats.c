@@ -9,16 +9,15 @@
  *     Summary:
  *     This is the private implementation of our ppm_RGBfloats module. 
  *     The purpose of this module is to convert between a PPM file and a 
- *     UArray2 of RGB float values. This module contains two public functions,
- *     one that reads in a PPM file and returns a UArray2 of RGB float values,
- *     and one that takes in a UArray2 of RGB float values and writes a PPM 
- *     file to stdout. Both these functions rely on mapping private apply 
- *     functions over the respective UArray2s to convert between the different
- *     values. This module also relies on the Pnm_ppm module to read and write
- *     the PPM files. In compression data is potentially lost in the process of
- *     trimming down the width and the height to an even number from the
- *     original file. The denominator from the original file is lost from the
- *     conversion between RGB values and their scaled floats representation.
+ *     planar image of RGB float values. This module reads a PPM file (whole,
+ *     through a memory mapping when it can, or a few rows at a time from a
+ *     stream) into planes of RGB floats, and writes planes of RGB floats
+ *     back as a PPM or as pixels in memory. This module also relies on the
+ *     Pnm_ppm module to read PPMs from pipes and to write them. In 
+ *     compression data is potentially lost in the process of trimming down
+ *     the width and the height to an even number from the original file. 
+ *     The denominator from the original file is lost from the conversion 
+ *     between RGB values and their scaled floats representation.
  *     Additionally, the exact RGB ratios are lost due to imprecise nature of
  *     floating point math.
  * 
@@ -26,212 +25,649 @@
  ****************************************************************************/
 #include <assert.h>
 #include <stdlib.h>
+#include <stdbool.h>
+#include <ctype.h>
 #include "ppm_RGBfloats.h"
 #include "a2plain.h"
 #include "a2methods.h"
 #include "pnm.h"
-
-/* this is the struct definition for the RGB_floats struct */
-#include "RGB_floats.h"
+#include "PPM_map.h"
+#include "P3_map.h"
+#include "uarray2.h"
 
 /*
  * private helper functions, functions details are included in the function
  * contracts respectively
  */
-static void     to_floats_apply(int col, int row, UArray2_T RGBVals, void *val,
-                                void *denom_ua2);
-static void     to_RGBvals_apply(int col, int row, UArray2_T RGBfloats, 
-                                 void *val, void *denom_ua2);
 static float    RGBval_to_float(unsigned val, unsigned denom);
 static unsigned float_to_RGBval(float scaledFloat, unsigned denom);
 static unsigned trim_dimension(unsigned dimension);
 static Pnm_ppm  pnm_ppm_new(unsigned width, unsigned height, unsigned denom, 
                             A2Methods_T methods, UArray2_T array2);
-static struct   Denom_uarray2 new_denom_uarray2(UArray2_T array2, 
-                                                unsigned denom);
+static Planar_T mapped_to_planar(PPM_map_T map);
+static unsigned largest_sample(const unsigned char *samples, size_t count,
+                               bool two_bytes);
+static Planar_T plain_to_planar(PPM_map_T map);
+static unsigned read_header_number(FILE *file);
+static void     read_stream_header(ppm_RGBfloats_stream_T stream);
+
+/* chosen denominator for decompression */
+#define DENOMINATOR 255
+
+/* threads that parse a mapped plain PPM */
+static unsigned parse_threads = 1;
 
 /* 
- * arrray2: a pointer to an instance of UArray2; the instance stores the 
- *          compressed or decompressed pixels
- * denominator: the denominator of a pnm_ppm
+ * file:         the PPM being read
+ * plain:        whether it is a plain (P3) PPM
+ * raw_width:    width of the rows in the file
+ * raw_height:   number of rows in the file
+ * width:        width of the rows, trimmed to an even number
+ * height:       number of rows, trimmed to an even number
+ * denom:        the maxval of the PPM
+ * sample_bytes: bytes per sample of a binary PPM (1 or 2)
+ * next_row:     number of rows read so far
+ * row:          one row of raw samples, for a binary PPM
+ * row_capacity: bytes allocated for row
  */
-struct Denom_uarray2 {
-        UArray2_T array2;
-        unsigned denominator;
+struct ppm_RGBfloats_stream {
+        FILE *file;
+        bool plain;
+        unsigned raw_width, raw_height, width, height;
+        unsigned denom;
+        unsigned sample_bytes;
+        unsigned next_row;
+        unsigned char *row;
+        size_t row_capacity;
 };
 
-/* chosen denominator for decompression */
-#define DENOMINATOR 255
+/* FUNCTION:  ppm_RGBfloats_set_threads
+ * Purpose:   Sets the number of threads that parse a plain PPM in
+ *            ppm_RGBfloats_compress_planar
+ * Arg:       nthreads: the number of threads
+ * Returns:   N/A
+ * Effect:    The floats are the same whatever the number of threads
+ * Error:     Runtime error if nthreads is 0
+ */
+void ppm_RGBfloats_set_threads(unsigned nthreads)
+{
+        assert(nthreads > 0);
+        parse_threads = nthreads;
+}
 
-/* FUNCTION:  ppm_RGBfloats_compress
- * Purpose:   Converts a given ppm file to an uarray2 of RGB float values
+/* FUNCTION:  ppm_RGBfloats_compress_planar
+ * Purpose:   Reads a PPM file into a planar image of RGB floats
  * Arg:       file: a file pointer that stores the original image pixels
- * Returns:   pointer to an UArray2 instance that stores the compressed pixels
- * Effect:    allocates and recycles a RGB_floats struct
- *            recycles the pnm_ppm instance
- *            note that the file has already been opened
- * Error:     Runtime error if file is empty, if methods is null, or if memory
- *            allocation for the struct fails
+ * Returns:   A planar image with red, green and blue planes, trimmed to even
+ *            dimensions
+ * Effect:    A binary PPM in a regular file is mapped into memory and its
+ *            rows are converted in place; a plain PPM in a regular file is
+ *            mapped and parsed by parse_threads threads; anything else (a
+ *            pipe) is read with Pnm_ppmread and the pnm_ppm is recycled
+ * Error:     Runtime error if file is NULL or is not a PPM
  */
-UArray2_T ppm_RGBfloats_compress(FILE *file)
+Planar_T ppm_RGBfloats_compress_planar(FILE *file)
 {
-        /* ensure file have been opened */
         assert(file != NULL);
-        
-        /* default to UArray2 methods */
+
+        PPM_map_T map = PPM_map_open(file);
+        if (map != NULL) {
+                Planar_T RGB_floats = PPM_map_plain(map) ?
+                                      plain_to_planar(map) :
+                                      mapped_to_planar(map);
+                PPM_map_free(&map);
+                return RGB_floats;
+        }
+
         A2Methods_T methods = uarray2_methods_plain; 
         assert(methods != NULL);
         
         Pnm_ppm pixmap = Pnm_ppmread(file, methods);
 
-        /* initialize a new array2 to store the RGBfloats */
-        unsigned new_width = trim_dimension(pixmap->width);
-        unsigned new_height = trim_dimension(pixmap->height);
-        unsigned new_size = sizeof(struct RGB_floats);
-        UArray2_T RGB_floats = UArray2_new(new_width, new_height, new_size);
-                                                    
-        /* initialize a struct that stores the new array and the denominator 
-           to pass into our apply function */
-        struct Denom_uarray2 *dm_ua2 = malloc(sizeof(*dm_ua2));
-        assert(dm_ua2 != NULL);
-        *dm_ua2 = new_denom_uarray2(RGB_floats, pixmap->denominator);
-                
-        UArray2_map_row_major(pixmap->pixels, to_floats_apply, dm_ua2);
-
-        free(dm_ua2);
+        int width = trim_dimension(pixmap->width);
+        int height = trim_dimension(pixmap->height);
+        unsigned denom = pixmap->denominator;
+        Planar_T RGB_floats = Planar_new(width, height, 3);
+
+        int row, col;
+        for (row = 0; width > 0 && row < height; row++) {
+                Pnm_rgb pixels = UArray2_row(pixmap->pixels, row);
+                float *red = Planar_row(RGB_floats, PLANAR_RED, row);
+                float *green = Planar_row(RGB_floats, PLANAR_GREEN, row);
+                float *blue = Planar_row(RGB_floats, PLANAR_BLUE, row);
+
+                for (col = 0; col < width; col++) {
+                        red[col] = RGBval_to_float(pixels[col].red, denom);
+                        green[col] = RGBval_to_float(pixels[col].green, 
+                                                     denom);
+                        blue[col] = RGBval_to_float(pixels[col].blue, denom);
+                }
+        }
+
         Pnm_ppmfree(&pixmap);
-        
+
         return RGB_floats;
 }
 
+/* FUNCTION:  ppm_RGBfloats_decompress_planar
+ * Purpose:   Writes a planar image of RGB floats as a PPM to stdout
+ * Arg:       RGB_floats: a planar image with red, green and blue planes
+ * Returns:   N/A
+ * Effect:    writes a PPM to stdout and recycles the planar image
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+void ppm_RGBfloats_decompress_planar(Planar_T RGB_floats)
+{
+        ppm_RGBfloats_write_planar(RGB_floats, stdout);
+        Planar_free(&RGB_floats);
+}
 
-
-/* FUNCTION:  ppm_RGBfloats_decompress
- * Purpose:   Prints an uarray2 of RGB float values 
- * Arg:       RGB_floats: pointer to an instance of uarray2 that stores the 
- *                        RGB values in floats
+/* FUNCTION:  ppm_RGBfloats_write_planar
+ * Purpose:   Writes a planar image as a PPM to a file
+ * Arg:       RGB_floats: a planar image with red, green and blue planes
+ *            file: pointer to a file open for writing
  * Returns:   N/A
- * Effect:    allocates and recycles a Pnm_rgb struct
- *            recycles the pnm_ppm instance
- *            note that the file has already been opened
+ * Effect:    RGB_floats is not changed, so it can be written again after
+ *            some of its rows change
  * Error:     Runtime error if a NULL pointer is passed in
- *            if methods is null, or if memory allocation for the struct fails
  */
-void ppm_RGBfloats_decompress(UArray2_T RGB_floats)
+void ppm_RGBfloats_write_planar(Planar_T RGB_floats, FILE *file)
 {
-        /* ensure file have been opened */
-        assert(RGB_floats!= NULL);
+        assert(RGB_floats != NULL && file != NULL);
 
-        /* default to UArray2 methods */
         A2Methods_T methods = uarray2_methods_plain; 
         assert(methods != NULL);
 
-        /* initialize a new array2 that stores the RGB values */
-        unsigned width = UArray2_width(RGB_floats); 
-        unsigned height = UArray2_height(RGB_floats);
+        int width = Planar_width(RGB_floats);
+        int height = Planar_height(RGB_floats);
         unsigned size = sizeof(struct Pnm_rgb);
         UArray2_T unsigned_rgb = UArray2_new(width, height, size);
 
-        /* initialize a struct that stores the new array and the denominator 
-           to pass into our apply function; this is done using a private
-           helper function new_denom_uarray2 */
-        struct Denom_uarray2 *dm_ua2 = malloc(sizeof(*dm_ua2));
-        assert(dm_ua2 != NULL);
-        *dm_ua2 = new_denom_uarray2(unsigned_rgb, DENOMINATOR);
-
-        UArray2_map_row_major(RGB_floats, to_RGBvals_apply, dm_ua2);
+        int row, col;
+        for (row = 0; width > 0 && row < height; row++) {
+                Pnm_rgb pixels = UArray2_row(unsigned_rgb, row);
+                float *red = Planar_row(RGB_floats, PLANAR_RED, row);
+                float *green = Planar_row(RGB_floats, PLANAR_GREEN, row);
+                float *blue = Planar_row(RGB_floats, PLANAR_BLUE, row);
+
+                for (col = 0; col < width; col++) {
+                        pixels[col].red = float_to_RGBval(red[col], 
+                                                          DENOMINATOR);
+                        pixels[col].green = float_to_RGBval(green[col], 
+                                                            DENOMINATOR);
+                        pixels[col].blue = float_to_RGBval(blue[col], 
+                                                           DENOMINATOR);
+                }
+        }
 
-        /* initialize a pnm_ppm instance and write to stdout */
         Pnm_ppm pixmap = pnm_ppm_new(width, height, DENOMINATOR, methods, 
                                      unsigned_rgb);
-        Pnm_ppmwrite(stdout, pixmap);
+        Pnm_ppmwrite(file, pixmap);
 
         Pnm_ppmfree(&pixmap);
-        UArray2_free(&RGB_floats);
-        free(dm_ua2);
 }
 
+/* FUNCTION:  ppm_RGBfloats_from_pixels
+ * Purpose:   Converts 8 bit RGB pixels in memory to a planar image
+ * Arg:       pixels: rows of width red, green, blue byte triples
+ *            width, height: the dimensions of the pixels
+ *            stride: the number of bytes from one row to the next
+ * Returns:   A planar image with red, green and blue planes, trimmed to even
+ *            dimensions
+ * Effect:    The floats are those of a PPM with a maxval of DENOMINATOR
+ * Error:     Runtime error if pixels is NULL, if a dimension is negative or
+ *            if stride is less than 3 * width
+ */
+Planar_T ppm_RGBfloats_from_pixels(const unsigned char *pixels, int width,
+                                   int height, size_t stride)
+{
+        assert(pixels != NULL);
+        assert(width >= 0 && height >= 0);
+        assert(stride >= (size_t)width * 3);
+
+        width = trim_dimension(width);
+        height = trim_dimension(height);
+        Planar_T RGB_floats = Planar_new(width, height, 3);
+
+        int row, col;
+        for (row = 0; width > 0 && row < height; row++) {
+                const unsigned char *s = pixels + row * stride;
+                float *red = Planar_row(RGB_floats, PLANAR_RED, row);
+                float *green = Planar_row(RGB_floats, PLANAR_GREEN, row);
+                float *blue = Planar_row(RGB_floats, PLANAR_BLUE, row);
+
+                for (col = 0; col < width; col++, s += 3) {
+                        red[col] = RGBval_to_float(s[0], DENOMINATOR);
+                        green[col] = RGBval_to_float(s[1], DENOMINATOR);
+                        blue[col] = RGBval_to_float(s[2], DENOMINATOR);
+                }
+        }
+
+        return RGB_floats;
+}
 
-/* FUNCTION:  to_floats_apply
- * Purpose:   For each pixel in the array of RGB scaled ints,
- *            convert each scaled RGB int to a RGB float (using a private 
- *            helper function) and add the pixel to the new array of 
- *            RGB floats
- * Arg:       col: a int representing the current column in the array
- *            row: a row representing the current row in the array
- *            RGBVals: pointer to an uarray2 of scaled RGB ints (unused)
- *            val: pointer to the current pixel containing an Pnm_rgb struct
- *            denom_ua2: a Denom_uarray2 struct containing the new array of
- *                       scaled RGB ints and the RGB denominator
+/* FUNCTION:  ppm_RGBfloats_to_pixels
+ * Purpose:   Converts a planar image to 8 bit RGB pixels in memory
+ * Arg:       RGB_floats: a planar image with red, green and blue planes
+ *            pixels: room for its rows of red, green, blue byte triples
+ *            stride: the number of bytes from one row to the next
  * Returns:   N/A
- * Effect:    Populates the new uarray2 of scaled RGB ints
- * Error:     N/A
+ * Effect:    The bytes are the samples ppm_RGBfloats_decompress_planar
+ *            writes; recycles the planar image
+ * Error:     Runtime error if a NULL pointer is passed in or if stride is
+ *            less than 3 times the width
  */
-static void to_floats_apply(int col, int row, UArray2_T RGBVals, void *val, 
-                            void *denom_ua2)
+void ppm_RGBfloats_to_pixels(Planar_T RGB_floats, unsigned char *pixels,
+                             size_t stride)
 {
-        /* typecast and dereference closure and currente element */
-        UArray2_T new_array2 = ((struct Denom_uarray2 *)denom_ua2)->array2;
-        unsigned denom = ((struct Denom_uarray2 *)denom_ua2)->denominator;
-        Pnm_rgb rgb_vals = val;
+        assert(RGB_floats != NULL && pixels != NULL);
+
+        int width = Planar_width(RGB_floats);
+        int height = Planar_height(RGB_floats);
+        assert(stride >= (size_t)width * 3);
+
+        int row, col;
+        for (row = 0; width > 0 && row < height; row++) {
+                unsigned char *d = pixels + row * stride;
+                float *red = Planar_row(RGB_floats, PLANAR_RED, row);
+                float *green = Planar_row(RGB_floats, PLANAR_GREEN, row);
+                float *blue = Planar_row(RGB_floats, PLANAR_BLUE, row);
+
+                for (col = 0; col < width; col++, d += 3) {
+                        d[0] = float_to_RGBval(red[col], DENOMINATOR);
+                        d[1] = float_to_RGBval(green[col], DENOMINATOR);
+                        d[2] = float_to_RGBval(blue[col], DENOMINATOR);
+                }
+        }
 
-        int width = UArray2_width(new_array2);
-        int height = UArray2_height(new_array2);
-        
-        /* check if col and row is within range */
-        if ((col < width) && (row < height)) {
-                /* initialize a struct and converts each RGBVal to floats 
-                   using a private helper function */
-                struct RGB_floats floats;
-                floats.red = RGBval_to_float(rgb_vals->red, denom);
-                floats.green = RGBval_to_float(rgb_vals->green, denom);
-                floats.blue = RGBval_to_float(rgb_vals->blue, denom);
-                
-                /* add the RGB_floats struct to the new array of floats */
-                *(struct RGB_floats *)(UArray2_at(new_array2, col, row)) =
-                                                                floats;
+        Planar_free(&RGB_floats);
+}
+
+/* FUNCTION:  ppm_RGBfloats_stream_open
+ * Purpose:   Starts reading a PPM a few rows at a time
+ * Arg:       file: a file pointer at the start of a binary (P6) or plain
+ *                  (P3) PPM; it can be a pipe
+ * Returns:   A new stream, positioned at the first row
+ * Effect:    Reads the header of the PPM, up to and including the single
+ *            white space character after the maxval
+ * Error:     Runtime error if file is NULL or the header is not that of a
+ *            P6 or P3 PPM, or if memory cannot be allocated
+ */
+ppm_RGBfloats_stream_T ppm_RGBfloats_stream_open(FILE *file)
+{
+        assert(file != NULL);
+
+        ppm_RGBfloats_stream_T stream = malloc(sizeof(*stream));
+        assert(stream != NULL);
+        stream->file = file;
+        stream->row = NULL;
+        stream->row_capacity = 0;
+        read_stream_header(stream);
+
+        return stream;
+}
+
+/* FUNCTION:  ppm_RGBfloats_stream_width
+ * Purpose:   Returns the width of the image a stream reads
+ * Arg:       stream: an initialized stream
+ * Returns:   The width, trimmed to an even number
+ * Effect:    N/A
+ * Error:     Runtime error if stream is NULL
+ */
+int ppm_RGBfloats_stream_width(ppm_RGBfloats_stream_T stream)
+{
+        assert(stream != NULL);
+        return stream->width;
+}
+
+/* FUNCTION:  ppm_RGBfloats_stream_height
+ * Purpose:   Returns the height of the image a stream reads
+ * Arg:       stream: an initialized stream
+ * Returns:   The height, trimmed to an even number
+ * Effect:    N/A
+ * Error:     Runtime error if stream is NULL
+ */
+int ppm_RGBfloats_stream_height(ppm_RGBfloats_stream_T stream)
+{
+        assert(stream != NULL);
+        return stream->height;
+}
+
+/* FUNCTION:  ppm_RGBfloats_stream_read
+ * Purpose:   Reads the next rows of a stream
+ * Arg:       stream: an initialized stream
+ *            RGB_floats: a planar image with red, green and blue planes,
+ *                        as wide as the stream; it receives as many rows as
+ *                        it has
+ * Returns:   N/A
+ * Effect:    Reads whole rows of the file; the column dropped by trimming
+ *            is read and ignored
+ * Error:     Runtime error if a NULL pointer is passed in, if the image
+ *            has the wrong width or more rows than are left, or if the file
+ *            ends early or holds a sample larger than its maxval
+ */
+void ppm_RGBfloats_stream_read(ppm_RGBfloats_stream_T stream, 
+                               Planar_T RGB_floats)
+{
+        assert(stream != NULL && RGB_floats != NULL);
+        assert((unsigned)Planar_width(RGB_floats) == stream->width);
+        unsigned nrows = Planar_height(RGB_floats);
+        assert(nrows <= stream->height - stream->next_row);
+
+        unsigned denom = stream->denom;
+        unsigned row, col, i;
+        for (row = 0; row < nrows; row++) {
+                float *rgb[3];
+                for (i = 0; i < 3; i++) {
+                        rgb[i] = Planar_row(RGB_floats, PLANAR_RED + i, row);
+                }
+
+                if (stream->plain) {
+                        for (col = 0; col < stream->raw_width; col++) {
+                                for (i = 0; i < 3; i++) {
+                                        unsigned val;
+                                        int got = fscanf(stream->file, "%u",
+                                                         &val);
+                                        assert(got == 1 && val <= denom);
+                                        if (col < stream->width) {
+                                                rgb[i][col] = RGBval_to_float(
+                                                        val, denom);
+                                        }
+                                }
+                        }
+                        continue;
+                }
+
+                size_t got = fread(stream->row, 3 * stream->sample_bytes,
+                                   stream->raw_width, stream->file);
+                assert(got == stream->raw_width);
+                const unsigned char *s = stream->row;
+                for (col = 0; col < stream->width; col++) {
+                        for (i = 0; i < 3; i++) {
+                                unsigned val = *s++;
+                                if (stream->sample_bytes == 2) {
+                                        val = (val << 8) | *s++;
+                                }
+                                assert(val <= denom);
+                                rgb[i][col] = RGBval_to_float(val, denom);
+                        }
+                }
         }
-        
-        (void) RGBVals;
+
+        stream->next_row += nrows;
+}
+
+/* FUNCTION:  ppm_RGBfloats_stream_finish
+ * Purpose:   Reads past the rows of a stream that have not been read
+ * Arg:       stream: an initialized stream
+ * Returns:   N/A
+ * Effect:    Reads and drops the rest of the samples, including the last
+ *            row of an image of odd height, so that the file is left just
+ *            after the image, at the next PPM of a sequence if there is one
+ * Error:     Runtime error if stream is NULL or the file ends early
+ */
+void ppm_RGBfloats_stream_finish(ppm_RGBfloats_stream_T stream)
+{
+        assert(stream != NULL);
+
+        size_t samples = (size_t)(stream->raw_height - stream->next_row) *
+                         stream->raw_width * 3;
+        size_t i;
+        for (i = 0; stream->plain && i < samples; i++) {
+                unsigned val;
+                int got = fscanf(stream->file, "%u", &val);
+                assert(got == 1 && val <= stream->denom);
+        }
+        if (!stream->plain && samples > 0) {
+                size_t row_bytes = (size_t)stream->raw_width * 3 * 
+                                   stream->sample_bytes;
+                for (i = 0; i < samples * stream->sample_bytes; 
+                     i += row_bytes) {
+                        size_t got = fread(stream->row, 1, row_bytes, 
+                                           stream->file);
+                        assert(got == row_bytes);
+                }
+        }
+
+        stream->next_row = stream->raw_height;
 }
 
+/* FUNCTION:  ppm_RGBfloats_stream_next
+ * Purpose:   Moves a stream to the next PPM of a sequence
+ * Arg:       stream: an initialized stream
+ * Returns:   true if another PPM follows, false at the end of the file
+ * Effect:    Finishes the current image, skips white space and reads the
+ *            header of the next PPM into the same stream; the row buffer
+ *            is kept and only grows when a wider image follows
+ * Error:     Runtime error if stream is NULL, if the file ends early or if
+ *            what follows is not the header of a P6 or P3 PPM
+ */
+bool ppm_RGBfloats_stream_next(ppm_RGBfloats_stream_T stream)
+{
+        assert(stream != NULL);
+
+        ppm_RGBfloats_stream_finish(stream);
+
+        int c;
+        do {
+                c = getc(stream->file);
+        } while (c != EOF && isspace(c));
+        if (c == EOF) {
+                return false;
+        }
+        ungetc(c, stream->file);
+
+        read_stream_header(stream);
 
-/* FUNCTION:  to_RGBvals_apply
- * Purpose:   For each pixel in the array of RGB floats, convert each RGB value
- *            convert each RGB float to a scaled RGB int (using our private
- *            helper function) and add the pixel to the new array of scaled 
- *            RGB ints
- * Arg:       col: a int representing the current column in the array
- *            row: a row representing the current row in the array
- *            RGBfloats: pointer to an uarray2 instance of RGBfloats (unused)
- *            val: pointer to the current pixel containing an RGB_floats struct
- *            denom_ua2: a Denom_uarray2 struct containing the new array of
- *                       scaled RGB ints and the RGB denominator
+        return true;
+}
+
+/* FUNCTION:  ppm_RGBfloats_stream_free
+ * Purpose:   Deallocates a stream and clears *stream
+ * Arg:       stream: the address of an initialized stream
  * Returns:   N/A
- * Effect:    Populates the new uarray2 of scaled RGB ints
+ * Effect:    Does not close the file
+ * Error:     Runtime error if stream or *stream is NULL
+ */
+void ppm_RGBfloats_stream_free(ppm_RGBfloats_stream_T *stream)
+{
+        assert(stream != NULL && *stream != NULL);
+
+        free((*stream)->row);
+        free(*stream);
+        *stream = NULL;
+}
+
+/* FUNCTION:  read_header_number
+ * Purpose:   Reads the next number of the header of a PPM
+ * Arg:       file: a file pointer inside the header
+ * Returns:   The number
+ * Effect:    Skips white space and comments (from # to the end of the 
+ *            line) before the number; stops just after its last digit
+ * Error:     Runtime error if the next thing in the header is not a number
+ */
+static unsigned read_header_number(FILE *file)
+{
+        int c = getc(file);
+        while (c == '#' || isspace(c)) {
+                if (c == '#') {
+                        while (c != '\n' && c != EOF) {
+                                c = getc(file);
+                        }
+                }
+                c = getc(file);
+        }
+        assert(isdigit(c));
+
+        unsigned number = 0;
+        while (isdigit(c)) {
+                number = number * 10 + (c - '0');
+                c = getc(file);
+        }
+        ungetc(c, file);
+
+        return number;
+}
+
+/* FUNCTION:  read_stream_header
+ * Purpose:   Reads the header of a PPM into a stream
+ * Arg:       stream: a stream whose file is at the start of a binary (P6)
+ *                    or plain (P3) PPM
+ * Returns:   N/A
+ * Effect:    Reads up to and including the single white space character
+ *            after the maxval; sets the dimensions and positions the stream
+ *            at the first row, growing its row buffer if it is too small
+ * Error:     Runtime error if the header is not that of a P6 or P3 PPM, or
+ *            if memory cannot be allocated
+ */
+static void read_stream_header(ppm_RGBfloats_stream_T stream)
+{
+        FILE *file = stream->file;
+        int magic = getc(file);
+        int kind = getc(file);
+        assert(magic == 'P' && (kind == '6' || kind == '3'));
+
+        stream->plain = kind == '3';
+        stream->raw_width = read_header_number(file);
+        stream->width = trim_dimension(stream->raw_width);
+        stream->raw_height = read_header_number(file);
+        stream->height = trim_dimension(stream->raw_height);
+        stream->denom = read_header_number(file);
+        assert(stream->denom > 0 && stream->denom <= 65535);
+        int space = getc(file);
+        assert(space != EOF && isspace(space));
+
+        stream->sample_bytes = stream->denom > 255 ? 2 : 1;
+        stream->next_row = 0;
+
+        size_t row_bytes = (size_t)stream->raw_width * 3 *
+                           stream->sample_bytes + 1;
+        if (!stream->plain && row_bytes > stream->row_capacity) {
+                free(stream->row);
+                stream->row = malloc(row_bytes);
+                assert(stream->row != NULL);
+                stream->row_capacity = row_bytes;
+        }
+}
+
+/* FUNCTION:  mapped_to_planar
+ * Purpose:   Converts the raw rows of a mapped binary PPM to a planar image
+ *            of RGB floats
+ * Arg:       map: an initialized PPM_map_T of a binary PPM
+ * Returns:   A planar image with red, green and blue planes, trimmed to even
+ *            dimensions
+ * Effect:    Reads the samples straight out of the mapped file
  * Error:     N/A
  */
-static void to_RGBvals_apply(int col, int row, UArray2_T RGBfloats, void *val, 
-                             void *denom_ua2)
+static Planar_T mapped_to_planar(PPM_map_T map)
 {
-        /* typecast and dereference closure and currente element */
-        UArray2_T new_array2 = ((struct Denom_uarray2 *)denom_ua2)->array2;
-        unsigned denom = ((struct Denom_uarray2 *)denom_ua2)->denominator;
-        struct RGB_floats floats = *(struct RGB_floats*)val;
-
-        /* initialize a struct and converts each float to RGB values 
-           using a private helper function */
-        struct Pnm_rgb rgb;
-        rgb.red = float_to_RGBval(floats.red, denom);
-        rgb.green = float_to_RGBval(floats.green, denom);
-        rgb.blue = float_to_RGBval(floats.blue, denom);
-
-        /* add the RGB_floats struct to the new array of floats */
-        *(Pnm_rgb)(UArray2_at(new_array2, col, row)) = rgb;
-
-        (void) RGBfloats;
+        int width = trim_dimension(PPM_map_width(map));
+        int height = trim_dimension(PPM_map_height(map));
+        unsigned denom = PPM_map_denominator(map);
+        unsigned two_bytes = PPM_map_sample_bytes(map) == 2;
+        Planar_T RGB_floats = Planar_new(width, height, 3);
+
+        /* every sample of the file, trimmed ones included, must be at most
+           the maxval, as Pnm_ppmread requires; a maxval of 255 in one byte
+           samples cannot be exceeded */
+        bool check = two_bytes || denom < 255;
+        size_t row_samples = (size_t)PPM_map_width(map) * 3;
+        unsigned raw_row;
+        for (raw_row = height; check && raw_row < PPM_map_height(map);
+             raw_row++) {
+                assert(largest_sample(PPM_map_row(map, raw_row), row_samples,
+                                      two_bytes) <= denom);
+        }
+
+        int row, col;
+        for (row = 0; row < height; row++) {
+                const unsigned char *samples = PPM_map_row(map, row);
+                assert(!check || largest_sample(samples, row_samples,
+                                                two_bytes) <= denom);
+                float *red = Planar_row(RGB_floats, PLANAR_RED, row);
+                float *green = Planar_row(RGB_floats, PLANAR_GREEN, row);
+                float *blue = Planar_row(RGB_floats, PLANAR_BLUE, row);
+
+                if (two_bytes) {
+                        /* samples are 16 bits, most significant byte first */
+                        for (col = 0; col < width; col++) {
+                                const unsigned char *s = samples + 6 * col;
+                                red[col] = RGBval_to_float(
+                                        (s[0] << 8) | s[1], denom);
+                                green[col] = RGBval_to_float(
+                                        (s[2] << 8) | s[3], denom);
+                                blue[col] = RGBval_to_float(
+                                        (s[4] << 8) | s[5], denom);
+                        }
+                } else {
+                        for (col = 0; col < width; col++) {
+                                const unsigned char *s = samples + 3 * col;
+                                red[col] = RGBval_to_float(s[0], denom);
+                                green[col] = RGBval_to_float(s[1], denom);
+                                blue[col] = RGBval_to_float(s[2], denom);
+                        }
+                }
+        }
+
+        return RGB_floats;
 }
 
+/* FUNCTION:  largest_sample
+ * Purpose:   Returns the largest of a run of raw samples
+ * Arg:       samples: the raw samples of a binary PPM
+ *            count: the number of samples
+ *            two_bytes: whether each sample is 2 bytes, most significant
+ *                       first, rather than 1
+ * Returns:   The largest sample, or 0 if count is 0
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static unsigned largest_sample(const unsigned char *samples, size_t count,
+                               bool two_bytes)
+{
+        unsigned largest = 0;
+        size_t i;
+        for (i = 0; i < count; i++) {
+                unsigned val = samples[i];
+                if (two_bytes) {
+                        val = (samples[2 * i] << 8) | samples[2 * i + 1];
+                }
+                if (val > largest) {
+                        largest = val;
+                }
+        }
+
+        return largest;
+}
+
+/* FUNCTION:  plain_to_planar
+ * Purpose:   Parses a mapped plain PPM into a planar image of RGB floats
+ * Arg:       map: an initialized PPM_map_T of a plain PPM
+ * Returns:   A planar image with red, green and blue planes, trimmed to even
+ *            dimensions
+ * Effect:    Every sample value is converted once, into a table that the
+ *            parsing threads index
+ * Error:     Runtime error if memory cannot be allocated
+ */
+static Planar_T plain_to_planar(PPM_map_T map)
+{
+        int width = trim_dimension(PPM_map_width(map));
+        int height = trim_dimension(PPM_map_height(map));
+        unsigned denom = PPM_map_denominator(map);
+        Planar_T RGB_floats = Planar_new(width, height, 3);
+
+        float *to_float = malloc((denom + 1) * sizeof(*to_float));
+        assert(to_float != NULL);
+        unsigned val;
+        for (val = 0; val <= denom; val++) {
+                to_float[val] = RGBval_to_float(val, denom);
+        }
+
+        P3_map_parse(map, RGB_floats, to_float, parse_threads);
+        free(to_float);
+
+        return RGB_floats;
+}
 
 /* FUNCTION:  trim_dimension
  * Purpose:   Round down a dimension to the closest even value
@@ -290,26 +726,6 @@ static unsigned float_to_RGBval(float val, unsigned denom)
 }
 
 
-/* FUNCTION:  new_denom_uarray2
- * Purpose:   Create a new instance of the Denom_uarray2 struct
- * Arg:       array2: an initialized uarray2
- *            denom: an unsigned value for the denominator
- * Returns:   An initialized Denom_uarray2 struct
- * Effect:    N/A
- * Error:     Runtime error if null pointer passed in as arg
- */
-static struct Denom_uarray2 new_denom_uarray2(UArray2_T array2, unsigned denom)
-{
-        assert(array2 != NULL);
-        
-        struct Denom_uarray2 dm_ua2;
-        dm_ua2.array2 = array2;
-        dm_ua2.denominator = denom;
-
-        return dm_ua2;
-}
-
-
 /* FUNCTION:  pnm_ppm_new
  * Purpose:   Create a new instance of a Pnm_ppm on the heap
  * Arg:       width: the width of the uarray2 in the Pnm_ppm
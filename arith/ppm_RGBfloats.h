@@ -9,49 +9,169 @@
  *     Summary:
  *     This is the public interface of our ppm_RGBfloats module. 
  *     The purpose of this module is to convert between a PPM file and a 
- *     UArray2 of RGB float values. This module contains two public functions,
- *     one that reads in a PPM file and returns a UArray2 of RGB float values,
- *     and one that takes in a UArray2 of RGB float values and writes a PPM 
- *     file to stdout. In compression data is potentially lost in the process
- *     of trimming down the width and the height to an even number from the
- *     original file. The denominator from the original file is lost from the 
- *     conversion between RGB values and their scaled floats representation.
+ *     planar image of RGB float values. This module reads a PPM file, whole
+ *     or a few rows at a time, into planes of RGB floats, and writes planes
+ *     of RGB floats back as a PPM or as pixels in memory. In compression 
+ *     data is potentially lost in the process of trimming down the width 
+ *     and the height to an even number from the original file. The 
+ *     denominator from the original file is lost from the conversion 
+ *     between RGB values and their scaled floats representation.
  *     Additionally, the exact RGB ratios are lost due to imprecise nature of
  *     floating point math.
  * 
  *
  ****************************************************************************/
 #include <stdio.h>
-#include "uarray2.h"
+#include <stdbool.h>
+#include "Planar.h"
 
 #ifndef PPMRGBFLOATS_INCLUDED
 #define PPMRGBFLOATS_INCLUDED
 
-/* FUNCTION:  ppm_RGBfloats_compress
- * Purpose:   Converts a given ppm file to an uarray2 of RGB float values
+/* a PPM being read a few rows at a time */
+typedef struct ppm_RGBfloats_stream *ppm_RGBfloats_stream_T;
+
+/* FUNCTION:  ppm_RGBfloats_set_threads
+ * Purpose:   Sets the number of threads that parse a plain PPM in
+ *            ppm_RGBfloats_compress_planar
+ * Arg:       nthreads: the number of threads
+ * Returns:   N/A
+ * Effect:    The floats are the same whatever the number of threads
+ * Error:     Runtime error if nthreads is 0
+ */
+void ppm_RGBfloats_set_threads(unsigned nthreads);
+
+/* FUNCTION:  ppm_RGBfloats_compress_planar
+ * Purpose:   Reads a PPM file into a planar image of RGB floats
  * Arg:       file: a file pointer that stores the original image pixels
- * Returns:   pointer to an UArray2 instance that stores the compressed pixels
- * Effect:    allocates and recycles a RGB_floats struct
- *            recycles the pnm_ppm instance
- *            note that the file has already been opened
- * Error:     Runtime error if file is empty, if methods is null, or if memory
- *            allocation for the struct fails
+ * Returns:   A planar image with red, green and blue planes, trimmed to even
+ *            dimensions
+ * Effect:    A binary or plain PPM in a regular file is read through a
+ *            memory mapping without building a pnm_ppm, a plain one by
+ *            several threads (see ppm_RGBfloats_set_threads); anything
+ *            else is read with Pnm_ppmread
+ * Error:     Runtime error if file is NULL or is not a PPM
+ */
+Planar_T ppm_RGBfloats_compress_planar(FILE *file);
+
+/* FUNCTION:  ppm_RGBfloats_decompress_planar
+ * Purpose:   Writes a planar image of RGB floats as a PPM to stdout
+ * Arg:       RGB_floats: a planar image with red, green and blue planes
+ * Returns:   N/A
+ * Effect:    writes a PPM to stdout and recycles the planar image
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+void ppm_RGBfloats_decompress_planar(Planar_T RGB_floats);
+
+/* FUNCTION:  ppm_RGBfloats_write_planar
+ * Purpose:   Writes a planar image as a PPM to a file
+ * Arg:       RGB_floats: a planar image with red, green and blue planes
+ *            file: pointer to a file open for writing
+ * Returns:   N/A
+ * Effect:    The same PPM as ppm_RGBfloats_decompress_planar, but
+ *            RGB_floats is not recycled
+ * Error:     Runtime error if a NULL pointer is passed in
+ */
+void ppm_RGBfloats_write_planar(Planar_T RGB_floats, FILE *file);
+
+/* FUNCTION:  ppm_RGBfloats_from_pixels
+ * Purpose:   Converts 8 bit RGB pixels in memory to a planar image
+ * Arg:       pixels: rows of width red, green, blue byte triples
+ *            width, height: the dimensions of the pixels
+ *            stride: the number of bytes from one row to the next
+ * Returns:   A planar image with red, green and blue planes, trimmed to even
+ *            dimensions as in ppm_RGBfloats_compress_planar
+ * Effect:    The floats are those of a PPM with a maxval of 255
+ * Error:     Runtime error if pixels is NULL, if a dimension is negative or
+ *            if stride is less than 3 * width
+ */
+Planar_T ppm_RGBfloats_from_pixels(const unsigned char *pixels, int width,
+                                   int height, size_t stride);
+
+/* FUNCTION:  ppm_RGBfloats_to_pixels
+ * Purpose:   Converts a planar image to 8 bit RGB pixels in memory
+ * Arg:       RGB_floats: a planar image with red, green and blue planes
+ *            pixels: room for its rows of red, green, blue byte triples
+ *            stride: the number of bytes from one row to the next
+ * Returns:   N/A
+ * Effect:    The bytes are the samples ppm_RGBfloats_decompress_planar
+ *            writes; recycles the planar image. Bytes between the end of a
+ *            row and the next row are not touched
+ * Error:     Runtime error if a NULL pointer is passed in or if stride is
+ *            less than 3 times the width
+ */
+void ppm_RGBfloats_to_pixels(Planar_T RGB_floats, unsigned char *pixels,
+                             size_t stride);
+
+/* FUNCTION:  ppm_RGBfloats_stream_open
+ * Purpose:   Starts reading a PPM a few rows at a time
+ * Arg:       file: a file pointer at the start of a binary (P6) or plain
+ *                  (P3) PPM; it can be a pipe
+ * Returns:   A new stream, positioned at the first row
+ * Effect:    Reads the header of the PPM
+ * Error:     Runtime error if file is NULL or the header is not that of a
+ *            P6 or P3 PPM, or if memory cannot be allocated
  */
-UArray2_T ppm_RGBfloats_compress(FILE *file);
+ppm_RGBfloats_stream_T ppm_RGBfloats_stream_open(FILE *file);
 
+/* FUNCTION:  ppm_RGBfloats_stream_width, ppm_RGBfloats_stream_height
+ * Purpose:   Return the dimensions of the image a stream reads
+ * Arg:       stream: an initialized stream
+ * Returns:   The width or height, trimmed to an even number as in
+ *            ppm_RGBfloats_compress_planar
+ * Effect:    N/A
+ * Error:     Runtime error if stream is NULL
+ */
+int ppm_RGBfloats_stream_width(ppm_RGBfloats_stream_T stream);
+int ppm_RGBfloats_stream_height(ppm_RGBfloats_stream_T stream);
+
+/* FUNCTION:  ppm_RGBfloats_stream_read
+ * Purpose:   Reads the next rows of a stream
+ * Arg:       stream: an initialized stream
+ *            RGB_floats: a planar image with red, green and blue planes,
+ *                        as wide as the stream; it receives as many rows as
+ *                        it has
+ * Returns:   N/A
+ * Effect:    The floats are the same as ppm_RGBfloats_compress_planar gives
+ *            for those rows
+ * Error:     Runtime error if a NULL pointer is passed in, if the image
+ *            has the wrong width or more rows than are left, or if the file
+ *            ends early or holds a sample larger than its maxval
+ */
+void ppm_RGBfloats_stream_read(ppm_RGBfloats_stream_T stream, 
+                               Planar_T RGB_floats);
+
+/* FUNCTION:  ppm_RGBfloats_stream_finish
+ * Purpose:   Reads past the rows of a stream that have not been read
+ * Arg:       stream: an initialized stream
+ * Returns:   N/A
+ * Effect:    Leaves the file just after the image, including the last row
+ *            of an image of odd height, so that the next PPM of a sequence
+ *            can be opened as a new stream
+ * Error:     Runtime error if stream is NULL or the file ends early
+ */
+void ppm_RGBfloats_stream_finish(ppm_RGBfloats_stream_T stream);
+
+/* FUNCTION:  ppm_RGBfloats_stream_next
+ * Purpose:   Moves a stream to the next PPM of a sequence
+ * Arg:       stream: an initialized stream
+ * Returns:   true if another PPM follows, false at the end of the file
+ * Effect:    Finishes the current image, skips white space and reads the
+ *            header of the next PPM into the same stream, so a sequence of
+ *            any length is read without allocating for each image
+ * Error:     Runtime error if stream is NULL, if the file ends early or if
+ *            what follows is not the header of a P6 or P3 PPM
+ */
+bool ppm_RGBfloats_stream_next(ppm_RGBfloats_stream_T stream);
 
-/* FUNCTION:  ppm_RGBfloats_decompress
- * Purpose:   Prints an uarray2 of RGB float values 
- * Arg:       RGB_floats: pointer to an instance of uarray2 that stores the 
- *                        RGB values in floats
+/* FUNCTION:  ppm_RGBfloats_stream_free
+ * Purpose:   Deallocates a stream and clears *stream
+ * Arg:       stream: the address of an initialized stream
  * Returns:   N/A
- * Effect:    allocates and recycles a Pnm_rgb struct
- *            recycles the pnm_ppm instance
- *            note that the file has already been opened
- * Error:     Runtime error if uarray2 is uninitialized, 
- *            if methods is null, or if memory allocation for the struct fails
+ * Effect:    Does not close the file
+ * Error:     Runtime error if stream or *stream is NULL
  */
-void ppm_RGBfloats_decompress(UArray2_T RGB_floats);
+void ppm_RGBfloats_stream_free(ppm_RGBfloats_stream_T *stream);
 
 
 #endif
\ No newline at end of file
@@ -0,0 +1,240 @@
+/*****************************************************************************
+ *
+ *                                 ppmgen.c
+ *
+ *     Project:    Arith
+ *     Authors:    Eric Zhao, Leo Kim
+ *     Date:       October 26, 2022
+ *
+ *     Summary:
+ *     This is the main function for ppmgen, the image generator used by
+ *     make bench. It writes a synthetic binary (P6) PPM to stdout, one row
+ *     at a time so that very large images need no memory:
+ *
+ *         ppmgen gradient|noise|photo width height [seed]
+ *
+ *     gradient is smooth color ramps, the easiest case for the compressor;
+ *     noise is uniformly random samples, the hardest; photo mixes smooth
+ *     shading, hard edged shapes and a little sensor noise, which is closer
+ *     to a photograph. The same arguments always give the same image.
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+/* maxval of the generated images */
+#define DENOMINATOR 255
+
+/* number of hard edged discs in a photo image */
+#define DISCS 24
+
+typedef void Row_fun(unsigned char *row, unsigned width, unsigned height,
+                     unsigned y, uint64_t *state);
+
+/*
+ * private helper functions, functions details are included in the function
+ * contracts respectively
+ */
+static uint64_t next_random(uint64_t *state);
+static void     gradient_row(unsigned char *row, unsigned width,
+                             unsigned height, unsigned y, uint64_t *state);
+static void     noise_row(unsigned char *row, unsigned width,
+                          unsigned height, unsigned y, uint64_t *state);
+static void     photo_row(unsigned char *row, unsigned width,
+                          unsigned height, unsigned y, uint64_t *state);
+static unsigned char clamp_sample(double value);
+
+/* main that handles command line arguments and writes the image */
+int main(int argc, char *argv[])
+{
+        if (argc < 4 || argc > 5) {
+                fprintf(stderr, "Usage: %s gradient|noise|photo width height "
+                        "[seed]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        Row_fun *row_fun = NULL;
+        if (strcmp(argv[1], "gradient") == 0) {
+                row_fun = gradient_row;
+        } else if (strcmp(argv[1], "noise") == 0) {
+                row_fun = noise_row;
+        } else if (strcmp(argv[1], "photo") == 0) {
+                row_fun = photo_row;
+        } else {
+                fprintf(stderr, "%s: unknown kind '%s'\n", argv[0], argv[1]);
+                return EXIT_FAILURE;
+        }
+
+        long width = atol(argv[2]);
+        long height = atol(argv[3]);
+        if (width < 1 || height < 1) {
+                fprintf(stderr, "%s: width and height must be positive\n",
+                        argv[0]);
+                return EXIT_FAILURE;
+        }
+        uint64_t state = argc == 5 ? strtoull(argv[4], NULL, 10) : 40;
+        state = state * 2 + 1;
+
+        unsigned char *row = malloc((size_t)width * 3);
+        if (row == NULL) {
+                fprintf(stderr, "%s: out of memory\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        printf("P6\n%ld %ld\n%d\n", width, height, DENOMINATOR);
+        long y;
+        for (y = 0; y < height; y++) {
+                row_fun(row, width, height, y, &state);
+                if (fwrite(row, 3, width, stdout) != (size_t)width) {
+                        fprintf(stderr, "%s: write failed\n", argv[0]);
+                        return EXIT_FAILURE;
+                }
+        }
+
+        free(row);
+        return EXIT_SUCCESS;
+}
+
+/* FUNCTION:  next_random
+ * Purpose:   Steps a xorshift generator
+ * Arg:       state: pointer to the non-zero state of the generator
+ * Returns:   The next 64 random bits
+ * Effect:    Updates *state
+ * Error:     N/A
+ */
+static uint64_t next_random(uint64_t *state)
+{
+        uint64_t x = *state;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        *state = x;
+
+        return x;
+}
+
+/* FUNCTION:  gradient_row
+ * Purpose:   Fills a row of a gradient image
+ * Arg:       row: receives width pixels of 3 samples
+ *            width, height: the dimensions of the image
+ *            y: the index of the row
+ *            state: the random generator (unused)
+ * Returns:   N/A
+ * Effect:    Red ramps across, green ramps down and blue along the diagonal
+ * Error:     N/A
+ */
+static void gradient_row(unsigned char *row, unsigned width, unsigned height,
+                         unsigned y, uint64_t *state)
+{
+        unsigned x;
+        for (x = 0; x < width; x++) {
+                double u = (double)x / width;
+                double v = (double)y / height;
+                row[3 * x] = clamp_sample(u * DENOMINATOR);
+                row[3 * x + 1] = clamp_sample(v * DENOMINATOR);
+                row[3 * x + 2] = clamp_sample((u + v) / 2 * DENOMINATOR);
+        }
+
+        (void) state;
+}
+
+/* FUNCTION:  noise_row
+ * Purpose:   Fills a row of a noise image
+ * Arg:       row: receives width pixels of 3 samples
+ *            width, height: the dimensions of the image
+ *            y: the index of the row (unused)
+ *            state: the random generator
+ * Returns:   N/A
+ * Effect:    Every sample is uniformly random
+ * Error:     N/A
+ */
+static void noise_row(unsigned char *row, unsigned width, unsigned height,
+                      unsigned y, uint64_t *state)
+{
+        unsigned i;
+        for (i = 0; i < width * 3; i++) {
+                row[i] = next_random(state) % (DENOMINATOR + 1);
+        }
+
+        (void) height;
+        (void) y;
+}
+
+/* FUNCTION:  photo_row
+ * Purpose:   Fills a row of a photographic-like image
+ * Arg:       row: receives width pixels of 3 samples
+ *            width, height: the dimensions of the image
+ *            y: the index of the row
+ *            state: the random generator, used for the sensor noise
+ * Returns:   N/A
+ * Effect:    Smooth low frequency shading, with hard edged colored discs
+ *            on top, plus a little noise. The discs are placed by a fixed
+ *            generator so that they are the same on every row
+ * Error:     N/A
+ */
+static void photo_row(unsigned char *row, unsigned width, unsigned height,
+                      unsigned y, uint64_t *state)
+{
+        double v = (double)y / height;
+        double size = width > height ? width : height;
+
+        /* the discs, regenerated identically for every row */
+        uint64_t disc_state = 0x9e3779b97f4a7c15ULL;
+        double cx[DISCS], cy[DISCS], r[DISCS], color[DISCS][3];
+        int d, c;
+        for (d = 0; d < DISCS; d++) {
+                cx[d] = (next_random(&disc_state) % 1000) / 1000.0 * width;
+                cy[d] = (next_random(&disc_state) % 1000) / 1000.0 * height;
+                r[d] = (20 + next_random(&disc_state) % 100) / 1000.0 * size;
+                for (c = 0; c < 3; c++) {
+                        color[d][c] = next_random(&disc_state) %
+                                      (DENOMINATOR + 1);
+                }
+        }
+
+        unsigned x;
+        for (x = 0; x < width; x++) {
+                double u = (double)x / width;
+                double pixel[3];
+                pixel[0] = 128 + 90 * sin(3.1 * u + 1.7 * v);
+                pixel[1] = 110 + 80 * cos(2.3 * v - 1.1 * u);
+                pixel[2] = 100 + 70 * sin(4.0 * u * v + 0.5);
+
+                for (d = 0; d < DISCS; d++) {
+                        double dx = x - cx[d];
+                        double dy = (double)y - cy[d];
+                        if (dx * dx + dy * dy < r[d] * r[d]) {
+                                for (c = 0; c < 3; c++) {
+                                        pixel[c] = color[d][c];
+                                }
+                        }
+                }
+
+                for (c = 0; c < 3; c++) {
+                        double noise = (int)(next_random(state) % 9) - 4;
+                        row[3 * x + c] = clamp_sample(pixel[c] + noise);
+                }
+        }
+}
+
+/* FUNCTION:  clamp_sample
+ * Purpose:   Rounds a value to a sample
+ * Arg:       value: the value
+ * Returns:   The value rounded and clamped to [0, DENOMINATOR]
+ * Effect:    N/A
+ * Error:     N/A
+ */
+static unsigned char clamp_sample(double value)
+{
+        if (value < 0) {
+                return 0;
+        }
+        if (value > DENOMINATOR) {
+                return DENOMINATOR;
+        }
+
+        return (unsigned char)(value + 0.5);
+}
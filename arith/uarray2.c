@@ -8,13 +8,16 @@
  *      unboxed array data structure: UArray2. Our UArray2 is represented by
  *      one long single dimensional unboxed array whose indices correspond to
  *      different rows and columns. The UArray2 can be used to store a 2D array
- *      of any type of data that the client chooses to supply.
+ *      of any type of data that the client chooses to supply. Arrays too
+ *      big for memory are mapped from a temporary file by Map_store; the
+ *      others are allocated on the heap.
  */
 
 #include <stdlib.h>
 #include <assert.h>
 #include "uarray2.h"
 #include "uarray2rep.h"
+#include "Map_store.h"
 
 
 /*
@@ -31,6 +34,7 @@ UArray2_T UArray2_new(int width, int height, int elemSize)
         /* test to make sure valid inputs given */
         assert(width >= 0);
         assert(height >= 0);
+        assert(elemSize > 0);
         
         /* allocate memory for the UArray2 */
         UArray2_T tempArr;
@@ -40,8 +44,17 @@ UArray2_T UArray2_new(int width, int height, int elemSize)
         /* initialize the UArray2 private data members */
         tempArr->width = width;
         tempArr->height = height;
-        tempArr->Uarray = UArray_new(width * height, elemSize);
-        
+        tempArr->size = elemSize;
+
+        /* the elements start zeroed either way; allocate at least one byte
+           so that the pointer is never NULL */
+        tempArr->bytes = (size_t)width * height * elemSize;
+        tempArr->elems = Map_store_alloc(tempArr->bytes);
+        tempArr->mapped = tempArr->elems != NULL;
+        if (!tempArr->mapped) {
+                tempArr->elems = calloc(tempArr->bytes + 1, 1);
+                assert(tempArr->elems != NULL);
+        }
 
         return tempArr;
 }
@@ -81,7 +94,7 @@ int UArray2_height(UArray2_T array)
 int UArray2_size(UArray2_T array)
 {
         assert(array != NULL);
-        return UArray_size(array->Uarray);
+        return array->size;
 }
  
 /*
@@ -101,10 +114,28 @@ void *UArray2_at(UArray2_T array, int col, int row)
         assert(row < array->height && row >= 0);
 
         /* calculate the array index from the row and column */
-        int loc = row * array->width + col;
+        size_t loc = (size_t)row * array->width + col;
 
         /* return a void pointer to the corresponding location */
-        return UArray_at(array->Uarray, loc);
+        return array->elems + loc * array->size;
+}
+ 
+/*
+ * Description: This function returns the location of the first element of
+ *              the given row; the rest of the row follows it contiguously
+ * Expected inputs: 
+ *       array: an initialized UArray2 with at least one column
+ *       row: non-negative int for the row in the array
+ * Expected outputs: A pointer to the start of the row in the UArray2
+ */
+void *UArray2_row(UArray2_T array, int row)
+{
+        /* test to make sure valid inputs are given */
+        assert(array != NULL);
+        assert(array->width > 0);
+        assert(row < array->height && row >= 0);
+
+        return array->elems + (size_t)row * array->width * array->size;
 }
  
 /*
@@ -172,12 +203,12 @@ void UArray2_map_row_major(UArray2_T array,
          * move through the array incrementing columns faster than rows 
          * and call the apply function on every element
          */
-        int i;
-        for (i = 0; i < (array->width * array->height); i++) {
-                int col = i % array->width;
-                int row = i / array->width;
-                
-                apply(col, row, array, UArray2_at(array, col, row), cl);
+        int col, row;
+        for (row = 0; row < array->height; row++) {
+                for (col = 0; col < array->width; col++) {
+                        apply(col, row, array, 
+                              UArray2_at(array, col, row), cl);
+                }
         }
 }
  
@@ -195,7 +226,11 @@ void UArray2_free(UArray2_T *array)
         assert(*array != NULL);
 
         /* free the memory associated with the UArray2 */
-        UArray_free(&((*array)->Uarray));
+        if ((*array)->mapped) {
+                Map_store_free((*array)->elems, (*array)->bytes);
+        } else {
+                free((*array)->elems);
+        }
         free(*array);
 
         (*array) = NULL;
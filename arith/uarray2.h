@@ -0,0 +1,65 @@
+/*
+ *      uarray2.h
+ *      by Eric Zhao
+ *      Project:    Arith
+ *
+ *      Summary:
+ *              This is the public interface of our 2 dimensional unboxed
+ *      array data structure: UArray2. It is the usual course interface, plus
+ *      UArray2_row, which gives a pointer to the first element of a row.
+ *      The elements of a row are contiguous, so a stage can walk a row with
+ *      a plain indexed loop instead of mapping an apply function over every
+ *      element, and the compiler is free to vectorize that loop.
+ *      UARRAY2_ROW gives the same pointer with the element type attached.
+ */
+
+#ifndef UARRAY2_INCLUDED
+#define UARRAY2_INCLUDED
+
+#define T UArray2_T
+typedef struct T *T;
+
+typedef void UArray2_applyfun(int i, int j, T array2, void *elem, void *cl);
+
+/*
+ * Description: These functions create and free a UArray2, and return its
+ *              width, height and element size
+ */
+extern T    UArray2_new(int width, int height, int size);
+extern void UArray2_free(T *array2);
+extern int  UArray2_width(T array2);
+extern int  UArray2_height(T array2);
+extern int  UArray2_size(T array2);
+
+/*
+ * Description: This function returns the location of the element at the
+ *              given column and row
+ */
+extern void *UArray2_at(T array2, int col, int row);
+
+/*
+ * Description: This function returns the location of the first element of
+ *              the given row. The width elements of the row follow it, each
+ *              size bytes after the one before
+ * Expected inputs: 
+ *       array2: an initialized UArray2 with at least one column
+ *       row: non-negative int for the row in the array
+ * Expected outputs: A pointer to the start of the row
+ */
+extern void *UArray2_row(T array2, int row);
+
+/* a pointer to row of array2, typed as a pointer to its elements */
+#define UARRAY2_ROW(type, array2, row) ((type *)UArray2_row((array2), (row)))
+
+/*
+ * Description: These functions call apply on every element of the UArray2,
+ *              incrementing columns faster than rows (row major) or rows
+ *              faster than columns (column major)
+ */
+extern void UArray2_map_row_major(T array2, UArray2_applyfun apply, 
+                                  void *cl);
+extern void UArray2_map_col_major(T array2, UArray2_applyfun apply, 
+                                  void *cl);
+
+#undef T
+#endif
@@ -0,0 +1,225 @@
+/*
+ *      uarray2b.c
+ *      by Eric Zhao
+ *      Project:    Arith
+ *
+ *      Summary:
+ *              This is the private implementation of our blocked 2
+ *      dimensional unboxed array data structure: UArray2b. The array is cut
+ *      into blocksize by blocksize blocks, and every block is stored as one
+ *      contiguous run of elements, row by row, in a single UArray. Blocks
+ *      are stored in row-major order of blocks, so the elements that are
+ *      close to each other in both directions are close in memory.
+ *      UArray2b_map visits the array one block at a time.
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+#include <uarray.h>
+#include "uarray2b.h"
+
+#define T UArray2b_T
+
+/* bytes in a block made by UArray2b_new_64K_block */
+#define BLOCK_BYTES (64 * 1024)
+
+/*
+ * width, height:  dimensions of the array, in elements
+ * blocksize:      number of elements on a side of a block
+ * blocks_wide:    number of blocks in a row of blocks
+ * blocks_high:    number of rows of blocks
+ * cells:          the elements, one block after the other
+ */
+struct T {
+        int width;
+        int height;
+        int blocksize;
+        int blocks_wide;
+        int blocks_high;
+        UArray_T cells;
+};
+
+/*
+ * Description: This function makes a new UArray2b based on the given width,
+ *              height, element size and blocksize
+ * Expected inputs:  
+ *       width: non-negative int for the array width
+ *       height: non-negative int for the array height
+ *       size: positive int for the bytes occupied by each element
+ *       blocksize: positive int for the number of elements on a side of a
+ *                  block
+ * Expected outputs: A new instance of the UArray2b struct
+ */
+T UArray2b_new(int width, int height, int size, int blocksize)
+{
+        /* test to make sure valid inputs given */
+        assert(width >= 0);
+        assert(height >= 0);
+        assert(size > 0);
+        assert(blocksize > 0);
+
+        T array2b = malloc(sizeof(*array2b));
+        assert(array2b != NULL);
+
+        /* partial blocks on the right and bottom edges are padded out to
+           whole blocks */
+        array2b->width = width;
+        array2b->height = height;
+        array2b->blocksize = blocksize;
+        array2b->blocks_wide = (width + blocksize - 1) / blocksize;
+        array2b->blocks_high = (height + blocksize - 1) / blocksize;
+
+        int cells = array2b->blocks_wide * array2b->blocks_high * 
+                    blocksize * blocksize;
+        array2b->cells = UArray_new(cells, size);
+
+        return array2b;
+}
+
+/*
+ * Description: This function makes a new UArray2b whose blocks are as
+ *              large as possible while still fitting in 64KB
+ * Expected inputs:  
+ *       width: non-negative int for the array width
+ *       height: non-negative int for the array height
+ *       size: positive int for the bytes occupied by each element
+ * Expected outputs: A new instance of the UArray2b struct; the blocksize is
+ *                   1 if a single element is larger than 64KB
+ */
+T UArray2b_new_64K_block(int width, int height, int size)
+{
+        assert(size > 0);
+
+        int blocksize = (int)sqrt((double)BLOCK_BYTES / size);
+        if (blocksize < 1) {
+                blocksize = 1;
+        }
+
+        return UArray2b_new(width, height, size, blocksize);
+}
+
+/*
+ * Description:      This function frees the memory associated with the given
+ *                   UArray2b
+ * Expected inputs:  
+ *      array2b: A pointer to an initialized UArray2b
+ * Expected outputs: Nothing
+ */
+void UArray2b_free(T *array2b)
+{
+        assert(array2b != NULL);
+        assert(*array2b != NULL);
+
+        UArray_free(&(*array2b)->cells);
+        free(*array2b);
+
+        *array2b = NULL;
+}
+
+/*
+ * Description: These functions return the width, height, element size and
+ *              blocksize of the given UArray2b
+ * Expected inputs:
+ *       array2b: an initialized UArray2b
+ * Expected outputs: The requested non-negative int
+ */
+int UArray2b_width(T array2b)
+{
+        assert(array2b != NULL);
+        return array2b->width;
+}
+
+int UArray2b_height(T array2b)
+{
+        assert(array2b != NULL);
+        return array2b->height;
+}
+
+int UArray2b_size(T array2b)
+{
+        assert(array2b != NULL);
+        return UArray_size(array2b->cells);
+}
+
+int UArray2b_blocksize(T array2b)
+{
+        assert(array2b != NULL);
+        return array2b->blocksize;
+}
+
+/*
+ * Description: This function returns the location of an element at the
+ *              given column and row
+ * Expected inputs: 
+ *       array2b: an initialized UArray2b
+ *       col: non-negative int for the column in the array
+ *       row: non-negative int for the row in the array
+ * Expected outputs: A pointer to the corresponding location in the UArray2b
+ */
+void *UArray2b_at(T array2b, int col, int row)
+{
+        assert(array2b != NULL);
+        assert(col < array2b->width && col >= 0);
+        assert(row < array2b->height && row >= 0);
+
+        int blocksize = array2b->blocksize;
+        int block = (row / blocksize) * array2b->blocks_wide + 
+                    col / blocksize;
+        int cell = (row % blocksize) * blocksize + col % blocksize;
+
+        return UArray_at(array2b->cells, block * blocksize * blocksize + cell);
+}
+
+/*
+ * Description: This function calls a given function on every element of 
+ *              the UArray2b, one block at a time. Blocks are visited in
+ *              row-major order, and so are the elements within a block;
+ *              the padding of partial blocks is skipped
+ * Expected inputs:
+ *       array2b: an initialized UArray2b
+ *       apply: a void function pointer to the function apply, which takes in
+ *               col: non-negative int for the column in the array
+ *               row: non-negative int for the row in the array
+ *               array2b: an initialized UArray2b
+ *               elem: a void pointer to the corresponding location
+ *               cl: a void pointer to pass in values
+ *       cl: a void pointer to pass in values
+ * Expected outputs: Nothing from the function itself. Outputs depend on
+ *                   void function that is passed in
+ */
+void UArray2b_map(T array2b,
+                  void apply(int col, int row, T array2b, void *elem, 
+                             void *cl),
+                  void *cl)
+{
+        assert(array2b != NULL);
+        assert(apply != NULL);
+
+        int blocksize = array2b->blocksize;
+        int cell = 0;
+
+        /* cells are visited in storage order, so the index of each cell
+           only ever counts up */
+        int block_row, block_col, i, j;
+        for (block_row = 0; block_row < array2b->blocks_high; block_row++) {
+                for (block_col = 0; block_col < array2b->blocks_wide; 
+                     block_col++) {
+                        int row0 = block_row * blocksize;
+                        int col0 = block_col * blocksize;
+                        for (j = 0; j < blocksize; j++) {
+                                for (i = 0; i < blocksize; i++, cell++) {
+                                        int col = col0 + i;
+                                        int row = row0 + j;
+                                        if (col >= array2b->width || 
+                                            row >= array2b->height) {
+                                                continue;
+                                        }
+                                        apply(col, row, array2b,
+                                              UArray_at(array2b->cells, cell),
+                                              cl);
+                                }
+                        }
+                }
+        }
+}
@@ -11,14 +11,25 @@
  *      of any type of data that the client chooses to supply.
  */
 
-#include <uarray.h>
+#include <stddef.h>
+#include <stdbool.h>
 #ifndef UARRAY2REP_INCLUDED
 #define UARRAY2REP_INCLUDED
 
+/*
+ * width, height: dimensions of the array
+ * size:          bytes occupied by each element
+ * elems:         the elements, row after row
+ * bytes:         the size of elems
+ * mapped:        whether elems was mapped by Map_store rather than allocated
+ */
 struct UArray2_T {
         int width;
         int height;
-        UArray_T Uarray;
+        int size;
+        char *elems;
+        size_t bytes;
+        bool mapped;
 };
 
 #endif
\ No newline at end of file